@@ -8,7 +8,9 @@
  * The function has no effect if the edge is already in the candidate
  * set.
  *
- * If the edge was added, the function returns 1; otherwise 0.
+ * If the edge was added, the function returns 1; otherwise 0. An added
+ * edge is also entered in the hash table of candidate edges (see
+ * IndexCandidate).
  *    
  * The function is called from the functions CreateDelaunaySet and
  * OrderCandidateSet.
@@ -28,7 +30,7 @@ int AddCandidate(Node * From, Node * To, int Cost, int Alpha)
         !IsPossibleCandidate(From, To))
         return 0;
     Count = 0;
-    for (NFrom = From->CandidateSet; NFrom->To && NFrom->To != To; NFrom++)
+    for (NFrom = From->CandidateSet; NFrom->To && NFrom->To != To->Id; NFrom++)
         Count++;
     if (NFrom->To) {
         if (NFrom->Alpha == INT_MAX)
@@ -37,10 +39,10 @@ int AddCandidate(Node * From, Node * To, int Cost, int Alpha)
     }
     NFrom->Cost = Cost;
     NFrom->Alpha = Alpha;
-    NFrom->To = To;
-    assert(From->CandidateSet =
-           (Candidate *) realloc(From->CandidateSet,
-                                 (Count + 2) * sizeof(Candidate)));
+    NFrom->To = To->Id;
+    From->CandidateSet =
+        ResizeCandidateSet(From->CandidateSet, Count + 1, Count + 2);
     From->CandidateSet[Count + 1].To = 0;
+    IndexCandidate(From, Count);
     return 1;
 }
@@ -34,9 +34,9 @@ void AddExtraCandidates(int K, int CandidateSetType, int Symmetric)
         ExtraCandidateSet = t->CandidateSet;
         t->CandidateSet = SavedCandidateSet[t->Id];
         for (Nt = ExtraCandidateSet; Nt && Nt->To; Nt++) {
-            AddCandidate(t, Nt->To, Nt->Cost, Nt->Alpha);
+            AddCandidate(t, CandidateNode(Nt), Nt->Cost, Nt->Alpha);
             if (Symmetric)
-                AddCandidate(Nt->To, t, Nt->Cost, Nt->Alpha);
+                AddCandidate(CandidateNode(Nt), t, Nt->Cost, Nt->Alpha);
         }
         free(ExtraCandidateSet);
     } while ((t = t->Suc) != FirstNode);
@@ -26,7 +26,7 @@ void AddTourCandidates()
     for (i = 0; i < MergeTourFiles; i++) {
         Na = FirstNode;
         do {
-            Nb = Na->MergeSuc[i];
+            Nb = Cold(Na)->MergeSuc[i];
             if (!Nb)
                 break;
             if (Na->Subproblem == Subproblem &&
@@ -42,7 +42,7 @@ void AddTourCandidates()
     /* Add INITIAL_TOUR_FILE edges */
     Na = FirstNode;
     do {
-        Nb = Na->InitialSuc;
+        Nb = Cold(Na)->InitialSuc;
         if (!Nb)
             break;
         if (Na->Subproblem == Subproblem && Nb->Subproblem == Subproblem) {
@@ -56,7 +56,7 @@ void AddTourCandidates()
     /* Add INPUT_TOUR_FILE edges */
     Na = FirstNode;
     do {
-        Nb = Na->InputSuc;
+        Nb = Cold(Na)->InputSuc;
         if (!Nb)
             break;
         if (Na->Subproblem == Subproblem && Nb->Subproblem == Subproblem) {
@@ -70,7 +70,7 @@ void AddTourCandidates()
     /* Add SUBPROBLEM_TOUR_FILE edges */
     Na = FirstNode;
     do {
-        Nb = Na->SubproblemSuc;
+        Nb = Cold(Na)->SubproblemSuc;
         if (!Nb)
             break;
         if (Na->Subproblem == Subproblem && Nb->Subproblem == Subproblem) {
@@ -15,12 +15,16 @@
  * dummy edge). The Alpha field of the new candidate edge is set to 
  * INT_MAX. Edges that belong to the best tour as well as the next best 
  * tour are moved to the start of the table.                         
+ *
+ * The hash table of candidate edges, CandidateIndex, is kept up to date
+ * (see IndexCandidateSets).
  */
 
 void AdjustCandidateSet()
 {
     Candidate *NFrom, *NN, Temp;
     Node *From = FirstNode, *To;
+    int Moved;
 
     /* Extend and reorder candidate sets */
     do {
@@ -33,31 +37,37 @@ void AdjustCandidateSet()
             if ((ProblemType == HCP || ProblemType == HPP) &&
                 !IsBackboneCandidate(From, To))
                 continue;
-            for (NFrom = From->CandidateSet; NFrom->To && NFrom->To != To;
+            for (NFrom = From->CandidateSet; NFrom->To && NFrom->To != To->Id;
                 NFrom++)
                 Count++;
             if (!NFrom->To) {
                 /* Add new candidate edge */
                 NFrom->Cost = C(From, To);
-                NFrom->To = To;
+                NFrom->To = To->Id;
                 NFrom->Alpha = INT_MAX;
-                assert(From->CandidateSet =
-                       (Candidate *) realloc(From->CandidateSet,
-                                             (Count +
-                                              2) * sizeof(Candidate)));
+                From->CandidateSet =
+                    ResizeCandidateSet(From->CandidateSet, Count + 1,
+                                       Count + 2);
                 From->CandidateSet[Count + 1].To = 0;
+                IndexCandidate(From, Count);
             }
         }
         /* Reorder */
-        for (NFrom = From->CandidateSet + 1; (To = NFrom->To); NFrom++)
+        Moved = 0;
+        for (NFrom = From->CandidateSet + 1;
+             (To = CandidateNode(NFrom)); NFrom++)
             if (InBestTour(From, To) &&
                 (InNextBestTour(From, To) || InInitialTour(From, To))) {
                 /* Move the edge to the start of the candidate table */
+                if (!Moved++)
+                    UnindexCandidates(From);
                 Temp = *NFrom;
                 for (NN = NFrom - 1; NN >= From->CandidateSet; NN--)
                     *(NN + 1) = *NN;
                 *(NN + 1) = Temp;
             }
+        if (Moved)
+            IndexCandidates(From);
     }
     while ((From = From->Suc) != FirstNode);
 }
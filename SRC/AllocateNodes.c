@@ -0,0 +1,31 @@
+#include "LKH.h"
+#include <stddef.h>
+
+/*
+ * The AllocateNodes function allocates an array of Count nodes, all of
+ * whose fields are zero.
+ *
+ * The array is aligned to a cache line boundary (CacheLineSize). Since
+ * the size of a Node is a multiple of CacheLineSize, the fields placed
+ * first in the Node structure (those used in the inner loops of the
+ * Lin-Kernighan search) occupy the first two cache lines of every node.
+ * The layout is checked at compile time below: a typedef of an array
+ * with negative size is an error.
+ *
+ * The array may be freed by free.
+ */
+
+typedef char HotFieldsFitInTwoCacheLines
+    [offsetof(Node, SucCost) + sizeof(int) <= 2 * CacheLineSize ? 1 : -1];
+typedef char NodeFitsInFourCacheLines
+    [sizeof(Node) <= 4 * CacheLineSize ? 1 : -1];
+
+Node *AllocateNodes(int Count)
+{
+    void *Nodes;
+
+    assert(posix_memalign(&Nodes, CacheLineSize, Count * sizeof(Node))
+           == 0);
+    memset(Nodes, 0, Count * sizeof(Node));
+    return (Node *) Nodes;
+}
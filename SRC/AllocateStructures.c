@@ -20,8 +20,7 @@ void AllocateStructures()
     Free(BetterTour);
     Free(HTable);
     Free(Rand);
-    Free(CacheSig);
-    Free(CacheVal);
+    Free(Cache);
     Free(T);
     Free(G);
     Free(t);
@@ -45,12 +44,13 @@ void AllocateStructures()
     for (i = 1; i <= Dimension; i++)
         Rand[i] = Random();
     SRandom(Seed); // 使用Seed再次初始化Random序列
-    if (WeightType != EXPLICIT) {
-        for (i = 0; (1 << i) < (Dimension << 1); i++); // 通过左移的指数递增，找到第一个比2 * Dimension 大的2的幂数的位移位数作为值
-        i = 1 << i; // i 值设置为上部for循环中生成的2的幂数
-        assert(CacheSig = (int *) calloc(i, sizeof(int))); // WeightType非Explicit则意味着要在算法运行的过程中计算，所以使用Cache缓存距离以免重复计算
-        assert(CacheVal = (int *) calloc(i, sizeof(int))); // 这里为何用最小的大于Dimension * 2的2的幂数作为缓存的大小？？？
-        CacheMask = i - 1;
+    if (WeightType != EXPLICIT && DistanceCacheSize != 0) {
+        /* The number of entries is rounded up to a power of two
+           (default: the smallest power of two >= 2 * Dimension) */
+        K = DistanceCacheSize > 0 ? DistanceCacheSize : Dimension << 1;
+        for (i = CacheWays; i < K && i <= INT_MAX / 4; i <<= 1);
+        assert(Cache = (CacheEntry *) calloc(i, sizeof(CacheEntry)));
+        CacheMask = i / CacheWays - 1;
     }
     AllocateSegments();
     // K 表示 k-opt中，k要>=2
@@ -72,6 +72,14 @@ void AllocateStructures()
 
 /*      
  * The AllocateSegments function allocates the segments of the two-level tree.
+ *
+ * The function also chooses the tour representation for the current
+ * problem or subproblem, CurrentTreeType, and lets SpecializeFunctions
+ * select the variants of the Lin-Kernighan functions for it. Unless
+ * specified by TREE_TYPE, the linked list is used for less than 400 nodes,
+ * where it is faster than the two-level tree, and the three-level tree is
+ * used for more than a million nodes. For the linked list, the function
+ * also allocates the array TourOrder (see Flip).
  */
 
 void AllocateSegments()
@@ -81,13 +89,19 @@ void AllocateSegments()
     int i;
 
     FreeSegments();
-#ifdef THREE_LEVEL_TREE
-    GroupSize = (int) pow((double) Dimension, 1.0 / 3.0); // 当segment的数据结构是三层数或者是双向链表时，GroupSize都不同
-#elif defined TWO_LEVEL_TREE // 在Segment.h中默认定义了两层数，所以程序中默认使用该数据结构
-    GroupSize = (int) sqrt((double) Dimension); // 每个segment的初始大小为根号Dimension，可以参考Two-level-tree的论文
-#else
-    GroupSize = Dimension;
-#endif
+    CurrentTreeType = TreeType != -1 ? TreeType :
+        Dimension < 400 ? ONE_LEVEL :
+        Dimension <= 1000000 ? TWO_LEVEL : THREE_LEVEL;
+    SpecializeFunctions();
+    if (CurrentTreeType == ONE_LEVEL)
+        assert(TourOrder =
+               (Node **) malloc((Dimension + 1) * sizeof(Node *)));
+    if (CurrentTreeType == THREE_LEVEL)
+        GroupSize = (int) pow((double) Dimension, 1.0 / 3.0); // 当segment的数据结构是三层数或者是双向链表时，GroupSize都不同
+    else if (CurrentTreeType == TWO_LEVEL)
+        GroupSize = (int) sqrt((double) Dimension); // 每个segment的初始大小为根号Dimension，可以参考Two-level-tree的论文
+    else
+        GroupSize = Dimension;
     Groups = 0; // 当前segments的个数
     for (i = Dimension, SPrev = 0; i > 0; i -= GroupSize, SPrev = S) {
         assert(S = (Segment *) malloc(sizeof(Segment)));
@@ -98,11 +112,8 @@ void AllocateSegments()
             SLink(SPrev, S);
     }
     SLink(S, FirstSegment); // 最后首尾相连
-#ifdef THREE_LEVEL_TREE
-    SGroupSize = sqrt((double) Groups);
-#else
-    SGroupSize = Dimension;
-#endif
+    SGroupSize = CurrentTreeType == THREE_LEVEL ?
+        sqrt((double) Groups) : Dimension;
     SGroups = 0; // 父segments的个数,如上同理构建第二层树的父层
     for (i = Groups, SSPrev = 0; i > 0; i -= SGroupSize, SSPrev = SS) {
         SS = (SSegment *) malloc(sizeof(SSegment));
@@ -31,8 +31,8 @@ GainType Ascent()
     do
         t->Pi = t->BestPi = 0;
     while ((t = t->Suc) != FirstNode);
-    if (CandidateSetType == DELAUNAY)
-        CreateDelaunayCandidateSet();
+    if (CandidateSetType == DELAUNAY || AlphaSupergraph)
+        CreateSupergraphCandidateSet();
     else if (MaxCandidates == 0)
         AddTourCandidates(); // 若MaxCandidates指定的候选集数量为0，则通过事先给定的TourFile，将候选集加入
 
@@ -40,7 +40,7 @@ GainType Ascent()
     // 计算Minimum1TreeCost时会先求最小生成树，此时pi值为0，w为未进行次梯度优化的初始cost
     // 参数意义为是否是稀疏图
     W = Minimum1TreeCost(CandidateSetType == DELAUNAY
-                         || MaxCandidates == 0);
+                         || AlphaSupergraph || MaxCandidates == 0);
 
     /* Return this cost 
        if either
@@ -55,7 +55,7 @@ GainType Ascent()
         MaxAlpha = Alpha;
     if (MaxCandidates > 0) {
         /* Generate symmetric candididate sets for all nodes */
-        if (CandidateSetType != DELAUNAY)
+        if (CandidateSetType != DELAUNAY && !AlphaSupergraph)
             GenerateCandidates(AscentCandidates, MaxAlpha, 1);
         else { // 若等于DELAUNAY这种candidate类型，则需要额外在进行一次Minimum1Tree的生成
             OrderCandidateSet(AscentCandidates, MaxAlpha, 1);
@@ -114,7 +114,7 @@ GainType Ascent()
                 if (W - W0 > (W0 >= 0 ? W0 : -W0) && AscentCandidates > 0
                     && AscentCandidates < Dimension) {
                     W = Minimum1TreeCost(CandidateSetType == DELAUNAY
-                                         || MaxCandidates == 0);
+                                         || AlphaSupergraph || MaxCandidates == 0);
                     if (W < W0) {
                         /* Double the number of candidate edges 
                            and start all over again */
@@ -169,18 +169,18 @@ GainType Ascent()
 
     /* Compute a minimum 1-tree */
     W = BestW = Minimum1TreeCost(CandidateSetType == DELAUNAY
-                                 || MaxCandidates == 0);
+                                 || AlphaSupergraph || MaxCandidates == 0);
 
     if (MaxCandidates > 0) {
         FreeCandidateSets();
-        if (CandidateSetType == DELAUNAY)
-            CreateDelaunayCandidateSet();
+        if (CandidateSetType == DELAUNAY || AlphaSupergraph)
+            CreateSupergraphCandidateSet();
     } else {
         Candidate *Nt;
         t = FirstNode;
         do {
             for (Nt = t->CandidateSet; Nt && Nt->To; Nt++)
-                Nt->Cost += t->Pi + Nt->To->Pi;
+                Nt->Cost += t->Pi + NodeSet[Nt->To].Pi;
         }
         while ((t = t->Suc) != FirstNode);
     }
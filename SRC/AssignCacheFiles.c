@@ -0,0 +1,102 @@
+#include "LKH.h"
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/*
+ * The AssignCacheFiles function lets the penalties and the candidate sets
+ * of a problem be cached in the directory CacheDirectory (CACHE_DIRECTORY).
+ *
+ * The function computes a fingerprint of the problem and sets PiFileName
+ * and CandidateFileName[0] to <CacheDirectory>/<fingerprint>.pi.bin
+ * and <CacheDirectory>/<fingerprint>.cand.bin (binary files; see
+ * WritePenalties and WriteCandidates). The files are then treated as a
+ * PI_FILE and a CANDIDATE_FILE: if they exist, they are read by
+ * ReadPenalties and ReadCandidates, and the ascent is skipped; otherwise
+ * they are written by WritePenalties and WriteCandidates.
+ *
+ * The fingerprint is a 64-bit FNV-1a hash of the contents of the problem
+ * file, the contents of the tour files that contribute candidate edges
+ * (INPUT_TOUR_FILE and MERGE_TOUR_FILEs), and the values of the parameters
+ * that affect the penalties or the candidate sets.
+ *
+ * Nothing is done if no CACHE_DIRECTORY is given, if a PI_FILE or a
+ * CANDIDATE_FILE is given, or if the problem is solved by partitioning
+ * (SUBPROBLEM_SIZE > 0).
+ *
+ * The function is called from the CreateCandidateSet function.
+ */
+
+typedef unsigned long long HashType;
+
+#define CacheVersion 2  /* To be incremented if the cached results change */
+
+static HashType HashBytes(HashType Hash, const void *Bytes, size_t Count);
+static HashType HashFile(HashType Hash, const char *FileName);
+
+#define HashValue(Hash, Value) HashBytes(Hash, &(Value), sizeof(Value))
+
+void AssignCacheFiles()
+{
+    HashType Hash = 14695981039346656037ULL;
+    int i, Version = CacheVersion;
+    size_t Length;
+
+    if (CacheDirectory == 0 || PiFileName != 0 || CandidateFiles > 0 ||
+        SubproblemSize > 0)
+        return;
+    Hash = HashValue(Hash, Version);
+    Hash = HashFile(Hash, ProblemFileName);
+    if (InputTourFileName)
+        Hash = HashFile(Hash, InputTourFileName);
+    for (i = 0; i < MergeTourFiles; i++)
+        Hash = HashFile(Hash, MergeTourFileName[i]);
+    Hash = HashValue(Hash, Precision);
+    Hash = HashValue(Hash, AscentCandidates);
+    Hash = HashValue(Hash, InitialPeriod);
+    Hash = HashValue(Hash, InitialStepSize);
+    Hash = HashValue(Hash, Subgradient);
+    Hash = HashValue(Hash, MaxCandidates);
+    Hash = HashValue(Hash, CandidateSetType);
+    Hash = HashValue(Hash, CandidateSetSymmetric);
+    Hash = HashValue(Hash, DelaunayPure);
+    Hash = HashValue(Hash, AlphaSupergraph);
+    Hash = HashValue(Hash, AlphaSupergraphHops);
+    Hash = HashValue(Hash, ExtraCandidates);
+    Hash = HashValue(Hash, ExtraCandidateSetType);
+    Hash = HashValue(Hash, ExtraCandidateSetSymmetric);
+    Hash = HashValue(Hash, Excess);
+    Hash = HashValue(Hash, Optimum);
+
+    mkdir(CacheDirectory, 0777);
+    Length = strlen(CacheDirectory) + 32;
+    assert(PiFileName = (char *) malloc(Length));
+    sprintf(PiFileName, "%s/%016llx.pi.bin", CacheDirectory, Hash);
+    assert(CandidateFileName = (char **) malloc(sizeof(char *)));
+    assert(CandidateFileName[0] = (char *) malloc(Length));
+    sprintf(CandidateFileName[0], "%s/%016llx.cand.bin", CacheDirectory,
+            Hash);
+    CandidateFiles = 1;
+}
+
+static HashType HashBytes(HashType Hash, const void *Bytes, size_t Count)
+{
+    const unsigned char *b = (const unsigned char *) Bytes;
+
+    while (Count-- > 0)
+        Hash = (Hash ^ *b++) * 1099511628211ULL;
+    return Hash;
+}
+
+static HashType HashFile(HashType Hash, const char *FileName)
+{
+    FILE *File;
+    unsigned char Buffer[1 << 16];
+    size_t Count;
+
+    if (!(File = fopen(FileName, "rb")))
+        eprintf("Cannot open \"%s\"", FileName);
+    while ((Count = fread(Buffer, 1, sizeof(Buffer), File)) > 0)
+        Hash = HashBytes(Hash, Buffer, Count);
+    fclose(File);
+    return Hash;
+}
@@ -55,7 +55,7 @@ Node *Best3OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain)
      */
 
     /* Choose (t2,t3) as a candidate edge emanating from t2 */
-    for (Nt2 = t2->CandidateSet; (t3 = Nt2->To); Nt2++) {
+    for (Nt2 = t2->CandidateSet; (t3 = CandidateNode(Nt2)); Nt2++) {
         if (t3 == t2->Pred || t3 == t2->Suc ||
             ((G1 = *G0 - Nt2->Cost) <= 0 && GainCriterionUsed &&
              ProblemType != HCP && ProblemType != HPP))
@@ -79,7 +79,7 @@ Node *Best3OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain)
                 continue;
             Breadth4 = 0;
             /* Choose (t4,t5) as a candidate edge emanating from t4 */
-            for (Nt4 = t4->CandidateSet; (t5 = Nt4->To); Nt4++) {
+            for (Nt4 = t4->CandidateSet; (t5 = CandidateNode(Nt4)); Nt4++) {
                 if (t5 == t4->Pred || t5 == t4->Suc ||
                     ((G3 = G2 - Nt4->Cost) <= 0 && GainCriterionUsed &&
                      ProblemType != HCP && ProblemType != HPP) ||
@@ -64,7 +64,7 @@ Node *Best5OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain)
      */
 
     /* Choose (t2,t3) as a candidate edge emanating from t2 */
-    for (Nt2 = t2->CandidateSet; (t3 = Nt2->To); Nt2++) {
+    for (Nt2 = t2->CandidateSet; (t3 = CandidateNode(Nt2)); Nt2++) {
         if (t3 == t2->Pred || t3 == t2->Suc ||
             ((G1 = *G0 - Nt2->Cost) <= 0 && GainCriterionUsed &&
              ProblemType != HCP && ProblemType != HPP))
@@ -88,7 +88,7 @@ Node *Best5OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain)
                 continue;
             Breadth4 = 0;
             /* Choose (t4,t5) as a candidate edge emanating from t4 */
-            for (Nt4 = t4->CandidateSet; (t5 = Nt4->To); Nt4++) {
+            for (Nt4 = t4->CandidateSet; (t5 = CandidateNode(Nt4)); Nt4++) {
                 if (t5 == t4->Pred || t5 == t4->Suc ||
                     ((G3 = G2 - Nt4->Cost) <= 0 && GainCriterionUsed &&
                      ProblemType != HCP && ProblemType != HPP))
@@ -133,7 +133,8 @@ Node *Best5OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain)
                         continue;
                     Breadth6 = 0;
                     /* Choose (t6,t7) as a candidate edge emanating from t6 */
-                    for (Nt6 = t6->CandidateSet; (t7 = Nt6->To); Nt6++) {
+                    for (Nt6 = t6->CandidateSet;
+                         (t7 = CandidateNode(Nt6)); Nt6++) {
                         if (t7 == t6->Pred || t7 == t6->Suc ||
                             (t6 == t2 && t7 == t3) ||
                             (t6 == t3 && t7 == t2) ||
@@ -236,8 +237,8 @@ Node *Best5OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain)
                             Breadth8 = 0;
                             /* Choose (t8,t9) as a candidate edge emanating 
                                from t8 */
-                            for (Nt8 = t8->CandidateSet; (t9 = Nt8->To);
-                                 Nt8++) {
+                            for (Nt8 = t8->CandidateSet;
+                                 (t9 = CandidateNode(Nt8)); Nt8++) {
                                 if (t9 == t8->Pred || t9 == t8->Suc
                                     || t9 == t1 || (t8 == t2 && t9 == t3)
                                     || (t8 == t3 && t9 == t2) || (t8 == t4
@@ -24,7 +24,7 @@
  * The function is called from the LinKernighan function. 
  */
 
-static GainType BestG2;
+static THREAD_LOCAL GainType BestG2;
 
 static GainType BestKOptMoveRec(int k, GainType G0);
 
@@ -83,7 +83,7 @@ static GainType BestKOptMoveRec(int k, GainType G0)
     incl[incl[i] = i + 1] = i;
     incl[incl[1] = i + 2] = 1;
     /* Choose (t2,t3) as a candidate edge emanating from t2 */
-    for (Nt2 = t2->CandidateSet; (t3 = Nt2->To); Nt2++) {
+    for (Nt2 = t2->CandidateSet; (t3 = CandidateNode(Nt2)); Nt2++) {
         if (t3 == t2->Pred || t3 == t2->Suc ||
             ((G1 = G0 - Nt2->Cost) <= 0 && GainCriterionUsed &&
              ProblemType != HCP && ProblemType != HPP)
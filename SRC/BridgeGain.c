@@ -88,7 +88,7 @@ BridgeGain(Node * s1, Node * s2, Node * s3, Node * s4,
         /* Choose (t2,t3) as a candidate edge emanating from t2. 
            t3 must not be between u2 and u3 */
         Breadth2 = 0;
-        for (Nt2 = t2->CandidateSet; (t3 = Nt2->To); Nt2++) {
+        for (Nt2 = t2->CandidateSet; (t3 = CandidateNode(Nt2)); Nt2++) {
             if (t3 == t2->Pred || t3 == t2->Suc || BETWEEN(u2, t3, u3))
                 continue;
             G1 = G0 - Nt2->Cost;
@@ -157,7 +157,8 @@ BridgeGain(Node * s1, Node * s2, Node * s3, Node * s4,
                     continue;
                 Breadth4 = 0;
                 /* Choose (t4,t5) as a candidate edge emanating from t4 */
-                for (Nt4 = t4->CandidateSet; (t5 = Nt4->To); Nt4++) {
+                for (Nt4 = t4->CandidateSet;
+                     (t5 = CandidateNode(Nt4)); Nt4++) {
                     if (t5 == t4->Pred || t5 == t4->Suc || t5 == t1
                         || t5 == t2)
                         continue;
@@ -186,7 +187,8 @@ BridgeGain(Node * s1, Node * s2, Node * s3, Node * s4,
                     Breadth6 = 0;
                     /* Choose (t7,t8) as a candidate edge emanating from t7.
                        Only one choice! */
-                    for (Nt6 = t6->CandidateSet; (t7 = Nt6->To); Nt6++) {
+                    for (Nt6 = t6->CandidateSet;
+                         (t7 = CandidateNode(Nt6)); Nt6++) {
                         if (t7 == t6->Pred || t7 == t6->Suc)
                             continue;
                         /* Choose t8 as one of t7's two neighbors on the tour.
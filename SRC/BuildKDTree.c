@@ -5,13 +5,15 @@ static void Partition(int start, int end, int k, int axis);
 static char FindMaxSpread(int start, int end);
 static void Swap(int i, int j);
 
-static Node **KDTree;
-static int cutoff;
+static THREAD_LOCAL Node **KDTree;
+static THREAD_LOCAL int cutoff;
 
-#define Coord(N, axis) (axis == 0 ? (N)->X : axis == 1 ? (N)->Y : (N)->Z)
+#define Coord(N, axis)\
+    ((axis == 0 ? XCoord : axis == 1 ? YCoord : ZCoord)[(N)->Id])
 
 /*
  * The BuildKDTree function builds a balanced K-d tree of all nodes.
+ * The coordinates are read from the arrays XCoord, YCoord and ZCoord.
  *
  * See
  *    Jon Louis Bentley: K-d Trees for Semidynamic Point Sets. 
@@ -109,9 +111,9 @@ static char FindMaxSpread(int start, int end)
     double Min[3], Max[3];
 
     N = KDTree[start];
-    Min[0] = Max[0] = N->X;
-    Min[1] = Max[1] = N->Y;
-    Min[2] = Max[2] = N->Z;
+    Min[0] = Max[0] = XCoord[N->Id];
+    Min[1] = Max[1] = YCoord[N->Id];
+    Min[2] = Max[2] = ZCoord[N->Id];
     for (i = start + 1; i <= end; i++) {
         for (axis = CoordType == THREED_COORDS ? 2 : 1; axis >= 0; axis--) {
             N = KDTree[i];
@@ -20,19 +20,32 @@ int C_EXPLICIT(Node * Na, Node * Nb)
  *
  *  (1) If (Na,Nb) is an edge on the current tour, then its distance 
  *      is available in either the field PredCost or SucCost.
+ *
+ *  (2) If the problem is given as a graph (by an EDGE_DATA_SECTION), the
+ *      cost of an edge of the graph is the cost of its candidate edge
+ *      (see LookupCandidate). These costs are not given by the distance
+ *      function, Distance_1.
  *	   
- *  (2) A hash table (CacheVal) is consulted to see if the distance has
- *      been stored. 
+ *  (3) A set-associative cache (Cache) is consulted to see if the
+ *      distance has been stored. The edge is mapped to one of the
+ *      CacheMask + 1 sets of the cache by hashing the Ids of its end
+ *      nodes. Each set holds CacheWays edges, ordered from most to
+ *      least recently used.
  *	    
- *  (3) Otherwise the distance function is called and the distance computed
- *      is stored in the hash table.	    	      
+ *  (4) Otherwise the distance function is called and the distance computed
+ *      is stored in the cache, replacing the least recently used edge of
+ *      its set.
+ *
+ * The numbers of cache hits, misses and evictions (replacements of a used
+ * entry) are counted in CacheHits, CacheMisses and CacheEvictions.
  */
 
 int C_FUNCTION(Node * Na, Node * Nb)
 {
-    Node *Nc;
+    CacheEntry *Set, E;
     Candidate *Cand;
-    int Index, i, j;
+    unsigned h;
+    int i, j, w;
 
     if (PredSucCostAvailable) {
         if (Na->Suc == Nb)
@@ -40,15 +53,11 @@ int C_FUNCTION(Node * Na, Node * Nb)
         if (Na->Pred == Nb)
             return Na->PredCost;
     }
-    if ((Cand = Na->CandidateSet))
-        for (; (Nc = Cand->To); Cand++)
-            if (Nc == Nb)
-                return Cand->Cost;
-    if ((Cand = Na->BackboneCandidateSet))
-        for (; (Nc = Cand->To); Cand++)
-            if (Nc == Nb)
-                return Cand->Cost;
-    if (CacheSig == 0)
+    if (Distance == Distance_1 &&
+        ((Cand = LookupCandidate(Na, Nb)) ||
+         (Cand = LookupBackboneCandidate(Na, Nb))))
+        return Cand->Cost;
+    if (Cache == 0)
         return D(Na, Nb);
     i = Na->Id;
     j = Nb->Id;
@@ -57,11 +66,27 @@ int C_FUNCTION(Node * Na, Node * Nb)
         i = j;
         j = k;
     }
-    Index = ((i << 8) + i + j) & CacheMask;
-    if (CacheSig[Index] == i)
-        return CacheVal[Index];
-    CacheSig[Index] = i;
-    return (CacheVal[Index] = D(Na, Nb));
+    h = (unsigned) i * 0x9E3779B1U + (unsigned) j;
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    Set = Cache + (h & CacheMask) * CacheWays;
+    for (w = 0; w < CacheWays; w++) {
+        if (Set[w].Id1 == i && Set[w].Id2 == j) {
+            CacheHits++;
+            for (E = Set[w]; w > 0; w--)
+                Set[w] = Set[w - 1];
+            return (Set[0] = E).Cost;
+        }
+    }
+    CacheMisses++;
+    if (Set[CacheWays - 1].Id1)
+        CacheEvictions++;
+    for (w = CacheWays - 1; w > 0; w--)
+        Set[w] = Set[w - 1];
+    Set[0].Id1 = i;
+    Set[0].Id2 = j;
+    return (Set[0].Cost = D(Na, Nb));
 }
 
 int D_EXPLICIT(Node * Na, Node * Nb)
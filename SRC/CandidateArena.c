@@ -0,0 +1,135 @@
+#include "LKH.h"
+
+/*
+ * The candidate sets of the nodes are normally stored in one contiguous
+ * block of memory, CandidateArena, in the order of the nodes in the list
+ * FirstNode, FirstNode->Suc, ... Each node's CandidateSet points to its
+ * part of the block (its candidate edges followed by an entry with To
+ * equal to zero). This layout (a compressed-row representation of the
+ * candidate graph) avoids an allocation per node and lets the move
+ * functions traverse the candidate sets of neighboring nodes in nearby
+ * memory.
+ *
+ * A candidate set that is extended or trimmed after the block has been
+ * built is moved out of the block into memory of its own (see
+ * ResizeCandidateSet). The block is rebuilt by PackCandidateSets.
+ */
+
+static int InArena(const Candidate * Set);
+static long SetSize(const Candidate * Set);
+
+/*
+ * The AllocateCandidateSets function gives each node an empty candidate
+ * set with room for Size entries (including the terminating entry).
+ * The candidate sets are allocated in a single block. Any previous
+ * candidate sets must have been freed (by FreeCandidateSets).
+ */
+
+void AllocateCandidateSets(int Size)
+{
+    Node *N = FirstNode;
+    long Count = 0;
+
+    do
+        Count++;
+    while ((N = N->Suc) != FirstNode);
+    assert(CandidateArena =
+           (Candidate *) malloc(Count * Size * sizeof(Candidate)));
+    CandidateArenaSize = Count * Size;
+    Count = 0;
+    do {
+        N->CandidateSet = CandidateArena + Count;
+        N->CandidateSet[0].To = 0;
+        Count += Size;
+    } while ((N = N->Suc) != FirstNode);
+}
+
+/*
+ * The PackCandidateSets function moves the candidate sets (and backbone
+ * candidate sets) of all nodes into a new block of memory, where they
+ * occupy no more space than needed. The memory of the previous sets is
+ * freed.
+ */
+
+void PackCandidateSets()
+{
+    Node *N = FirstNode;
+    Candidate *Arena, *Next;
+    long Count = 0;
+
+    if (!N)
+        return;
+    do
+        Count += SetSize(N->CandidateSet) +
+            SetSize(N->BackboneCandidateSet);
+    while ((N = N->Suc) != FirstNode);
+    if (Count == 0)
+        return;
+    assert(Arena = (Candidate *) malloc(Count * sizeof(Candidate)));
+    Next = Arena;
+    do {
+        if ((Count = SetSize(N->CandidateSet)) > 0) {
+            memcpy(Next, N->CandidateSet, Count * sizeof(Candidate));
+            ReleaseCandidateSet(N->CandidateSet);
+            N->CandidateSet = Next;
+            Next += Count;
+        }
+        if ((Count = SetSize(N->BackboneCandidateSet)) > 0) {
+            memcpy(Next, N->BackboneCandidateSet,
+                   Count * sizeof(Candidate));
+            ReleaseCandidateSet(N->BackboneCandidateSet);
+            N->BackboneCandidateSet = Next;
+            Next += Count;
+        }
+    } while ((N = N->Suc) != FirstNode);
+    free(CandidateArena);
+    CandidateArena = Arena;
+    CandidateArenaSize = Next - Arena;
+}
+
+/*
+ * The ResizeCandidateSet function changes the size of a candidate set to
+ * Size entries, of which the first Used entries are kept, and returns a
+ * pointer to the resized set. A set in CandidateArena is copied to
+ * memory of its own; otherwise, the set is reallocated.
+ */
+
+Candidate *ResizeCandidateSet(Candidate * Set, int Used, int Size)
+{
+    Candidate *NewSet;
+
+    if (!InArena(Set)) {
+        assert(NewSet = (Candidate *) realloc(Set, Size * sizeof(Candidate)));
+        return NewSet;
+    }
+    assert(NewSet = (Candidate *) malloc(Size * sizeof(Candidate)));
+    memcpy(NewSet, Set, (Used < Size ? Used : Size) * sizeof(Candidate));
+    return NewSet;
+}
+
+/*
+ * The ReleaseCandidateSet function frees the memory of a candidate set,
+ * unless the set is stored in CandidateArena.
+ */
+
+void ReleaseCandidateSet(Candidate * Set)
+{
+    if (!InArena(Set))
+        free(Set);
+}
+
+static int InArena(const Candidate * Set)
+{
+    return Set && CandidateArena && Set >= CandidateArena &&
+        Set < CandidateArena + CandidateArenaSize;
+}
+
+static long SetSize(const Candidate * Set)
+{
+    const Candidate *NN;
+
+    if (!Set)
+        return 0;
+    for (NN = Set; NN->To; NN++);
+    return NN - Set + 1;
+}
@@ -0,0 +1,270 @@
+#include "LKH.h"
+
+/*
+ * The IndexCandidateSets function builds a hash table (CandidateIndex) of
+ * all candidate edges, and a hash table (BackboneCandidateIndex) of all
+ * backbone candidate edges. An edge (From,To) is stored in a table as the
+ * Id of From together with the position of To in the candidate array of
+ * From. The tables allow the LookupCandidate and LookupBackboneCandidate
+ * functions to answer in constant time whether an edge is a candidate
+ * edge, instead of scanning the candidate array.
+ *
+ * Once built, CandidateIndex is kept up to date when single candidate
+ * sets are changed: AddCandidate and AdjustCandidateSet index the edges
+ * they add (IndexCandidate), and AdjustCandidateSet, ResetCandidateSet
+ * and TrimCandidateSet remove the edges of a node from the table before
+ * they reorder or shorten its candidate array, and index them anew
+ * afterwards (UnindexCandidates and IndexCandidates). SwapCandidateSets
+ * of FindTour swaps the tables along with the candidate sets
+ * (SwapCandidateIndexes). Functions that create all candidate sets anew
+ * (CreateCandidateSet, OrderCandidateSet, ReadCandidates, etc.)
+ * invalidate the tables by setting CandidateIndexValid to zero. So does
+ * IndexCandidate, if CandidateIndex has become too full. As long as the
+ * tables are invalid, the lookup functions scan the candidate arrays.
+ *
+ * The tables are built on demand: PerformTrial builds them at the start of
+ * a trial, if the candidate arrays have been scanned at least Dimension
+ * times since the tables were last built (CandidateScans). In this way
+ * the time for building the tables is bounded by the time spent on
+ * scanning, and no memory is used for the tables, if the lookup functions
+ * are seldom called (as is the case with the default parameter values).
+ * The tables cannot be built during the Lin-Kernighan search, since the
+ * nodes are then not necessarily linked by their Suc fields.
+ */
+
+static unsigned EdgeHash(int i, int j);
+static int Size(long Count);
+static int Insert(IndexEntry * Table, int Mask, Node * From,
+                  Candidate * Set, int Position);
+static void Remove(Node * From, int To);
+static Candidate *Lookup(IndexEntry * Table, int Mask, Candidate * Set,
+                         const Node * ta, const Node * tb);
+
+void IndexCandidateSets()
+{
+    Node *N = FirstNode;
+    Candidate *NN;
+    long Count = 0, BackboneCount = 0;
+
+    do {
+        for (NN = N->CandidateSet; NN && NN->To; NN++)
+            Count++;
+        for (NN = N->BackboneCandidateSet; NN && NN->To; NN++)
+            BackboneCount++;
+    } while ((N = N->Suc) != FirstNode);
+    if (Size(Count) != CandidateIndexMask + 1) {
+        free(CandidateIndex);
+        CandidateIndexMask = Size(Count) - 1;
+        assert(CandidateIndex = (IndexEntry *)
+               malloc((CandidateIndexMask + 1) * sizeof(IndexEntry)));
+    }
+    if (Size(BackboneCount) != BackboneCandidateIndexMask + 1) {
+        free(BackboneCandidateIndex);
+        BackboneCandidateIndexMask = Size(BackboneCount) - 1;
+        assert(BackboneCandidateIndex = (IndexEntry *)
+               malloc((BackboneCandidateIndexMask + 1) *
+                      sizeof(IndexEntry)));
+    }
+    memset(CandidateIndex, 0,
+           (CandidateIndexMask + 1) * sizeof(IndexEntry));
+    memset(BackboneCandidateIndex, 0,
+           (BackboneCandidateIndexMask + 1) * sizeof(IndexEntry));
+    CandidateIndexEntries = BackboneCandidateIndexEntries = 0;
+    do {
+        for (NN = N->CandidateSet; NN && NN->To; NN++)
+            CandidateIndexEntries +=
+                Insert(CandidateIndex, CandidateIndexMask, N,
+                       N->CandidateSet, NN - N->CandidateSet);
+        for (NN = N->BackboneCandidateSet; NN && NN->To; NN++)
+            BackboneCandidateIndexEntries +=
+                Insert(BackboneCandidateIndex, BackboneCandidateIndexMask,
+                       N, N->BackboneCandidateSet,
+                       NN - N->BackboneCandidateSet);
+    } while ((N = N->Suc) != FirstNode);
+    CandidateIndexValid = 1;
+    CandidateScans = 0;
+}
+
+/*
+ * The IndexCandidate function adds the candidate edge at the given
+ * position in the candidate array of From to CandidateIndex. If the
+ * table would become more than half full, it is invalidated instead.
+ */
+
+void IndexCandidate(Node * From, int Position)
+{
+    if (!CandidateIndexValid)
+        return;
+    if (2 * (CandidateIndexEntries + 1) > CandidateIndexMask + 1) {
+        CandidateIndexValid = 0;
+        return;
+    }
+    CandidateIndexEntries +=
+        Insert(CandidateIndex, CandidateIndexMask, From,
+               From->CandidateSet, Position);
+}
+
+/*
+ * The IndexCandidates function adds all candidate edges of From to
+ * CandidateIndex.
+ */
+
+void IndexCandidates(Node * From)
+{
+    Candidate *NN;
+
+    for (NN = From->CandidateSet; NN && NN->To; NN++)
+        IndexCandidate(From, NN - From->CandidateSet);
+}
+
+/*
+ * The UnindexCandidates function removes all candidate edges of From from
+ * CandidateIndex. It must be called before the candidate array of From
+ * is reordered or shortened.
+ */
+
+void UnindexCandidates(Node * From)
+{
+    Candidate *NN;
+
+    if (!CandidateIndexValid)
+        return;
+    for (NN = From->CandidateSet; NN && NN->To; NN++)
+        Remove(From, NN->To);
+}
+
+/*
+ * The SwapCandidateIndexes function swaps CandidateIndex and
+ * BackboneCandidateIndex. It is called when the normal and backbone
+ * candidate sets are swapped.
+ */
+
+void SwapCandidateIndexes()
+{
+    IndexEntry *Table = CandidateIndex;
+    int Mask = CandidateIndexMask, Entries = CandidateIndexEntries;
+
+    CandidateIndex = BackboneCandidateIndex;
+    CandidateIndexMask = BackboneCandidateIndexMask;
+    CandidateIndexEntries = BackboneCandidateIndexEntries;
+    BackboneCandidateIndex = Table;
+    BackboneCandidateIndexMask = Mask;
+    BackboneCandidateIndexEntries = Entries;
+}
+
+/*
+ * The LookupCandidate function returns a pointer to the candidate edge
+ * (ta,tb) in the candidate array of ta, or 0 if (ta,tb) is not a candidate
+ * edge.
+ */
+
+Candidate *LookupCandidate(const Node * ta, const Node * tb)
+{
+    return Lookup(CandidateIndex, CandidateIndexMask, ta->CandidateSet,
+                  ta, tb);
+}
+
+/*
+ * The LookupBackboneCandidate function returns a pointer to the backbone
+ * candidate edge (ta,tb), or 0 if (ta,tb) is not a backbone candidate
+ * edge.
+ */
+
+Candidate *LookupBackboneCandidate(const Node * ta, const Node * tb)
+{
+    return Lookup(BackboneCandidateIndex, BackboneCandidateIndexMask,
+                  ta->BackboneCandidateSet, ta, tb);
+}
+
+static unsigned EdgeHash(int i, int j)
+{
+    unsigned h = (unsigned) i * 0x9E3779B1U + (unsigned) j;
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    return h ^ (h >> 13);
+}
+
+/* The number of entries of a table of Count edges: the smallest power
+   of two >= 2 * Count (at least 16) */
+
+static int Size(long Count)
+{
+    long S;
+
+    for (S = 16; S < 2 * Count && S <= INT_MAX / 2; S *= 2);
+    return (int) S;
+}
+
+/* The Insert function inserts an edge into a table and returns 1, or
+   returns 0 if the edge is already in the table */
+
+static int Insert(IndexEntry * Table, int Mask, Node * From,
+                  Candidate * Set, int Position)
+{
+    int To = Set[Position].To;
+    IndexEntry *E;
+    unsigned i;
+
+    for (i = EdgeHash(From->Id, To) & Mask; (E = &Table[i])->From;
+         i = (i + 1) & Mask)
+        if (E->From == From->Id && Set[E->Position].To == To)
+            return 0;           /* Keep the first occurrence */
+    E->From = From->Id;
+    E->Position = Position;
+    return 1;
+}
+
+/* The Remove function removes the edge (From,To) from CandidateIndex, if
+   present. The entries following it in its cluster are moved back, if
+   their probe sequences pass the emptied slot, so that no tombstones
+   are needed */
+
+static void Remove(Node * From, int To)
+{
+    IndexEntry *E;
+    unsigned i, j, Home;
+    int Mask = CandidateIndexMask;
+
+    for (i = EdgeHash(From->Id, To) & Mask;; i = (i + 1) & Mask) {
+        if (!(E = &CandidateIndex[i])->From)
+            return;
+        if (E->From == From->Id && From->CandidateSet[E->Position].To == To)
+            break;
+    }
+    for (j = i;;) {
+        CandidateIndex[i].From = 0;
+        do {
+            j = (j + 1) & Mask;
+            if (!(E = &CandidateIndex[j])->From) {
+                CandidateIndexEntries--;
+                return;
+            }
+            Home = EdgeHash(E->From, NodeSet[E->From].CandidateSet
+                            [E->Position].To) & Mask;
+        } while (((j - Home) & Mask) < ((j - i) & Mask));
+        CandidateIndex[i] = *E;
+        i = j;
+    }
+}
+
+static Candidate *Lookup(IndexEntry * Table, int Mask, Candidate * Set,
+                         const Node * ta, const Node * tb)
+{
+    IndexEntry *E;
+    unsigned i;
+
+    if (!Set)
+        return 0;
+    if (!CandidateIndexValid) {
+        CandidateScans++;
+        for (; Set->To; Set++)
+            if (Set->To == tb->Id)
+                return Set;
+        return 0;
+    }
+    for (i = EdgeHash(ta->Id, tb->Id) & Mask; (E = &Table[i])->From;
+         i = (i + 1) & Mask)
+        if (E->From == ta->Id && Set[E->Position].To == tb->Id)
+            return Set + E->Position;
+    return 0;
+}
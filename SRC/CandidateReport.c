@@ -41,7 +41,7 @@ void CandidateReport()
         Count = 0;
         N = FirstNode;
         do
-            if (IsCommonEdge(N, N->MergeSuc[0]))
+            if (IsCommonEdge(N, Cold(N)->MergeSuc[0]))
                 Count++;
         while ((N = N->Suc) != FirstNode);
         printff("Edges.common = %d\n", Count);
@@ -36,13 +36,15 @@ void ChooseInitialTour()
     int Alternatives, Count, i;
 
     if (KickType > 0 && Kicks > 0 && Trial > 1) {
-        for (Last = FirstNode; (N = Last->BestSuc) != FirstNode; Last = N)
+        for (Last = FirstNode; (N = Cold(Last)->BestSuc) != FirstNode;
+             Last = N)
             Follow(N, Last);
         for (i = 1; i <= Kicks; i++)
             KSwapKick(KickType);
         return;
     }
-    if (Trial == 1 && (!FirstNode->InitialSuc || InitialTourFraction < 1)) {
+    if (Trial == 1 &&
+        (!Cold(FirstNode)->InitialSuc || InitialTourFraction < 1)) {
         if (InitialTourAlgorithm == BORUVKA ||
             InitialTourAlgorithm == GREEDY ||
             InitialTourAlgorithm == MOORE ||
@@ -56,7 +58,7 @@ void ChooseInitialTour()
                 BetterCost = Cost;
                 RecordBetterTour();
             }
-            if (!FirstNode->InitialSuc)
+            if (!Cold(FirstNode)->InitialSuc)
                 return;
         }
     }
@@ -98,7 +100,7 @@ Start:
         Count++;
 
         /* Case A */
-        for (NN = N->CandidateSet; (NextN = NN->To); NN++) {
+        for (NN = N->CandidateSet; (NextN = CandidateNode(NN)); NN++) {
             if (!NextN->V && Fixed(N, NextN)) {
                 Alternatives++;
                 NextN->Next = FirstAlternative;
@@ -106,7 +108,7 @@ Start:
             }
         }
         if (Alternatives == 0 && MergeTourFiles > 1) {
-            for (NN = N->CandidateSet; (NextN = NN->To); NN++) {
+            for (NN = N->CandidateSet; (NextN = CandidateNode(NN)); NN++) {
                 if (!NextN->V && IsCommonEdge(N, NextN)) {
                     Alternatives++;
                     NextN->Next = FirstAlternative;
@@ -114,10 +116,10 @@ Start:
                 }
             }
         }
-        if (Alternatives == 0 && FirstNode->InitialSuc && Trial == 1 &&
+        if (Alternatives == 0 && Cold(FirstNode)->InitialSuc && Trial == 1 &&
             Count <= InitialTourFraction * Dimension) {
             /* Case B */
-            for (NN = N->CandidateSet; (NextN = NN->To); NN++) {
+            for (NN = N->CandidateSet; (NextN = CandidateNode(NN)); NN++) {
                 if (!NextN->V && InInitialTour(N, NextN)) {
                     Alternatives++;
                     NextN->Next = FirstAlternative;
@@ -128,7 +130,7 @@ Start:
         if (Alternatives == 0 && Trial > 1 &&
             ProblemType != HCP && ProblemType != HPP) {
             /* Case C */
-            for (NN = N->CandidateSet; (NextN = NN->To); NN++) {
+            for (NN = N->CandidateSet; (NextN = CandidateNode(NN)); NN++) {
                 if (!NextN->V && FixedOrCommonCandidates(NextN) < 2 &&
                     NN->Alpha == 0 && (InBestTour(N, NextN) ||
                                        InNextBestTour(N, NextN))) {
@@ -140,7 +142,7 @@ Start:
         }
         if (Alternatives == 0) {
             /* Case D */
-            for (NN = N->CandidateSet; (NextN = NN->To); NN++) {
+            for (NN = N->CandidateSet; (NextN = CandidateNode(NN)); NN++) {
                 if (!NextN->V && FixedOrCommonCandidates(NextN) < 2) {
                     Alternatives++;
                     NextN->Next = FirstAlternative;
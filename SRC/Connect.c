@@ -44,7 +44,7 @@ void Connect(Node * N1, int Max, int Sparse)
         while ((N = N->Suc) != FirstNode);
     } else {
         /* Find the requested edge in a sparse graph */
-        for (NN1 = N1->CandidateSet; (N = NN1->To); NN1++) {
+        for (NN1 = N1->CandidateSet; (N = CandidateNode(NN1)); NN1++) {
             if (N == N1->Dad || N1 == N->Dad)
                 continue;
             if (FixedOrCommon(N1, N)) {
@@ -0,0 +1,113 @@
+#define DEFINE_GLOBALS
+#include "LKH.h"
+#include "Sequence.h"
+#include "Genetic.h"
+
+/*
+ * This file contains the definitions of the thread-local variables that
+ * make up the state of the solver (declared in LKH.h, Sequence.h and
+ * Genetic.h), together with functions for transferring this state
+ * between threads.
+ *
+ * An LKHContext is a snapshot of the state variables of a thread.
+ * The SaveContext function creates a snapshot of the state of the calling
+ * thread. The LoadContext function installs a snapshot in the calling
+ * thread. The FreeContext function frees a snapshot.
+ *
+ * Only the variables themselves are copied. Pointer variables in a
+ * loaded context refer to the same data as in the thread that saved it.
+ * A thread that wants to modify such data (e.g., the nodes of the tour)
+ * must first allocate its own copy.
+ *
+ * The list below must contain every variable declared with GLOBAL.
+ */
+
+#define STATE_VARIABLES(X)\
+    X(AscentCandidates) X(BackboneCandidateIndex)\
+    X(BackboneCandidateIndexMask) X(BackboneCandidateIndexEntries)\
+    X(BackboneTrials) X(Backtracking)\
+    X(BestCost)\
+    X(BestTour) X(BetterCost) X(BetterTour) X(Cache) X(CacheMask)\
+    X(CacheHits) X(CacheMisses) X(CacheEvictions) X(CandidateArena)\
+    X(CandidateArenaSize) X(CandidateFiles)\
+    X(CandidateIndex) X(CandidateIndexMask) X(CandidateIndexEntries)\
+    X(CandidateIndexValid)\
+    X(CandidateScans)\
+    X(CostMatrix) X(ProblemMap) X(ProblemMapSize) X(Dimension)\
+    X(DistanceCacheSize)\
+    X(DimensionSaved) X(Excess) X(ExtraCandidates) X(FirstActive)\
+    X(LastActive) X(FirstNode) X(FirstSegment) X(FirstSSegment)\
+    X(Gain23Used) X(Gain23Resets) X(GainCriterionUsed) X(GroupSize)\
+    X(SGroupSize) X(Groups)\
+    X(SGroups) X(Hash) X(Heap) X(HTable) X(InitialPeriod) X(InitialStepSize)\
+    X(InitialTourFraction) X(LastLine) X(LowerBound) X(Kicks) X(KickType)\
+    X(M) X(MaxBreadth) X(MaxCandidates) X(MaxMatrixDimension) X(MaxSwaps)\
+    X(MaxTrials) X(MergeTourFiles) X(MoveType) X(NodeNumbersRead)\
+    X(NodeRenumbering) X(NodeSet) X(ColdNodeSet)\
+    X(Norm) X(NonsequentialMoveType) X(Optimum) X(OriginalId) X(PatchingA)\
+    X(PatchingC) X(PenaltiesRead) X(Precision) X(PredSucCostAvailable)\
+    X(Rand) X(RenumberedId) X(RestrictedSearch) X(Reversed) X(Run) X(Runs)\
+    X(Seed) X(StopAtOptimum)\
+    X(Subgradient) X(SubproblemSize) X(SubsequentMoveType)\
+    X(SubsequentPatching) X(SwapStack) X(Swaps) X(Threads) X(TimeLimit)\
+    X(TourOrder) X(TraceLevel) X(TreeType) X(CurrentTreeType) X(Trial)\
+    X(TrialExchangeInterval) X(TrialThreads)\
+    X(XCoord) X(YCoord) X(ZCoord)\
+    X(ParameterFileName) X(ProblemFileName) X(PiFileName) X(TourFileName)\
+    X(OutputTourFileName) X(InputTourFileName) X(CandidateFileName)\
+    X(InitialTourFileName) X(SubproblemTourFileName) X(MergeTourFileName)\
+    X(CacheDirectory) X(BinaryProblemFileName)\
+    X(Name) X(Type) X(EdgeWeightType) X(EdgeWeightFormat) X(EdgeDataFormat)\
+    X(NodeCoordType) X(DisplayDataType) X(AlphaSupergraph)\
+    X(AlphaSupergraphHops) X(CandidateSetSymmetric)\
+    X(CandidateSetType) X(CoordType) X(DelaunayPartitioning) X(DelaunayPure)\
+    X(ExtraCandidateSetSymmetric) X(ExtraCandidateSetType)\
+    X(InitialTourAlgorithm) X(KarpPartitioning) X(KCenterPartitioning)\
+    X(KMeansPartitioning) X(MoorePartitioning) X(PatchingAExtended)\
+    X(PatchingARestricted) X(PatchingCExtended) X(PatchingCRestricted)\
+    X(ProblemType) X(RohePartitioning) X(SierpinskiPartitioning)\
+    X(SubproblemBorders) X(SubproblemsCompressed) X(WeightType)\
+    X(WeightFormat) X(ParameterFile) X(ProblemFile) X(PiFile)\
+    X(InputTourFile) X(TourFile) X(InitialTourFile) X(SubproblemTourFile)\
+    X(MergeTourFile) X(Distance) X(D) X(C) X(c) X(BestMove) X(BacktrackMove)\
+    X(BestSubsequentMove) X(Gain23Function) X(LinKernighanFunction)\
+    X(MinimumSpanningTreeFunction)\
+    X(t) X(T) X(tSaved) X(p) X(q) X(incl) X(cycle) X(G) X(K)\
+    X(MaxPopulationSize) X(PopulationSize) X(Crossover) X(Population)\
+    X(Fitness)
+
+struct LKHContext {
+    char *State;        /* The values of the state variables, stored
+                           consecutively in the order of STATE_VARIABLES */
+};
+
+#define StateSize(v) + sizeof(v)
+#define Store(v) { memcpy(S, &v, sizeof(v)); S += sizeof(v); }
+#define Load(v) { memcpy(&v, S, sizeof(v)); S += sizeof(v); }
+
+LKHContext *SaveContext()
+{
+    LKHContext *Context;
+    char *S;
+
+    assert(Context = (LKHContext *) malloc(sizeof(LKHContext)));
+    assert(Context->State =
+           (char *) malloc(0 STATE_VARIABLES(StateSize)));
+    S = Context->State;
+    STATE_VARIABLES(Store);
+    return Context;
+}
+
+void LoadContext(const LKHContext * Context)
+{
+    const char *S = Context->State;
+    STATE_VARIABLES(Load);
+}
+
+void FreeContext(LKHContext * Context)
+{
+    if (Context) {
+        free(Context->State);
+        free(Context);
+    }
+}
@@ -0,0 +1,149 @@
+#include "LKH.h"
+#include "Sequence.h"
+#include "Genetic.h"
+
+/*
+ * The CopyStructures function is called by a thread that has loaded the
+ * context of another thread (see Context.c) and wants to search for tours
+ * without interfering with that thread.
+ *
+ * The function gives the calling thread private copies of the nodes, their
+ * cold fields (ColdNodeSet) and their candidate sets, and allocates private
+ * versions of all other structures that are modified during the search
+ * (segments, hash table, distance cache, swap stack, etc.). The cost
+ * matrix, the coordinate arrays, the renumbering tables and the problem
+ * description are still shared (read-only) with the original thread.
+ */
+
+#define Remap(N) ((N) ? NodeSet + ((N) - OldNodeSet) : 0)
+
+static Candidate *CopyCandidateSet(Candidate * Set);
+
+void CopyStructures()
+{
+    Node *OldNodeSet = NodeSet, *N;
+    ColdNode *OldColdNodeSet = ColdNodeSet;
+    int i, j;
+
+    NodeSet = AllocateNodes(Dimension + 1);
+    memcpy(NodeSet, OldNodeSet, (Dimension + 1) * sizeof(Node));
+    assert(ColdNodeSet =
+           (ColdNode *) malloc((Dimension + 1) * sizeof(ColdNode)));
+    memcpy(ColdNodeSet, OldColdNodeSet,
+           (Dimension + 1) * sizeof(ColdNode));
+    for (i = 1; i <= Dimension; i++) {
+        N = &NodeSet[i];
+        N->Pred = Remap(N->Pred);
+        N->Suc = Remap(N->Suc);
+        N->OldPred = Remap(N->OldPred);
+        N->OldSuc = Remap(N->OldSuc);
+        Cold(N)->BestSuc = Remap(Cold(N)->BestSuc);
+        Cold(N)->NextBestSuc = Remap(Cold(N)->NextBestSuc);
+        N->Dad = Remap(N->Dad);
+        N->Nearest = Remap(N->Nearest);
+        N->Next = Remap(N->Next);
+        N->Prev = Remap(N->Prev);
+        N->Mark = Remap(N->Mark);
+        N->FixedTo1 = Remap(N->FixedTo1);
+        N->FixedTo2 = Remap(N->FixedTo2);
+        Cold(N)->FixedTo1Saved = Remap(Cold(N)->FixedTo1Saved);
+        Cold(N)->FixedTo2Saved = Remap(Cold(N)->FixedTo2Saved);
+        N->Head = Remap(N->Head);
+        N->Tail = Remap(N->Tail);
+        Cold(N)->InputSuc = Remap(Cold(N)->InputSuc);
+        Cold(N)->InitialSuc = Remap(Cold(N)->InitialSuc);
+        Cold(N)->SubproblemPred = Remap(Cold(N)->SubproblemPred);
+        Cold(N)->SubproblemSuc = Remap(Cold(N)->SubproblemSuc);
+        Cold(N)->SubBestPred = Remap(Cold(N)->SubBestPred);
+        Cold(N)->SubBestSuc = Remap(Cold(N)->SubBestSuc);
+        N->Added1 = Remap(N->Added1);
+        N->Added2 = Remap(N->Added2);
+        N->Deleted1 = Remap(N->Deleted1);
+        N->Deleted2 = Remap(N->Deleted2);
+        N->Parent = 0;
+        if (Cold(N)->MergeSuc) {
+            Node **MergeSuc = Cold(N)->MergeSuc;
+            assert(Cold(N)->MergeSuc =
+                   (Node **) malloc(MergeTourFiles * sizeof(Node *)));
+            for (j = 0; j < MergeTourFiles; j++)
+                Cold(N)->MergeSuc[j] = Remap(MergeSuc[j]);
+        }
+        N->CandidateSet = CopyCandidateSet(N->CandidateSet);
+        N->BackboneCandidateSet =
+            CopyCandidateSet(N->BackboneCandidateSet);
+    }
+    FirstNode = Remap(FirstNode);
+    FirstActive = Remap(FirstActive);
+    LastActive = Remap(LastActive);
+    DetachStructures();
+    PackCandidateSets();
+}
+
+/*
+ * The DetachStructures function lets the calling thread forget the
+ * structures of the context it has loaded (except the nodes and their
+ * candidate sets), and allocates private ones.
+ */
+
+void DetachStructures()
+{
+    Heap = 0;
+    BestTour = BetterTour = 0;
+    HTable = 0;
+    Rand = 0;
+    Cache = 0;
+    CandidateArena = 0;
+    CandidateArenaSize = 0;
+    CacheHits = CacheMisses = CacheEvictions = 0;
+    CandidateIndex = BackboneCandidateIndex = 0;
+    CandidateIndexMask = BackboneCandidateIndexMask = 0;
+    CandidateIndexEntries = BackboneCandidateIndexEntries = 0;
+    CandidateIndexValid = 0;
+    CandidateScans = 0;
+    T = t = tSaved = 0;
+    G = 0;
+    p = q = incl = cycle = 0;
+    SwapStack = 0;
+    FirstSegment = 0;
+    FirstSSegment = 0;
+    TourOrder = 0;
+    Population = 0;
+    Fitness = 0;
+    PopulationSize = 0;
+    LastLine = 0;
+    AllocateStructures();
+}
+
+/*
+ * The FreeCopiedStructures function frees the structures allocated by
+ * CopyStructures. The structures shared with the original thread are
+ * left untouched. A thread that shares the nodes with the original thread
+ * (and has only called DetachStructures) must set NodeSet and FirstNode
+ * to zero before calling the function.
+ */
+
+void FreeCopiedStructures()
+{
+    CostMatrix = 0;
+    ProblemMap = 0;
+    XCoord = YCoord = ZCoord = 0;
+    OriginalId = RenumberedId = 0;
+    Name = Type = EdgeWeightType = EdgeWeightFormat = 0;
+    EdgeDataFormat = NodeCoordType = DisplayDataType = 0;
+    FreeStructures();
+    FirstNode = 0;
+}
+
+static Candidate *CopyCandidateSet(Candidate * Set)
+{
+    Candidate *NewSet;
+    int Count = 0;
+
+    if (!Set)
+        return 0;
+    while (Set[Count].To)
+        Count++;
+    assert(NewSet = (Candidate *) malloc((Count + 1) * sizeof(Candidate)));
+    memcpy(NewSet, Set, (Count + 1) * sizeof(Candidate));
+    return NewSet;
+}
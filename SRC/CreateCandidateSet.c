@@ -17,6 +17,16 @@
  *
  * The function GenerateCandidates is called to compute the Alpha-values and to 
  * associate to each node a set of incident candidate edges.  
+ * If ALPHA_SUPERGRAPH is specified, the ascent and the computation of
+ * Alpha-values are instead restricted to the edges of a sparse graph
+ * (see CreateSupergraphCandidateSet), and the function OrderCandidateSet
+ * is used.
+ *
+ * If a CACHE_DIRECTORY is given, the penalties and candidate sets are
+ * read from, or written to, files in the directory (see AssignCacheFiles).
+ *
+ * If the problem has a cost matrix, only its entries between the nodes of
+ * the problem are transformed (see SortedNodeIds).
  *
  * The CreateCandidateSet function itself is called from LKHmain.
  *
@@ -27,10 +37,12 @@ void CreateCandidateSet()
 {
     GainType Cost, MaxAlpha, A;
     Node *Na;
-    int CandidatesRead = 0, i;
+    int CandidatesRead = 0, *Id, Ids, i;
     double EntryTime = GetTime();
 
+    CandidateIndexValid = 0;
     Norm = 9999;
+    AssignCacheFiles();
     // C 表示距离计算函数指针，可以指向多种不同计算函数
     if (C == C_EXPLICIT) {// 当距离有距离矩阵表示时
 
@@ -38,11 +50,13 @@ void CreateCandidateSet()
         // 从首节点一直往下遍历，为每个节点的C(距离）乘以precision，以放大到整数级别进行计算
         // 由于距离计算出来后是以下三角矩阵拉直成一个数组储存，每个节点的C都指向数组中，该节点这一行起始位置的前一个位置（因为id从1开始，而数组从0开始）
         // 所以通过如下方式可以为每个距离乘以精度
+        Id = SortedNodeIds(&Ids);
         do {
-            for (i = 1; i < Na->Id; i++)
-                Na->C[i] *= Precision;
+            for (i = 0; i < Ids && Id[i] < Na->Id; i++)
+                Na->C[Id[i]] *= Precision;
         }
         while ((Na = Na->Suc) != FirstNode);
+        free(Id);
     }
     /**
      * 第一、二个大if用于读取可能存在的给定的Pi文件和初始解和初始candidate文件
@@ -51,7 +65,7 @@ void CreateCandidateSet()
     // 或者初始化算法为给定的两种时，直接从文件中读取
     if (Distance == Distance_1 ||
         (MaxTrials == 0 &&
-         (FirstNode->InitialSuc || InitialTourAlgorithm == SIERPINSKI ||
+         (Cold(FirstNode)->InitialSuc || InitialTourAlgorithm == SIERPINSKI ||
           InitialTourAlgorithm == MOORE))) {
         // 从文件中读取候选集
         CandidatesRead = ReadCandidates(MaxCandidates);
@@ -111,7 +125,8 @@ void CreateCandidateSet()
     } else {
         // 无已有的Candidate file，但存在已有的PiFile，并且maxCandidates不为0,
         // 则直接格局Pi值和Minimum1TreeCost来生成cost，而不用进行Ascent
-        if (CandidateSetType != DELAUNAY && MaxCandidates > 0) {
+        if (CandidateSetType != DELAUNAY && !AlphaSupergraph &&
+            MaxCandidates > 0) {
             if (TraceLevel >= 2)
                 printff("Computing lower bound ... ");
             Cost = Minimum1TreeCost(0);
@@ -119,7 +134,7 @@ void CreateCandidateSet()
                 printff("done\n");
         } else {
             // 只有当候选集类型为DELAUNAY类型时，才需要调用对应的createCandidate函数后再求cost
-            CreateDelaunayCandidateSet();
+            CreateSupergraphCandidateSet();
             Na = FirstNode;
             do { // 这里为何要将每个节点的pi值赋值为0？
                 Na->BestPi = Na->Pi;
@@ -155,7 +170,8 @@ void CreateCandidateSet()
     MaxAlpha = (GainType) fabs(Excess * Cost); // 得到最大的alpha阈值，用于与maxCandidate共同限制候选集大小
     if ((A = Optimum * Precision - Cost) > 0 && A < MaxAlpha)
         MaxAlpha = A;
-    if (CandidateSetType == DELAUNAY || MaxCandidates == 0)
+    if (CandidateSetType == DELAUNAY || AlphaSupergraph ||
+        MaxCandidates == 0)
         OrderCandidateSet(MaxCandidates, MaxAlpha, CandidateSetSymmetric);
     else
         GenerateCandidates(MaxCandidates, MaxAlpha, CandidateSetSymmetric);
@@ -168,6 +184,7 @@ void CreateCandidateSet()
         AddTourCandidates();
     }
     ResetCandidateSet(); // 在每个节点的候选集内部进行排序，并去除不可能的候选点
+    PackCandidateSets();
     if (MaxTrials > 0 ||
         (InitialTourAlgorithm != SIERPINSKI &&
          InitialTourAlgorithm != MOORE)) {
@@ -176,9 +193,10 @@ void CreateCandidateSet()
             if (!Na->CandidateSet || !Na->CandidateSet[0].To) {
                 if (MaxCandidates == 0)
                     eprintf("MAX_CANDIDATES = 0: Node %d has no candidates",
-                            Na->Id);
+                            ExternalId(Na->Id));
                 else
-                    eprintf("Node %d has no candidates", Na->Id);
+                    eprintf("Node %d has no candidates",
+                            ExternalId(Na->Id));
             }
         }
         while ((Na = Na->Suc) != FirstNode);
@@ -187,10 +205,12 @@ void CreateCandidateSet()
     }
     if (C == C_EXPLICIT) {
         Na = FirstNode;
+        Id = SortedNodeIds(&Ids);
         do
-            for (i = 1; i < Na->Id; i++)
-                Na->C[i] += Na->Pi + NodeSet[i].Pi;
+            for (i = 0; i < Ids && Id[i] < Na->Id; i++)
+                Na->C[Id[i]] += Na->Pi + NodeSet[Id[i]].Pi;
         while ((Na = Na->Suc) != FirstNode);
+        free(Id);
     }
     if (TraceLevel >= 1) {
         CandidateReport();
@@ -8,7 +8,7 @@
  * The function is called from CreateCandidateSet.
  */
 
-static int Level = 0;
+static THREAD_LOCAL int Level = 0;
 
 void CreateDelaunayCandidateSet()
 {
@@ -64,7 +64,7 @@ void CreateDelaunayCandidateSet()
             /* Transform longitude (180 and -180 map to 0) */
             From = FirstNode;
             do {
-                From->Zc = From->Y;
+                Cold(From)->Zc = From->Y;
                 if (WeightType == GEO || WeightType == GEO_MEEUS)
                     From->Y =
                         (int) From->Y + 5.0 * (From->Y -
@@ -74,14 +74,16 @@ void CreateDelaunayCandidateSet()
                     From->Y =
                         (int) From->Y + 3.0 * (From->Y -
                                                (int) From->Y) / 5.0;
+                StoreCoordinates(From);
             } while ((From = From->Suc) != FirstNode);
             Level++;
             CreateDelaunayCandidateSet();
             Level--;
             From = FirstNode;
-            do
-                From->Y = From->Zc;
-            while ((From = From->Suc) != FirstNode);
+            do {
+                From->Y = Cold(From)->Zc;
+                StoreCoordinates(From);
+            } while ((From = From->Suc) != FirstNode);
         }
     }
     if (Level == 0) {
@@ -15,13 +15,13 @@ static void ComputeBounds(int start, int end);
 typedef int (*ContainsFunction) (Node * T, int Q, Node * N);
 typedef int (*BoxOverlapsFunction) (Node * T, int Q, Node * N);
 
-static Node **KDTree;
-static Candidate *CandidateSet;
-static double *XMin, *XMax, *YMin, *YMax, *ZMin, *ZMax;
-static int Candidates, Radius;
-static ContainsFunction Contains;
-static BoxOverlapsFunction BoxOverlaps;
-static int Level = 0;
+static THREAD_LOCAL Node **KDTree;
+static THREAD_LOCAL Candidate *CandidateSet;
+static THREAD_LOCAL double *XMin, *XMax, *YMin, *YMax, *ZMin, *ZMax;
+static THREAD_LOCAL int Candidates, Radius;
+static THREAD_LOCAL ContainsFunction Contains;
+static THREAD_LOCAL BoxOverlapsFunction BoxOverlaps;
+static THREAD_LOCAL int Level = 0;
 
 /*
  * The CreateQuadrantCandidateSet function creates for each node 
@@ -73,7 +73,7 @@ void CreateQuadrantCandidateSet(int K)
     do {
         Count = 0;
         for (NFrom = From->CandidateSet; NFrom && NFrom->To; NFrom++)
-            if (FixedOrCommon(From, NFrom->To) && ++Count == 2)
+            if (FixedOrCommon(From, CandidateNode(NFrom)) && ++Count == 2)
                 break;
         if (Count == 2)
             continue;
@@ -81,7 +81,7 @@ void CreateQuadrantCandidateSet(int K)
         for (Q = 1; Q <= L; Q++) {
             NearestQuadrantNeighbors(From, Q, CandPerQ);
             for (i = 0; i < Candidates; i++) {
-                To = CandidateSet[i].To;
+                To = CandidateNode(&CandidateSet[i]);
                 if (AddCandidate(From, To, D(From, To), 1))
                     Added++;
             }
@@ -89,7 +89,7 @@ void CreateQuadrantCandidateSet(int K)
         if (K > Added) {
             NearestQuadrantNeighbors(From, 0, K - Added);
             for (i = 0; i < Candidates; i++) {
-                To = CandidateSet[i].To;
+                To = CandidateNode(&CandidateSet[i]);
                 AddCandidate(From, To, D(From, To), 2);
             }
         }
@@ -124,7 +124,7 @@ void CreateQuadrantCandidateSet(int K)
             do {
                 SavedCandidateSet[From->Id] = From->CandidateSet;
                 From->CandidateSet = 0;
-                From->Zc = From->Y;
+                Cold(From)->Zc = From->Y;
                 if (WeightType == GEO || WeightType == GEO_MEEUS)
                     From->Y =
                         (int) From->Y + 5.0 * (From->Y -
@@ -134,18 +134,21 @@ void CreateQuadrantCandidateSet(int K)
                     From->Y =
                         (int) From->Y + 3.0 * (From->Y -
                                                (int) From->Y) / 5.0;
+                StoreCoordinates(From);
             } while ((From = From->Suc) != FirstNode);
             Level++;
             CreateQuadrantCandidateSet(K);
             Level--;
             From = FirstNode;
-            do
-                From->Y = From->Zc;
-            while ((From = From->Suc) != FirstNode);
+            do {
+                From->Y = Cold(From)->Zc;
+                StoreCoordinates(From);
+            } while ((From = From->Suc) != FirstNode);
             do {
                 Candidate *QCandidateSet = From->CandidateSet;
                 From->CandidateSet = SavedCandidateSet[From->Id];
-                for (NFrom = QCandidateSet; (To = NFrom->To); NFrom++)
+                for (NFrom = QCandidateSet;
+                     (To = CandidateNode(NFrom)); NFrom++)
                     AddCandidate(From, To, NFrom->Cost, NFrom->Alpha);
                 free(QCandidateSet);
             } while ((From = From->Suc) != FirstNode);
@@ -202,7 +205,7 @@ void CreateNearestNeighborCandidateSet(int K)
     do {
         NearestQuadrantNeighbors(From, 0, K);
         for (i = 0; i < Candidates; i++) {
-            To = CandidateSet[i].To;
+            To = CandidateNode(&CandidateSet[i]);
             AddCandidate(From, To, D(From, To), 1);
         }
     } while ((From = From->Suc) != FirstNode);
@@ -229,21 +232,23 @@ void CreateNearestNeighborCandidateSet(int K)
         do {
             SavedCandidateSet[From->Id] = From->CandidateSet;
             From->CandidateSet = 0;
-            From->Yc = From->Y;
+            Cold(From)->Yc = From->Y;
             From->Y += From->Y > 0 ? -180 : 180;
+            StoreCoordinates(From);
         } while ((From = From->Suc) != FirstNode);
         Level++;
         CreateNearestNeighborCandidateSet(K);
         Level--;
         From = FirstNode;
-        do
-            From->Y = From->Yc;
-        while ((From = From->Suc) != FirstNode);
+        do {
+            From->Y = Cold(From)->Yc;
+            StoreCoordinates(From);
+        } while ((From = From->Suc) != FirstNode);
         do {
             Candidate *QCandidateSet = From->CandidateSet;
             Candidate *NFrom;
             From->CandidateSet = SavedCandidateSet[From->Id];
-            for (NFrom = QCandidateSet; (To = NFrom->To); NFrom++)
+            for (NFrom = QCandidateSet; (To = CandidateNode(NFrom)); NFrom++)
                 AddCandidate(From, To, NFrom->Cost, NFrom->Alpha);
             free(QCandidateSet);
         } while ((From = From->Suc) != FirstNode);
@@ -464,7 +469,7 @@ static int InCandidateSet(Node * N, Node * T)
 {
     int i;
     for (i = 0; i < Candidates; i++)
-        if (CandidateSet[i].To == T)
+        if (CandidateSet[i].To == T->Id)
             return 1;
     return IsCandidate(N, T);
 }
@@ -491,7 +496,7 @@ static void NQN(Node * N, int Q, int start, int end, int K)
         int i = Candidates;
         while (--i >= 0 && d < CandidateSet[i].Cost)
             CandidateSet[i + 1] = CandidateSet[i];
-        CandidateSet[i + 1].To = T;
+        CandidateSet[i + 1].To = T->Id;
         CandidateSet[i + 1].Cost = d;
         if (Candidates < K)
             Candidates++;
@@ -0,0 +1,27 @@
+#include "LKH.h"
+
+/*
+ * The CreateSupergraphCandidateSet function creates the sparse graph on
+ * which the ascent and the computation of Alpha-values are performed when
+ * CANDIDATE_SET_TYPE = DELAUNAY or ALPHA_SUPERGRAPH is specified.
+ *
+ * The graph is either the Delaunay graph or the graph in which each node
+ * is connected to its 2 * MAX_CANDIDATES nearest quadrant neighbors. The
+ * latter graph is made symmetric, so that its minimum spanning tree can
+ * be computed. In both cases, the edges of any given tours (e.g., the
+ * initial tour) are added.
+ *
+ * The graph is extended with nodes in the vicinity on the minimum 1-tree
+ * by the function OrderCandidateSet.
+ */
+
+void CreateSupergraphCandidateSet()
+{
+    if (CandidateSetType == DELAUNAY || AlphaSupergraph == DELAUNAY)
+        CreateDelaunayCandidateSet();
+    else {
+        CreateQuadrantCandidateSet(2 * MaxCandidates);
+        SymmetrizeCandidateSet();
+        AddTourCandidates();
+    }
+}
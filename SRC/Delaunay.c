@@ -71,8 +71,8 @@ void delaunay(int n)
 
     alloc_memory(n);
     for (i = 0; i < n; i++) {
-        p_array[i].x = N->X;
-        p_array[i].y = N->Y;
+        p_array[i].x = XCoord[N->Id];
+        p_array[i].y = YCoord[N->Id];
         p_array[i].id = N->Id;
         p_array[i].entry_pt = 0;
         N = N->Suc;
@@ -463,10 +463,10 @@ static edge *make_edge(point * u, point * v)
     return e;
 }
 
-point *p_array;
-static edge *e_array;
-static edge **free_list_e;
-static int n_free_e;
+THREAD_LOCAL point *p_array;
+static THREAD_LOCAL edge *e_array;
+static THREAD_LOCAL edge **free_list_e;
+static THREAD_LOCAL int n_free_e;
 
 static void alloc_memory(int n)
 {
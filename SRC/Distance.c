@@ -6,6 +6,12 @@
  * The appropriate function is referenced by the function pointer Distance.
  */
 
+/* No fused multiply-add, so that the distances are identical to those
+   computed by the kernels of DistanceBatch */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
 int Distance_1(Node * Na, Node * Nb)
 {
     return 1;
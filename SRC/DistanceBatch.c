@@ -0,0 +1,214 @@
+#include "LKH.h"
+
+/*
+ * The DistanceBatch function computes the distances from a node, From, to
+ * each of the Count nodes in the array To, and stores them in the array
+ * Dist. That is, Dist[i] = Distance(From, To[i]) for i = 0, ..., Count - 1.
+ *
+ * The DistanceRange function computes the distances from From to the
+ * Count nodes of NodeSet starting with node number Id. That is,
+ * Dist[i] = Distance(From, &NodeSet[Id + i]) for i = 0, ..., Count - 1.
+ * The coordinates of these nodes are read directly from the arrays XCoord,
+ * YCoord and ZCoord. DistanceBatch gathers the coordinates of its nodes
+ * into small local arrays of DistanceBatchSize elements.
+ *
+ * For the edge weight types EUC_2D, EUC_3D, CEIL_2D, CEIL_3D and ATT the
+ * distances are computed by a kernel that processes several nodes at a
+ * time. On x86 processors the kernel uses AVX-512 or AVX2 instructions,
+ * if the processor supports them (determined at runtime by means of the
+ * CPUID instruction). Otherwise, a scalar kernel is used.
+ *
+ * The results are identical to those of the distance functions in
+ * Distance.c. The kernels perform the same IEEE double precision
+ * operations in the same order (without fused multiply-add), and square
+ * roots, ceilings and conversions to integer are exact in all kernels.
+ *
+ * For the other edge weight types, the function Distance is called for
+ * each node.
+ *
+ * The HasDistanceKernel function returns 1 if the current distance
+ * function is computed by a vector kernel; otherwise 0. Callers use it to
+ * decide whether a scan over many nodes should be batched. The scalar
+ * kernel is not faster than the lower bound pruning of the unbatched
+ * scans.
+ */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_KERNELS
+#include <immintrin.h>
+#endif
+
+typedef void (*Kernel) (int Type, Node * From, const double *X,
+                        const double *Y, const double *Z, int Count,
+                        int *Dist);
+
+static int KernelType(void);
+static Kernel SelectKernel(void);
+static void ScalarKernel(int Type, Node * From, const double *X,
+                         const double *Y, const double *Z, int Count,
+                         int *Dist);
+#ifdef X86_KERNELS
+static void AVX2Kernel(int Type, Node * From, const double *X,
+                       const double *Y, const double *Z, int Count,
+                       int *Dist);
+static void AVX512Kernel(int Type, Node * From, const double *X,
+                         const double *Y, const double *Z, int Count,
+                         int *Dist);
+#endif
+
+void DistanceBatch(Node * From, Node ** To, int Count, int *Dist)
+{
+    double X[DistanceBatchSize], Y[DistanceBatchSize], Z[DistanceBatchSize];
+    int Type = KernelType(), i, j, n;
+    Kernel K;
+
+    if (Type == -1) {
+        for (i = 0; i < Count; i++)
+            Dist[i] = Distance(From, To[i]);
+        return;
+    }
+    K = SelectKernel();
+    for (i = 0; i < Count; i += n) {
+        n = Count - i < DistanceBatchSize ? Count - i : DistanceBatchSize;
+        for (j = 0; j < n; j++) {
+            X[j] = To[i + j]->X;
+            Y[j] = To[i + j]->Y;
+            Z[j] = To[i + j]->Z;
+        }
+        K(Type, From, X, Y, Z, n, Dist + i);
+    }
+}
+
+void DistanceRange(Node * From, int Id, int Count, int *Dist)
+{
+    int Type = KernelType(), i;
+
+    if (Type == -1) {
+        for (i = 0; i < Count; i++)
+            Dist[i] = Distance(From, &NodeSet[Id + i]);
+        return;
+    }
+    SelectKernel()(Type, From, XCoord + Id, YCoord + Id, ZCoord + Id,
+                   Count, Dist);
+}
+
+int HasDistanceKernel()
+{
+    return KernelType() != -1 && SelectKernel() != ScalarKernel;
+}
+
+static int KernelType()
+{
+    return Distance == Distance_EUC_2D ? EUC_2D :
+        Distance == Distance_EUC_3D ? EUC_3D :
+        Distance == Distance_CEIL_2D ? CEIL_2D :
+        Distance == Distance_CEIL_3D ? CEIL_3D :
+        Distance == Distance_ATT ? ATT : -1;
+}
+
+static Kernel SelectKernel()
+{
+#ifdef X86_KERNELS
+    if (__builtin_cpu_supports("avx512f"))
+        return AVX512Kernel;
+    if (__builtin_cpu_supports("avx2"))
+        return AVX2Kernel;
+#endif
+    return ScalarKernel;
+}
+
+static void ScalarKernel(int Type, Node * From, const double *X,
+                         const double *Y, const double *Z, int Count,
+                         int *Dist)
+{
+    double xd, yd, zd;
+    int i;
+
+    for (i = 0; i < Count; i++) {
+        xd = From->X - X[i];
+        yd = From->Y - Y[i];
+        switch (Type) {
+        case EUC_2D:
+            Dist[i] = (int) (sqrt(xd * xd + yd * yd) + 0.5);
+            break;
+        case CEIL_2D:
+            Dist[i] = (int) ceil(sqrt(xd * xd + yd * yd));
+            break;
+        case ATT:
+            Dist[i] = (int) ceil(sqrt((xd * xd + yd * yd) / 10.0));
+            break;
+        case EUC_3D:
+            zd = From->Z - Z[i];
+            Dist[i] = (int) (sqrt(xd * xd + yd * yd + zd * zd) + 0.5);
+            break;
+        case CEIL_3D:
+            zd = From->Z - Z[i];
+            Dist[i] = (int) ceil(sqrt(xd * xd + yd * yd + zd * zd));
+            break;
+        }
+    }
+}
+
+#ifdef X86_KERNELS
+
+__attribute__ ((target("avx2")))
+static void AVX2Kernel(int Type, Node * From, const double *X,
+                       const double *Y, const double *Z, int Count,
+                       int *Dist)
+{
+    __m256d Xa = _mm256_set1_pd(From->X), Ya = _mm256_set1_pd(From->Y),
+        Za = _mm256_set1_pd(From->Z), Half = _mm256_set1_pd(0.5),
+        Ten = _mm256_set1_pd(10.0), xd, yd, zd, s;
+    int i;
+
+    for (i = 0; i + 4 <= Count; i += 4) {
+        xd = _mm256_sub_pd(Xa, _mm256_loadu_pd(X + i));
+        yd = _mm256_sub_pd(Ya, _mm256_loadu_pd(Y + i));
+        s = _mm256_add_pd(_mm256_mul_pd(xd, xd), _mm256_mul_pd(yd, yd));
+        if (Type == EUC_3D || Type == CEIL_3D) {
+            zd = _mm256_sub_pd(Za, _mm256_loadu_pd(Z + i));
+            s = _mm256_add_pd(s, _mm256_mul_pd(zd, zd));
+        } else if (Type == ATT)
+            s = _mm256_div_pd(s, Ten);
+        s = _mm256_sqrt_pd(s);
+        s = Type == EUC_2D || Type == EUC_3D ? _mm256_add_pd(s, Half) :
+            _mm256_ceil_pd(s);
+        _mm_storeu_si128((__m128i *) (Dist + i), _mm256_cvttpd_epi32(s));
+    }
+    ScalarKernel(Type, From, X + i, Y + i, Z + i, Count - i, Dist + i);
+}
+
+__attribute__ ((target("avx512f")))
+static void AVX512Kernel(int Type, Node * From, const double *X,
+                         const double *Y, const double *Z, int Count,
+                         int *Dist)
+{
+    __m512d Xa = _mm512_set1_pd(From->X), Ya = _mm512_set1_pd(From->Y),
+        Za = _mm512_set1_pd(From->Z), Half = _mm512_set1_pd(0.5),
+        Ten = _mm512_set1_pd(10.0), xd, yd, zd, s;
+    int i;
+
+    for (i = 0; i + 8 <= Count; i += 8) {
+        xd = _mm512_sub_pd(Xa, _mm512_loadu_pd(X + i));
+        yd = _mm512_sub_pd(Ya, _mm512_loadu_pd(Y + i));
+        s = _mm512_add_pd(_mm512_mul_pd(xd, xd), _mm512_mul_pd(yd, yd));
+        if (Type == EUC_3D || Type == CEIL_3D) {
+            zd = _mm512_sub_pd(Za, _mm512_loadu_pd(Z + i));
+            s = _mm512_add_pd(s, _mm512_mul_pd(zd, zd));
+        } else if (Type == ATT)
+            s = _mm512_div_pd(s, Ten);
+        s = _mm512_sqrt_pd(s);
+        s = Type == EUC_2D || Type == EUC_3D ? _mm512_add_pd(s, Half) :
+            _mm512_roundscale_pd(s, _MM_FROUND_TO_POS_INF |
+                                 _MM_FROUND_NO_EXC);
+        _mm256_storeu_si256((__m256i *) (Dist + i),
+                            _mm512_cvttpd_epi32(s));
+    }
+    ScalarKernel(Type, From, X + i, Y + i, Z + i, Count - i, Dist + i);
+}
+
+#endif
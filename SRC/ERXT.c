@@ -24,8 +24,8 @@
  * choosing foreign edges.
  */
 
-static Node *FirstFree;
-static int Tabu;
+static THREAD_LOCAL Node *FirstFree;
+static THREAD_LOCAL int Tabu;
 
 static Node *SelectNext(Node * N);
 
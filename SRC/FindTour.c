@@ -16,28 +16,19 @@
  */
 
 static void SwapCandidateSets();
-static GainType OrdinalTourCost;
+static THREAD_LOCAL GainType OrdinalTourCost;
 
 GainType FindTour()
 {
-    GainType Cost;
     Node *t;
-    int i;
     double EntryTime = GetTime();
 
     t = FirstNode;
     do
-        t->OldPred = t->OldSuc = t->NextBestSuc = t->BestSuc = 0;
+        t->OldPred = t->OldSuc = Cold(t)->NextBestSuc = Cold(t)->BestSuc = 0;
     while ((t = t->Suc) != FirstNode);
-    if (Run == 1 && Dimension == DimensionSaved) {
+    if (Run == 1)
         OrdinalTourCost = 0;
-        for (i = 1; i < Dimension; i++)
-            OrdinalTourCost += C(&NodeSet[i], &NodeSet[i + 1])
-                - NodeSet[i].Pi - NodeSet[i + 1].Pi;
-        OrdinalTourCost += C(&NodeSet[Dimension], &NodeSet[1])
-            - NodeSet[Dimension].Pi - NodeSet[1].Pi;
-        OrdinalTourCost /= Precision;
-    }
     BetterCost = PLUS_INFINITY;
     if (MaxTrials > 0)
         HashInitialize(HTable);
@@ -46,69 +37,14 @@ GainType FindTour()
         ChooseInitialTour();
     }
 
-    for (Trial = 1; Trial <= MaxTrials; Trial++) {
-        if (GetTime() - EntryTime >= TimeLimit) {
-            if (TraceLevel >= 1)
-                printff("*** Time limit exceeded ***\n");
-            break;
-        }
-        /* Choose FirstNode at random */
-        if (Dimension == DimensionSaved)
-            FirstNode = &NodeSet[1 + Random() % Dimension];
-        else
-            for (i = Random() % Dimension; i > 0; i--)
-                FirstNode = FirstNode->Suc;
-        ChooseInitialTour();
-        Cost = LinKernighan();
-        if (FirstNode->BestSuc) {
-            /* Merge tour with current best tour */
-            t = FirstNode;
-            while ((t = t->Next = t->BestSuc) != FirstNode);
-            Cost = MergeWithTour();
-        }
-        if (Dimension == DimensionSaved && Cost >= OrdinalTourCost &&
-            BetterCost > OrdinalTourCost) {
-            /* Merge tour with ordinal tour */
-            for (i = 1; i < Dimension; i++)
-                NodeSet[i].Next = &NodeSet[i + 1];
-            NodeSet[Dimension].Next = &NodeSet[1];
-            Cost = MergeWithTour();
-        }
-        if (Cost < BetterCost) {
-            if (TraceLevel >= 1) {
-                printff("* %d: Cost = " GainFormat, Trial, Cost);
-                if (Optimum != MINUS_INFINITY && Optimum != 0)
-                    printff(", Gap = %0.4f%%",
-                            100.0 * (Cost - Optimum) / Optimum);
-                printff(", Time = %0.2f sec. %s\n",
-                        fabs(GetTime() - EntryTime),
-                        Cost < Optimum ? "<" : Cost == Optimum ? "=" : "");
-            }
-            BetterCost = Cost;
-            RecordBetterTour();
-            if (Dimension == DimensionSaved && BetterCost < BestCost)
-                WriteTour(OutputTourFileName, BetterTour, BetterCost);
-            if (StopAtOptimum && BetterCost == Optimum)
+    if (TrialThreads > 1 && MaxTrials > 1 && BackboneTrials == 0 &&
+        Dimension == DimensionSaved)
+        PerformTrialsInParallel();
+    else
+        for (Trial = 1; Trial <= MaxTrials; Trial++)
+            if (!PerformTrial(EntryTime))
                 break;
-            AdjustCandidateSet();
-            HashInitialize(HTable);
-            HashInsert(HTable, Hash, Cost);
-        } else if (TraceLevel >= 2)
-            printff("  %d: Cost = " GainFormat ", Time = %0.2f sec.\n",
-                    Trial, Cost, fabs(GetTime() - EntryTime));
-        /* Record backbones if wanted */
-        if (Trial <= BackboneTrials && BackboneTrials < MaxTrials) {
-            SwapCandidateSets();
-            AdjustCandidateSet();
-            if (Trial == BackboneTrials) {
-                if (TraceLevel >= 1) {
-                    printff("# %d: Backbone candidates ->\n", Trial);
-                    CandidateReport();
-                }
-            } else
-                SwapCandidateSets();
-        }
-    }
+
     if (BackboneTrials > 0 && BackboneTrials < MaxTrials) {
         if (Trial > BackboneTrials ||
             (Trial == BackboneTrials &&
@@ -116,27 +52,118 @@ GainType FindTour()
             SwapCandidateSets();
         t = FirstNode;
         do {
-            free(t->BackboneCandidateSet);
+            ReleaseCandidateSet(t->BackboneCandidateSet);
             t->BackboneCandidateSet = 0;
         } while ((t = t->Suc) != FirstNode);
     }
     t = FirstNode;
     if (Norm == 0) {
         do
-            t = t->BestSuc = t->Suc;
+            t = Cold(t)->BestSuc = t->Suc;
         while (t != FirstNode);
     }
     Hash = 0;
     do {
-        (t->Suc = t->BestSuc)->Pred = t;
+        (t->Suc = Cold(t)->BestSuc)->Pred = t;
         Hash ^= Rand[t->Id] * Rand[t->Suc->Id];
-    } while ((t = t->BestSuc) != FirstNode);
+    } while ((t = Cold(t)->BestSuc) != FirstNode);
     if (Trial > MaxTrials)
         Trial = MaxTrials;
     ResetCandidateSet();
     return BetterCost;
 }
 
+/*
+ * The PerformTrial function performs trial number Trial of FindTour:
+ * an initial tour is chosen, the tour is improved by LinKernighan, and
+ * the resulting tour is merged with the current best tour of the run.
+ * The best tour is recorded if it has been improved.
+ *
+ * The function returns 0 if the trials of the run should stop (because 
+ * the time limit has been exceeded, or the optimum has been found);
+ * otherwise 1. EntryTime is the time at which the run was started.
+ */
+
+int PerformTrial(double EntryTime)
+{
+    GainType Cost;
+    Node *t;
+    int i;
+
+    if (GetTime() - EntryTime >= TimeLimit) {
+        if (TraceLevel >= 1)
+            printff("*** Time limit exceeded ***\n");
+        return 0;
+    }
+    if (OrdinalTourCost == 0 && Dimension == DimensionSaved) {
+        for (i = 1; i < Dimension; i++)
+            OrdinalTourCost += C(&NodeSet[i], &NodeSet[i + 1])
+                - NodeSet[i].Pi - NodeSet[i + 1].Pi;
+        OrdinalTourCost += C(&NodeSet[Dimension], &NodeSet[1])
+            - NodeSet[Dimension].Pi - NodeSet[1].Pi;
+        OrdinalTourCost /= Precision;
+    }
+    /* Choose FirstNode at random */
+    if (Dimension == DimensionSaved)
+        FirstNode = &NodeSet[1 + Random() % Dimension];
+    else
+        for (i = Random() % Dimension; i > 0; i--)
+            FirstNode = FirstNode->Suc;
+    if (!CandidateIndexValid && CandidateScans >= Dimension)
+        IndexCandidateSets();
+    ChooseInitialTour();
+    Cost = LinKernighanFunction();
+    if (Cold(FirstNode)->BestSuc) {
+        /* Merge tour with current best tour */
+        t = FirstNode;
+        while ((t = t->Next = Cold(t)->BestSuc) != FirstNode);
+        Cost = MergeWithTour();
+    }
+    if (Dimension == DimensionSaved && Cost >= OrdinalTourCost &&
+        BetterCost > OrdinalTourCost) {
+        /* Merge tour with ordinal tour */
+        for (i = 1; i < Dimension; i++)
+            NodeSet[i].Next = &NodeSet[i + 1];
+        NodeSet[Dimension].Next = &NodeSet[1];
+        Cost = MergeWithTour();
+    }
+    if (Cost < BetterCost) {
+        if (TraceLevel >= 1) {
+            printff("* %d: Cost = " GainFormat, Trial, Cost);
+            if (Optimum != MINUS_INFINITY && Optimum != 0)
+                printff(", Gap = %0.4f%%",
+                        100.0 * (Cost - Optimum) / Optimum);
+            printff(", Time = %0.2f sec. %s\n",
+                    fabs(GetTime() - EntryTime),
+                    Cost < Optimum ? "<" : Cost == Optimum ? "=" : "");
+        }
+        BetterCost = Cost;
+        RecordBetterTour();
+        if (Dimension == DimensionSaved && BetterCost < BestCost)
+            WriteTour(OutputTourFileName, BetterTour, BetterCost);
+        if (StopAtOptimum && BetterCost == Optimum)
+            return 0;
+        AdjustCandidateSet();
+        HashInitialize(HTable);
+        HashInsert(HTable, Hash, Cost);
+    } else if (TraceLevel >= 2)
+        printff("  %d: Cost = " GainFormat ", Time = %0.2f sec.\n",
+                Trial, Cost, fabs(GetTime() - EntryTime));
+    /* Record backbones if wanted */
+    if (Trial <= BackboneTrials && BackboneTrials < MaxTrials) {
+        SwapCandidateSets();
+        AdjustCandidateSet();
+        if (Trial == BackboneTrials) {
+            if (TraceLevel >= 1) {
+                printff("# %d: Backbone candidates ->\n", Trial);
+                CandidateReport();
+            }
+        } else
+            SwapCandidateSets();
+    }
+    return 1;
+}
+
 /*
  * The SwapCandidateSets function swaps the normal and backbone candidate sets.
  */
@@ -144,6 +171,7 @@ GainType FindTour()
 static void SwapCandidateSets()
 {
     Node *t = FirstNode;
+    SwapCandidateIndexes();
     do {
         Candidate *Temp = t->CandidateSet;
         t->CandidateSet = t->BackboneCandidateSet;
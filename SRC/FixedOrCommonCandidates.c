@@ -15,9 +15,10 @@ int FixedOrCommonCandidates(Node * N)
     if (!N->FixedTo1 && MergeTourFiles < 2)
         return 0;
     for (NN = N->CandidateSet; NN && NN->To; NN++)
-        if (FixedOrCommon(N, NN->To))
+        if (FixedOrCommon(N, CandidateNode(NN)))
             Count++;
     if (Count > 2)
-        eprintf("Node %d has more than two required candidate edges", N->Id);
+        eprintf("Node %d has more than two required candidate edges",
+                ExternalId(N->Id));
     return Count;
 }
@@ -1,5 +1,7 @@
 #include "LKH.h"
 
+static void SwapLinks(Node * N);
+
 /*
  * The Flip function performs a 2-opt move. Edges (t1,t2) and (t3,t4) 
  * are exchanged with edges (t2,t3) and (t4,t1). Node t4 is one of 
@@ -10,14 +12,19 @@
  * is used for a tour; if the two-level tree representation is used, 
  * the function Flip_SL is used instead.
  *
- * The 2-opt move is made by swapping Pred and Suc of each node of the
- * two segments, and then reconnecting the segments by suitable
- * settings of Pred and Suc of t1, t2, t3 and t4. In addition,
- * Rank is updated for nodes in the reversed segment (Rank gives the
- * ordinal number of a node in the tour).
+ * In this representation the nodes are also kept in an array, TourOrder,
+ * in tour order. Rank gives the position of a node in the array (an
+ * integer from 1 to Dimension), so TourOrder[N->Rank] == N.
+ *
+ * The 2-opt move is made by reversing one of the two segments defined by
+ * the move in TourOrder (updating Rank for its nodes), swapping Pred and
+ * Suc of each node of the segment, and then reconnecting the segments by
+ * suitable settings of Pred and Suc of t1, t2, t3 and t4. The segment is
+ * traversed through the array from both ends, rather than by following
+ * the Suc links, so that the nodes can be fetched from memory
+ * independently of each other.
  *
- * Any of two segments defined by the 2-opt move may be reversed. The
- * segment with the smallest number of nodes is reversed in order to
+ * The segment with the smallest number of nodes is reversed in order to
  * speed up computations. The number of nodes in a segment is found 
  * from the Rank-values. 
  * 
@@ -30,7 +37,7 @@
 void Flip(Node * t1, Node * t2, Node * t3)
 {
     Node *s1, *s2, *t4;
-    int R, Temp, Ct2t3, Ct4t1;
+    int R, i, j, Ct2t3, Ct4t1;
 
     assert(t1->Pred == t2 || t1->Suc == t2);
     if (t3 == t2->Pred || t3 == t2->Suc)
@@ -54,21 +61,26 @@ void Flip(Node * t1, Node * t2, Node * t3)
         s1 = t4;
         t4 = t1;
         t1 = s1;
+        R = Dimension - R;
     }
     Ct2t3 = C(t2, t3);
     Ct4t1 = C(t4, t1);
-    /* Swap segment (t3 --> t1) */
-    R = t1->Rank;
-    t1->Suc = 0;
-    s2 = t3;
-    while ((s1 = s2)) {
-        s2 = s1->Suc;
-        s1->Suc = s1->Pred;
-        s1->Pred = s2;
-        s1->Rank = R--;
-        Temp = s1->SucCost;
-        s1->SucCost = s1->PredCost;
-        s1->PredCost = Temp;
+    /* Reverse segment (t3 --> t1), which has R nodes, by swapping the
+       nodes at positions i and j, starting at its ends */
+    i = t3->Rank;
+    j = t1->Rank;
+    for (; R > 0; R -= 2) {
+        s1 = TourOrder[i];
+        s2 = TourOrder[j];
+        (TourOrder[i] = s2)->Rank = i;
+        (TourOrder[j] = s1)->Rank = j;
+        SwapLinks(s1);
+        if (s2 != s1)
+            SwapLinks(s2);
+        if (++i > Dimension)
+            i = 1;
+        if (--j < 1)
+            j = Dimension;
     }
     (t3->Suc = t2)->Pred = t3;
     (t4->Suc = t1)->Pred = t4;
@@ -83,3 +95,16 @@ void Flip(Node * t1, Node * t2, Node * t3)
         (Rand[t3->Id] * Rand[t4->Id]) ^
         (Rand[t2->Id] * Rand[t3->Id]) ^ (Rand[t4->Id] * Rand[t1->Id]);
 }
+
+/* Swap Pred and Suc of a node, together with their costs */
+
+static void SwapLinks(Node * N)
+{
+    Node *Temp = N->Suc;
+    int TempCost = N->SucCost;
+
+    N->Suc = N->Pred;
+    N->Pred = Temp;
+    N->SucCost = N->PredCost;
+    N->PredCost = TempCost;
+}
@@ -1,3 +1,4 @@
+#define THREE_LEVEL_TREE        /* SUC and PRED of the three-level tree */
 #include "Segment.h"
 #include "LKH.h"
 
@@ -0,0 +1,27 @@
+#include "LKH.h"
+
+/*
+ * The FormatInt function writes the decimal representation of v at p,
+ * as fprintf with "%d" would, and returns a pointer to the character
+ * after it. At most 11 characters are written; no terminating null
+ * character is written.
+ *
+ * The function is used for writing large files of integers (tours,
+ * candidate sets and penalties) from a buffer, which is much faster than
+ * calling fprintf for each number.
+ */
+
+char *FormatInt(char *p, int v)
+{
+    char Digits[10], *d = Digits;
+    unsigned int u = v < 0 ? -(unsigned int) v : (unsigned int) v;
+
+    if (v < 0)
+        *p++ = '-';
+    do
+        *d++ = '0' + u % 10;
+    while ((u /= 10) > 0);
+    while (d > Digits)
+        *p++ = *--d;
+    return p;
+}
@@ -1,9 +1,12 @@
 #include "LKH.h"
 #include "Sequence.h"
 #include "Genetic.h"
+#include <sys/mman.h>
 
 /*      
  * The FreeStructures function frees all allocated structures.
+ * A CostMatrix that resides in the memory mapping of a binary problem
+ * file is unmapped.
  */
 
 #define Free(s) { free(s); s = 0; }
@@ -16,19 +19,35 @@ void FreeStructures()
         int i;
         for (i = 1; i <= Dimension; i++) {
             Node *N = &NodeSet[i];
-            Free(N->MergeSuc);
+            Free(ColdNodeSet[i].MergeSuc);
             N->C = 0;
         }
         Free(NodeSet);
+        Free(ColdNodeSet);
     }
-    Free(CostMatrix);
+    Free(XCoord);
+    Free(YCoord);
+    Free(ZCoord);
+    Free(OriginalId);
+    Free(RenumberedId);
+    if (ProblemMap) {
+        munmap(ProblemMap, ProblemMapSize);
+        ProblemMap = 0;
+        CostMatrix = 0;
+    } else
+        Free(CostMatrix);
     Free(BestTour);
     Free(BetterTour);
     Free(SwapStack);
     Free(HTable);
     Free(Rand);
-    Free(CacheSig);
-    Free(CacheVal);
+    Free(Cache);
+    Free(CandidateIndex);
+    Free(BackboneCandidateIndex);
+    CandidateIndexMask = BackboneCandidateIndexMask = 0;
+    CandidateIndexEntries = BackboneCandidateIndexEntries = 0;
+    CandidateIndexValid = 0;
+    CandidateScans = 0;
     Free(Name);
     Free(Type);
     Free(EdgeWeightType);
@@ -72,20 +91,26 @@ void FreeSegments()
         while ((SS = SSPrev) != FirstSSegment);
         FirstSSegment = 0;
     }
+    Free(TourOrder);
 }
 
 /*      
- * The FreeCandidateSets function frees the candidate sets.
+ * The FreeCandidateSets function frees the candidate sets, including
+ * the block of memory that holds them (CandidateArena).
  */
 
 void FreeCandidateSets()
 {
     Node *N = FirstNode;
+    CandidateIndexValid = 0;
     if (!N)
         return;
     do {
-        Free(N->CandidateSet);
-        Free(N->BackboneCandidateSet);
+        ReleaseCandidateSet(N->CandidateSet);
+        ReleaseCandidateSet(N->BackboneCandidateSet);
+        N->CandidateSet = N->BackboneCandidateSet = 0;
     }
     while ((N = N->Suc) != FirstNode);
+    Free(CandidateArena);
+    CandidateArenaSize = 0;
 }
@@ -36,14 +36,21 @@
 
 GainType Gain23()
 {
-    static Node *s1 = 0;
-    static short OldReversed = 0;
+    static THREAD_LOCAL Node *s1 = 0;
+    static THREAD_LOCAL short OldReversed = 0;
+    static THREAD_LOCAL int Resets = 0;
     Node *s2, *s3, *s4, *s5, *s6 = 0, *s7, *s8 = 0, *s1Stop;
     Candidate *Ns2, *Ns4, *Ns6;
     GainType G0, G1, G2, G3, G4, G5, G6, Gain, Gain6;
     int X2, X4, X6, X8, Case6 = 0, Case8 = 0;
     int Breadth2, Breadth4, Breadth6;
 
+    if (Resets != Gain23Resets) {
+        /* Start as in the first call of the thread */
+        s1 = 0;
+        OldReversed = 0;
+        Resets = Gain23Resets;
+    }
     if (!s1 || s1->Subproblem != FirstNode->Subproblem)
         s1 = FirstNode;
     s1Stop = s1;
@@ -56,7 +63,7 @@ GainType Gain23()
             G0 = C(s1, s2);
             Breadth2 = 0;
             /* Choose (s2,s3) as a candidate edge emanating from s2 */
-            for (Ns2 = s2->CandidateSet; (s3 = Ns2->To); Ns2++) {
+            for (Ns2 = s2->CandidateSet; (s3 = CandidateNode(Ns2)); Ns2++) {
                 if (s3 == s2->Pred || s3 == s2->Suc)
                     continue;
                 if (++Breadth2 > MaxBreadth)
@@ -89,7 +96,8 @@ GainType Gain23()
                     /* Try any gainful nonfeasible 3- or 4-opt move 
                        folllowed by a 2-opt move */
                     /* Choose (s4,s5) as a candidate edge emanating from s4 */
-                    for (Ns4 = s4->CandidateSet; (s5 = Ns4->To); Ns4++) {
+                    for (Ns4 = s4->CandidateSet;
+                         (s5 = CandidateNode(Ns4)); Ns4++) {
                         if (s5 == s4->Pred || s5 == s4->Suc ||
                             (G3 = G2 - Ns4->Cost) <= 0)
                             continue;
@@ -139,8 +147,8 @@ GainType Gain23()
                             Breadth6 = 0;
                             /* Choose (s6,s7) as a candidate edge
                                emanating from s6 */
-                            for (Ns6 = s6->CandidateSet; (s7 = Ns6->To);
-                                 Ns6++) {
+                            for (Ns6 = s6->CandidateSet;
+                                 (s7 = CandidateNode(Ns6)); Ns6++) {
                                 if (s7 == s6->Pred || s7 == s6->Suc
                                     || (s6 == s2 && s7 == s3) || (s6 == s3
                                                                   && s7 ==
@@ -27,6 +27,11 @@
  *      An Effective Implementation of the Lin-Kernighan Traveling 
  *      Salesman Heuristic,
  *      Report, RUC, 1998. 
+ *
+ * If THREADS > 1, the Alpha-values are computed by the function
+ * GenerateCandidatesInParallel. This is not done when more than one
+ * merge tour file is given, since IsPossibleCandidate then initializes
+ * node fields on its first call.
  */
 
 static int Max(const int a, const int b)
@@ -53,13 +58,8 @@ void GenerateCandidates(int MaxCandidates, GainType MaxAlpha,
     while ((From = From->Suc) != FirstNode);
 
     if (MaxCandidates > 0) {
-        do { // 为每个Node的CandidateSet指针分配空间
-            assert(From->CandidateSet =
-                   (Candidate *) malloc((MaxCandidates + 1) *
-                                        sizeof(Candidate)));
-            From->CandidateSet[0].To = 0;
-        }
-        while ((From = From->Suc) != FirstNode);
+        // 为每个Node的CandidateSet指针分配空间
+        AllocateCandidateSets(MaxCandidates + 1);
     } else { // 否则的话通过读入文件将候选集写入
         AddTourCandidates();
         do {
@@ -69,6 +69,11 @@ void GenerateCandidates(int MaxCandidates, GainType MaxAlpha,
         return;
     }
 
+    if (Threads > 1 && MergeTourFiles < 2) {
+        GenerateCandidatesInParallel(MaxCandidates, MaxAlpha);
+        goto End_GenerateCandidates;
+    }
+
     /* Loop for each node, From */
     do { // 这个do while 相当于论文中的外层for循环，用于以From指针从FirstNode按拓补顺序开始遍历最小生成树
         NFrom = From->CandidateSet;
@@ -141,7 +146,7 @@ void GenerateCandidates(int MaxCandidates, GainType MaxAlpha,
                     *(NN + 1) = *NN;
                 }
                 NN++;
-                NN->To = To;
+                NN->To = To->Id;
                 NN->Cost = d;
                 NN->Alpha = a;
                 if (Count < MaxCandidates) {
@@ -155,6 +160,7 @@ void GenerateCandidates(int MaxCandidates, GainType MaxAlpha,
     }
     while ((From = From->Suc) != FirstNode);
 
+  End_GenerateCandidates:
     AddTourCandidates();
     if (Symmetric)
         SymmetrizeCandidateSet();
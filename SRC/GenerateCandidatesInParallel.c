@@ -0,0 +1,191 @@
+#include "LKH.h"
+#include <pthread.h>
+
+/*
+ * The GenerateCandidatesInParallel function computes the candidate sets
+ * of GenerateCandidates on a number of worker threads (THREADS). It is
+ * called by GenerateCandidates after the candidate sets have been
+ * allocated.
+ *
+ * For a fixed 1-tree the Alpha-values of the edges incident to a node,
+ * From, can be computed independently of those of the other nodes. The
+ * only shared state used by the sequential algorithm is the Beta and Mark
+ * fields of the nodes. Therefore, each worker keeps its own Beta and Mark
+ * arrays, indexed by node Id, and the From nodes are handed out to the
+ * workers in chunks of consecutive nodes. A worker inserts the candidates
+ * directly into the candidate set of its From node, which is not touched
+ * by any other worker.
+ *
+ * The candidate sets computed are identical to those computed by the
+ * sequential algorithm.
+ */
+
+#define ChunkSize 16    /* Number of From nodes handed out at a time */
+
+/* The state shared by the workers of one call of
+   GenerateCandidatesInParallel */
+typedef struct CandidateWork {
+    LKHContext *MainContext;    /* Context of the calling thread */
+    Node **FromNode;    /* The nodes in topological order */
+    int Nodes;          /* Number of nodes in FromNode */
+    int MaxId;          /* Largest Id of a node */
+    int NextFrom;       /* Index in FromNode of the next chunk */
+    int MaxCandidates;
+    GainType MaxAlpha;
+    pthread_mutex_t Lock;
+} CandidateWork;
+
+static void *Worker(void *Arg);
+
+static int Max(const int a, const int b)
+{
+    return a > b ? a : b;
+}
+
+void GenerateCandidatesInParallel(int MaxCandidates, GainType MaxAlpha)
+{
+    pthread_t *Thread;
+    CandidateWork W;
+    Node *N;
+    int i, Workers;
+
+    W.MaxCandidates = MaxCandidates;
+    W.MaxAlpha = MaxAlpha;
+    W.Nodes = W.MaxId = 0;
+    N = FirstNode;
+    do {
+        W.Nodes++;
+        if (N->Id > W.MaxId)
+            W.MaxId = N->Id;
+    } while ((N = N->Suc) != FirstNode);
+    assert(W.FromNode = (Node **) malloc(W.Nodes * sizeof(Node *)));
+    i = 0;
+    do
+        W.FromNode[i++] = N;
+    while ((N = N->Suc) != FirstNode);
+    W.NextFrom = 0;
+    Workers = (W.Nodes + ChunkSize - 1) / ChunkSize;
+    if (Workers > Threads)
+        Workers = Threads;
+    assert(Thread = (pthread_t *) malloc(Workers * sizeof(pthread_t)));
+    pthread_mutex_init(&W.Lock, 0);
+    W.MainContext = SaveContext();
+    for (i = 0; i < Workers; i++)
+        if (pthread_create(&Thread[i], 0, Worker, &W))
+            eprintf("Cannot create thread %d", i + 1);
+    for (i = 0; i < Workers; i++)
+        pthread_join(Thread[i], 0);
+    FreeContext(W.MainContext);
+    pthread_mutex_destroy(&W.Lock);
+    free(Thread);
+    free(W.FromNode);
+}
+
+static void *Worker(void *Arg)
+{
+    Node *From, *To;
+    Candidate *NFrom, *NN;
+    int *Beta, *Mark;
+    CandidateWork *W = (CandidateWork *) Arg;
+    int a, d, Count, i, Last, MaxCandidates = W->MaxCandidates;
+    GainType MaxAlpha = W->MaxAlpha;
+
+    LoadContext(W->MainContext);
+    assert(Beta = (int *) malloc((W->MaxId + 1) * sizeof(int)));
+    assert(Mark = (int *) calloc(W->MaxId + 1, sizeof(int)));
+    for (;;) {
+        pthread_mutex_lock(&W->Lock);
+        i = W->NextFrom;
+        W->NextFrom += ChunkSize;
+        pthread_mutex_unlock(&W->Lock);
+        if (i >= W->Nodes)
+            break;
+        if ((Last = i + ChunkSize) > W->Nodes)
+            Last = W->Nodes;
+        for (; i < Last; i++) {
+            From = W->FromNode[i];
+            NFrom = From->CandidateSet;
+            if (From != FirstNode) {
+                Beta[From->Id] = INT_MIN;
+                for (To = From; To->Dad != 0; To = To->Dad) {
+                    Beta[To->Dad->Id] =
+                        !FixedOrCommon(To, To->Dad) ?
+                        Max(Beta[To->Id], To->Cost) : Beta[To->Id];
+                    Mark[To->Dad->Id] = From->Id;
+                }
+            }
+            Count = 0;
+            To = FirstNode;
+            do {
+                if (To == From)
+                    continue;
+                d = c && !FixedOrCommon(From, To) ? c(From, To) :
+                    D(From, To);
+                if (From == FirstNode)
+                    a = To == From->Dad ? 0 : d - From->NextCost;
+                else if (To == FirstNode)
+                    a = From == To->Dad ? 0 : d - To->NextCost;
+                else {
+                    if (Mark[To->Id] != From->Id)
+                        Beta[To->Id] =
+                            !FixedOrCommon(To, To->Dad) ?
+                            Max(Beta[To->Dad->Id], To->Cost) :
+                            Beta[To->Dad->Id];
+                    a = d - Beta[To->Id];
+                }
+                if (FixedOrCommon(From, To))
+                    a = INT_MIN;
+                else {
+                    if (From->FixedTo2 || To->FixedTo2 ||
+                        Forbidden(From, To))
+                        continue;
+                    if (InInputTour(From, To)) {
+                        a = 0;
+                        if (c)
+                            d = D(From, To);
+                    } else if (c) {
+                        if (a > MaxAlpha ||
+                            (Count == MaxCandidates &&
+                             (a > (NFrom - 1)->Alpha ||
+                              (a == (NFrom - 1)->Alpha
+                               && d >= (NFrom - 1)->Cost))))
+                            continue;
+                        if (To == From->Dad) {
+                            d = From->Cost;
+                            a = 0;
+                        } else if (From == To->Dad) {
+                            d = To->Cost;
+                            a = 0;
+                        } else {
+                            a -= d;
+                            a += (d = D(From, To));
+                        }
+                    }
+                }
+                if (a <= MaxAlpha && IsPossibleCandidate(From, To)) {
+                    /* Insert new candidate edge in From->CandidateSet */
+                    NN = NFrom;
+                    while (--NN >= From->CandidateSet) {
+                        if (a > NN->Alpha ||
+                            (a == NN->Alpha && d >= NN->Cost))
+                            break;
+                        *(NN + 1) = *NN;
+                    }
+                    NN++;
+                    NN->To = To->Id;
+                    NN->Cost = d;
+                    NN->Alpha = a;
+                    if (Count < MaxCandidates) {
+                        Count++;
+                        NFrom++;
+                    }
+                    NFrom->To = 0;
+                }
+            }
+            while ((To = To->Suc) != FirstNode);
+        }
+    }
+    free(Beta);
+    free(Mark);
+    return Arg;
+}
@@ -1,6 +1,6 @@
-#define HAVE_GETRUSAGE
-/* Undefine if you don't have the getrusage function */
-/* #undef HAVE_GETRUSAGE */
+#define HAVE_CLOCK_GETTIME
+/* Undefine if you don't have the clock_gettime function */
+/* #undef HAVE_CLOCK_GETTIME */
 
 /*
  * The GetTime function is used to measure execution time.
@@ -10,19 +10,21 @@
  * first call gives the number of seconds spent in executing
  * the code.
  *
- * If the system call getrusage() is supported, the difference 
- * gives the user time used; otherwise, the accounted real time.
+ * If the system call clock_gettime() is supported, the difference 
+ * gives the elapsed (wall-clock) time; otherwise, the accounted 
+ * processor time. Elapsed time is used, since the work of a run may be
+ * shared among several threads (see TRIAL_THREADS), so that the
+ * processor time of the calling thread alone would not account for it.
  */
 
-#ifdef HAVE_GETRUSAGE
-#include <sys/time.h>
-#include <sys/resource.h>
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h>
 
 double GetTime()
 {
-    struct rusage ru;
-    getrusage(RUSAGE_SELF, &ru);
-    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1000000.0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
 }
 
 #else
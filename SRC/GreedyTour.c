@@ -41,8 +41,8 @@ static void RemoveFromList(Node * N, Node ** First);
 static int compareX(const void *Na, const void *Nb);
 static int compareCost(const void *Na, const void *Nb);
 
-static int EdgesInFragments;
-static GainType Cost;
+static THREAD_LOCAL int EdgesInFragments;
+static THREAD_LOCAL GainType Cost;
 
 GainType GreedyTour()
 {
@@ -256,14 +256,14 @@ GainType GreedyTour()
 
 static Node *NearestNeighbor(Node * From)
 {
-    static int mark = 0;
+    static THREAD_LOCAL int mark = 0;
     Candidate *NN;
     Node *To, *N, *First = 0, *Last = 0, *Nearest = 0;
     int MaxLevel = Dimension, Min = INT_MAX, d;
 
     if (From->Degree == 2)
         return 0;
-    for (NN = From->CandidateSet; (To = NN->To); NN++) {
+    for (NN = From->CandidateSet; (To = CandidateNode(NN)); NN++) {
         if (FixedOrCommon(From, To) && MayBeAddedToFragments(From, To)) {
             From->Cost = NN->Cost;
             return To;
@@ -283,7 +283,7 @@ static Node *NearestNeighbor(Node * From)
             First = Last = 0;
         else
             First = N->OldSuc;
-        for (NN = N->CandidateSet; (To = NN->To); NN++) {
+        for (NN = N->CandidateSet; (To = CandidateNode(NN)); NN++) {
             if (To->Mark != mark) {
                 To->Mark = mark;
                 To->Level = N->Level + 1;
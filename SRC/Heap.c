@@ -12,8 +12,8 @@
  * to the current tree). 
  */
 
-static int HeapCount;    /* Its current number of elements */
-static int HeapCapacity; /* Its capacity */
+static THREAD_LOCAL int HeapCount;    /* Its current number of elements */
+static THREAD_LOCAL int HeapCapacity; /* Its capacity */
 
 /*      
  * The MakeHeap function creates an empty heap. 
@@ -7,13 +7,13 @@
 
 typedef void (*CrossoverFunction) ();
 
-int MaxPopulationSize; /* The maximum size of the population */ 
-int PopulationSize;    /* The current size of the population */
+GLOBAL int MaxPopulationSize; /* The maximum size of the population */ 
+GLOBAL int PopulationSize;    /* The current size of the population */
 
-CrossoverFunction Crossover;
+GLOBAL CrossoverFunction Crossover;
 
-int **Population;      /* Array of individuals (solution tours) */
-GainType *Fitness;     /* The fitness (tour cost) of each individual */
+GLOBAL int **Population;      /* Array of individuals (solution tours) */
+GLOBAL GainType *Fitness;     /* The fitness (tour cost) of each individual */
 
 void AddToPopulation(GainType Cost);
 void ApplyCrossover(int i, int j);
@@ -23,14 +23,15 @@
 
 #define Fixed(a, b) ((a)->FixedTo1 == (b) || (a)->FixedTo2 == (b)) // 这个方法貌似可以判断是否给定了某条边必须走的的时候，即是否有固定边
 #define FixedOrCommon(a, b) (Fixed(a, b) || IsCommonEdge(a, b))
-#define InBestTour(a, b) ((a)->BestSuc == (b) || (b)->BestSuc == (a))
+#define InBestTour(a, b) (Cold(a)->BestSuc == (b) || Cold(b)->BestSuc == (a))
 #define InNextBestTour(a, b)\
-    ((a)->NextBestSuc == (b) || (b)->NextBestSuc == (a))
-#define InInputTour(a, b) ((a)->InputSuc == (b) || (b)->InputSuc == (a))
+    (Cold(a)->NextBestSuc == (b) || Cold(b)->NextBestSuc == (a))
+#define InInputTour(a, b)\
+    (Cold(a)->InputSuc == (b) || Cold(b)->InputSuc == (a))
 #define InInitialTour(a, b)\
-    ((a)->InitialSuc == (b) || (b)->InitialSuc == (a))
+    (Cold(a)->InitialSuc == (b) || Cold(b)->InitialSuc == (a))
 #define Near(a, b)\
-    ((a)->BestSuc ? InBestTour(a, b) : (a)->Dad == (b) || (b)->Dad == (a))
+    (Cold(a)->BestSuc ? InBestTour(a, b) : (a)->Dad == (b) || (b)->Dad == (a))
 
 #define Link(a, b) { ((a)->Suc = (b))->Pred = (a); }
 // Follow(b,a)的意义是将节点b连接到节点a的直接后继，节点a、b之间和节点b之后其他部分的节点的相对顺序不变，并连接到节点b后
@@ -41,6 +42,36 @@
     { Link((a)->Pred, (a)->Suc); Link(a, a); Link((b)->Pred, a); Link(a, b); }
 #define SLink(a, b) { (a)->Suc = (b); (b)->Pred = (a); }
 
+/* StoreCoordinates(N) copies the coordinates of node N into the arrays
+   XCoord, YCoord and ZCoord. It must be used whenever the X, Y or Z field
+   of a node in NodeSet is changed */
+#define StoreCoordinates(N)\
+    (XCoord[(N)->Id] = (N)->X, YCoord[(N)->Id] = (N)->Y,\
+     ZCoord[(N)->Id] = (N)->Z)
+
+/* InternalId(i) is the Id of the node that has number i in the input
+   files, and ExternalId(Id) is the number in the input files of the node
+   with the given Id. They differ only if the nodes have been renumbered
+   (see RenumberNodes) */
+#define InternalId(i) (RenumberedId ? RenumberedId[i] : (i))
+#define ExternalId(Id) (OriginalId ? OriginalId[Id] : (Id))
+
+/* CACHE_ALIGNED aligns a structure type, and rounds up its size, to a
+   multiple of the cache line size, CacheLineSize. Arrays of such
+   structures must be allocated by AllocateNodes */
+#define CacheLineSize 64
+#if defined(__GNUC__)
+#define CACHE_ALIGNED __attribute__ ((aligned(CacheLineSize)))
+#else
+#define CACHE_ALIGNED
+#endif
+
+#define CacheWays 4     /* Number of entries in each set of the distance
+                           cache */
+
+#define DistanceBatchSize 64    /* Number of distances computed at a time
+                                   by the dense scans (see DistanceBatch) */
+
 enum Types { TSP, ATSP, SOP, HCP, CVRP, TOUR, HPP };
 enum CoordTypes { TWOD_COORDS, THREED_COORDS, NO_COORDS };
 enum EdgeWeightTypes { EXPLICIT, EUC_2D, EUC_3D, MAX_2D, MAX_3D, MAN_2D,
@@ -55,62 +86,126 @@ enum CandidateSetTypes { ALPHA, DELAUNAY, NN, QUADRANT };
 enum InitialTourAlgorithms { BORUVKA, GREEDY, MOORE, NEAREST_NEIGHBOR,
     QUICK_BORUVKA, SIERPINSKI, WALK
 };
+enum TreeTypes { ONE_LEVEL, TWO_LEVEL, THREE_LEVEL };
+
+/* The header of the BINARY_SECTION of a problem file consists of the
+   following fields, each a little-endian 64-bit integer (see ReadProblem
+   and WriteBinaryProblem) */
+enum BinaryHeaderFields { BINARY_MAGIC, BINARY_DIMENSION,
+    BINARY_COORDINATES, BINARY_COORDINATE_OFFSET,
+    BINARY_WEIGHTS, BINARY_WEIGHT_OFFSET, BINARY_MAX_WEIGHT,
+    BINARY_MAX_OFF_DIAGONAL_WEIGHT, BINARY_FIXED_EDGES,
+    BINARY_FIXED_EDGE_OFFSET, BINARY_END, BINARY_HEADER_FIELDS
+};
+#define BinaryMagic "LKHBIN01"  /* The first 8 bytes of the header */
+
+/* A CANDIDATE_FILE or a PI_FILE in binary form starts with a header of
+   the following fields, each a little-endian 64-bit integer (see
+   WriteCandidates and WritePenalties) */
+enum CandidateHeaderFields { CANDIDATE_MAGIC, CANDIDATE_DIMENSION,
+    CANDIDATE_EDGES, CANDIDATE_HEADER_FIELDS
+};
+#define CandidateMagic "LKHCAN01"
+enum PenaltyHeaderFields { PENALTY_MAGIC, PENALTY_DIMENSION,
+    PENALTY_HEADER_FIELDS
+};
+#define PenaltyMagic "LKHPEN01"
 
 typedef struct Node Node;
+typedef struct ColdNode ColdNode;
 typedef struct Candidate Candidate;
 typedef struct Segment Segment;
 typedef struct SSegment SSegment;
 typedef struct SwapRecord SwapRecord;
+typedef struct CacheEntry CacheEntry;
+typedef struct CacheCounts CacheCounts;
+typedef struct IndexEntry IndexEntry;
 // 定义一个函数指针别名MoveFunction，该函数接受两个Node指针，两个GainType指针，返回指向Node的指针
 typedef Node *(*MoveFunction) (Node * t1, Node * t2, GainType * G0,
                                GainType * Gain);
 // 定义一个函数指针别名CostFunction，该函数接受两个Node指针，返回int
 typedef int (*CostFunction) (Node * Na, Node * Nb);
+typedef GainType(*GainFunction) (void);
+typedef void (*TreeFunction) (int Sparse);
+typedef const char *(*SectionParser) (const char *Begin, const char *End,
+                                      long long FirstToken,
+                                      long long Tokens, void *Arg,
+                                      int Worker);
 
 /* The Node structure is used to represent nodes (cities) of the problem */
 
 struct Node {
+    /* The fields below are grouped by use. The first two cache lines hold
+       the fields accessed in the inner loops of the Lin-Kernighan search
+       (tour navigation, candidate sets, submove bookkeeping and costs),
+       the next two the list of active nodes, the coordinates and the
+       fields used during the ascent. The fields used only when the
+       problem is set up or partitioned, or tours are read or merged, are
+       kept apart in a ColdNode (see Cold) */
+    Node *Pred, *Suc;  /* Predecessor and successor node in 
+                          the two-way list of nodes */
+    Segment *Parent;   /* Parent segment of a node when the two-level
+                          tree representation is used */
+    Candidate *CandidateSet;    /* Candidate array */
     int Id;     /* Number of the node (1...Dimension) */
-    int Loc;    /* Location of the node in the heap 
-                   (zero, if the node is not in the heap) */
     int Rank;   /* During the ascent, the priority of the node.
                    Otherwise, the ordinal number of the node in 
                    the tour */
     int V;      /* During the ascent the degree of the node minus 2.
                    Otherwise, the variable is used to mark nodes */
+    int Pi;     /* Pi-value of the node */
+    Node *OldPred, *OldSuc; /* Previous values of Pred and Suc */
+    Node *Added1, *Added2; /* Pointers to the opposite end nodes
+                              of added edges in a submove */
+    Node *Deleted1, *Deleted2;  /* Pointers to the opposite end nodes
+                                   of deleted edges in a submove */
+    Node *FixedTo1,    /* Pointers to the opposite end nodes of fixed edges. */
+         *FixedTo2;    /* A maximum of two fixed edges can be incident
+                          to a node */
+    int *C;     /* A row in the cost matrix */
+    int PredCost, /* The costs of the neighbor edges on the current tour */ 
+        SucCost; 
+    Node *Next; /* Auxiliary pointer, usually to the next node in a list
+                   of nodes (e.g., the list of "active" nodes) */
+    Node *Prev; /* Auxiliary pointer, usually to the previous node 
+                   in a list of nodes */
+    char OldPredExcluded, OldSucExcluded;  /* Booleans used for indicating 
+                                              whether one (or both) of the 
+                                              adjoining nodes on the old tour 
+                                              has been excluded */
+    char Axis;  /* The axis partitioned when the node is part of a KDTree */
+    int Subproblem;  /* Number of the subproblem the node is part of */
+    double X, Y, Z;     /* Coordinates of the node */
+    Node *Dad;  /* Father of the node in the minimum 1-tree */
+    Node *Mark; /* Visited mark */
+    Node *Nearest;     /* Nearest node (used in the greedy heuristics) */
+    int Loc;    /* Location of the node in the heap 
+                   (zero, if the node is not in the heap) */
     int LastV;  /* Last value of V during the ascent */
     int Cost;   /* "Best" cost of an edge emanating from the node */
     int NextCost; /* During the ascent, the next best cost of an edge
                      emanating from the node */
-    int PredCost, /* The costs of the neighbor edges on the current tour */ 
-        SucCost; 
-    int SavedCost;
-    int Pi;     /* Pi-value of the node */
     int BestPi; /* Currently best pi-value found during the ascent */
     int Beta;   /* Beta-value (used for computing alpha-values) */
-    int Subproblem;  /* Number of the subproblem the node is part of */
     int Sons;   /* Number of sons in the minimum spanning tree */
-    int *C;     /* A row in the cost matrix */
-    Node *Pred, *Suc;  /* Predecessor and successor node in 
-                          the two-way list of nodes */
-    Node *OldPred, *OldSuc; /* Previous values of Pred and Suc */
+    int SavedCost;
+    Node *Head; /* Head of a segment of common edges */
+    Node *Tail; /* Tail of a segment of common edges */
+    Candidate *BackboneCandidateSet; /* Backbone candidate array */
+} CACHE_ALIGNED;
+
+/* The fields of a node that are used only when the problem is set up or
+   partitioned into subproblems, or tours are read, recorded or merged,
+   are kept in a ColdNode. The ColdNodes are kept in the array
+   ColdNodeSet, which is indexed by Id like NodeSet, so that they do not
+   take up space in the cache lines of the nodes during the search.
+   Cold(N) is the ColdNode of node N */
+
+struct ColdNode {
     Node *BestSuc,     /* Best and next best successor node in the */
          *NextBestSuc; /* currently best tour */
-    Node *Dad;  /* Father of the node in the minimum 1-tree */
-    Node *Nearest;     /* Nearest node (used in the greedy heuristics) */
-    // Next 指针作用之一是在1-tree生成中，指向特殊Node-1新增边的终点
-    Node *Next; /* Auxiliary pointer, usually to the next node in a list
-                   of nodes (e.g., the list of "active" nodes) */
-    Node *Prev; /* Auxiliary pointer, usually to the previous node 
-                   in a list of nodes */
-    Node *Mark; /* Visited mark */
-    Node *FixedTo1,    /* Pointers to the opposite end nodes of fixed edges. */
-         *FixedTo2;    /* A maximum of two fixed edges can be incident
-                          to a node */
     Node *FixedTo1Saved, /* Saved values of FixedTo1 and FixedTo2 */
          *FixedTo2Saved;
-    Node *Head; /* Head of a segment of common edges */
-    Node *Tail; /* Tail of a segment of common edges */
     Node *InputSuc;    /* Successor in the INPUT_TOUR file */
     Node *InitialSuc;  /* Successor in the INITIAL_TOUR file */
     Node *SubproblemPred; /* Predecessor in the SUBPROBLEM_TOUR file */
@@ -118,31 +213,26 @@ struct Node {
     Node *SubBestPred; /* The best predecessor node in a subproblem */
     Node *SubBestSuc;  /* The best successor node in a subproblem */
     Node **MergeSuc;   /* Successors in the MERGE_TOUR files */
-    Node *Added1, *Added2; /* Pointers to the opposite end nodes
-                              of added edges in a submove */
-    Node *Deleted1, *Deleted2;  /* Pointers to the opposite end nodes
-                                   of deleted edges in a submove */
-    Candidate *CandidateSet;    /* Candidate array */
-    Candidate *BackboneCandidateSet; /* Backbone candidate array */
-    Segment *Parent;   /* Parent segment of a node when the two-level
-                          tree representation is used */
-    double X, Y, Z;     /* Coordinates of the node */
     double Xc, Yc, Zc;  /* Converted coordinates */
-    char Axis;  /* The axis partitioned when the node is part of a KDTree */
-    char OldPredExcluded, OldSucExcluded;  /* Booleans used for indicating 
-                                              whether one (or both) of the 
-                                              adjoining nodes on the old tour 
-                                              has been excluded */
 };
 
-/* The Candidate structure is used to represent candidate edges */
+#define Cold(N) (&ColdNodeSet[(N)->Id])
+
+/* The Candidate structure is used to represent candidate edges. The end
+   node is given by its Id (an index in NodeSet), so that an entry takes
+   12 bytes and stays valid in the private node copies of worker threads.
+   A candidate set is terminated by an entry with To equal to zero */
 
 struct Candidate {
-    Node *To;   /* The end node of the edge */
+    int To;     /* Id of the end node of the edge */
     int Cost;   /* Cost (distance) of the edge */
     int Alpha;  /* Its alpha-value */
 };
 
+/* CandidateNode(C) is the end node of candidate C, or 0 if C is the
+   terminating entry of its candidate set */
+#define CandidateNode(C) ((C)->To ? &NodeSet[(C)->To] : 0)
+
 /* The Segment structure is used to represent the segments in the two-level 
    representation of tours */
 
@@ -171,127 +261,237 @@ struct SwapRecord {
     Node *t1, *t2, *t3, *t4;    /* The 4 nodes involved in a 2-opt move */
 };
 
-int AscentCandidates;   /* Number of candidate edges to be associated
-                           with each node during the ascent */
-int BackboneTrials;     /* Number of backbone trials in each run */
-int Backtracking;       /* Specifies whether backtracking is used for 
-                           the first move in a sequence of moves */
-GainType BestCost;      /* Cost of the tour in BestTour */
-int *BestTour;  /* Table containing best tour found */
-GainType BetterCost;    /* Cost of the tour stored in BetterTour */
-int *BetterTour;        /* Table containing the currently best tour 
-                           in a run */
-int CacheMask;  /* Mask for indexing the cache */
-int *CacheVal;  /* Table of cached distances */
-int *CacheSig;  /* Table of the signatures of cached 
-                   distances */
-int CandidateFiles;     /* Number of CANDIDATE_FILEs */
-int *CostMatrix;        /* Cost matrix */
-int Dimension;  /* Number of nodes in the problem */
-int DimensionSaved;     /* Saved value of Dimension */
-double Excess;  /* Maximum alpha-value allowed for any 
-                   candidate edge is set to Excess times the 
-                   absolute value of the lower bound of a 
-                   solution tour */
-int ExtraCandidates;    /* Number of extra neighbors to be added to 
-                           the candidate set of each node */
-Node *FirstActive, *LastActive; /* First and last node in the list 
-                                   of "active" nodes */
-Node *FirstNode;        /* First node in the list of nodes */
-Segment *FirstSegment;  /* A pointer to the first segment in the cyclic 
-                           list of segments */
-SSegment *FirstSSegment;        /* A pointer to the first super segment in
-                                   the cyclic list of segments */
-int Gain23Used; /* Specifies whether Gain23 is used */
-int GainCriterionUsed;  /* Specifies whether L&K's gain criterion is 
-                           used */
-int GroupSize;  /* Desired initial size of each segment */
-int SGroupSize; /* Desired initial size of each super segment */
-int Groups;     /* Current number of segments */
-int SGroups;    /* Current number of super segments */
-unsigned Hash;  /* Hash value corresponding to the current tour */
-Node **Heap;    /* Heap used for computing minimum spanning 
-                   trees */
-HashTable *HTable;      /* Hash table used for storing tours */
-int InitialPeriod;      /* Length of the first period in the ascent */
-int InitialStepSize;    /* Initial step size used in the ascent */
-double InitialTourFraction;     /* Fraction of the initial tour to be 
-                                   constructed by INITIAL_TOUR_FILE edges */
-char *LastLine; /* Last input line */
-double LowerBound;      /* Lower bound found by the ascent */
-int Kicks;      /* Specifies the number of K-swap-kicks */
-int KickType;   /* Specifies K for a K-swap-kick */
-int M;          /* The M-value is used when solving an ATSP-
-                   instance by transforming it to a STSP-instance */
-int MaxBreadth; /* The maximum number of candidate edges 
-                   considered at each level of the search for
-                   a move */
-int MaxCandidates;      /* Maximum number of candidate edges to be 
-                           associated with each node */
-int MaxMatrixDimension; /* Maximum dimension for an explicit cost matrix */
-int MaxSwaps;   /* Maximum number of swaps made during the 
-                   search for a move */
-int MaxTrials;  /* Maximum number of trials in each run */
-int MergeTourFiles;     /* Number of MERGE_TOUR_FILEs */
-int MoveType;   /* Specifies the sequantial move type to be used 
-                   in local search. A value K >= 2 signifies 
-                   that a k-opt moves are tried for k <= K */
-Node *NodeSet;  /* Array of all nodes */
-int Norm;       /* Measure of a 1-tree's discrepancy from a tour */
-int NonsequentialMoveType;      /* Specifies the nonsequential move type to
-                                   be used in local search. A value 
-                                   L >= 4 signifies that nonsequential
-                                   l-opt moves are tried for l <= L */
-GainType Optimum;       /* Known optimal tour length. 
-                           If StopAtOptimum is 1, a run will be 
-                           terminated as soon as a tour length 
-                           becomes equal this value */
-int PatchingA;  /* Specifies the maximum number of alternating
-                   cycles to be used for patching disjoint cycles */
-int PatchingC;  /* Specifies the maximum number of disjoint cycles to be 
-                   patched (by one or more alternating cycles) */
-int Precision;  /* Internal precision in the representation of 
-                   transformed distances */
-int PredSucCostAvailable; /* PredCost and SucCost are available */
-unsigned *Rand; /* Table of random values */
-int RestrictedSearch;   /* Specifies whether the choice of the first 
-                           edge to be broken is restricted */
-short Reversed; /* Boolean used to indicate whether a tour has 
-                   been reversed */
-int Run; /* Current run number */
-int Runs;       /* Total number of runs */
-unsigned Seed;  /* Initial seed for random number generation */
-int StopAtOptimum;      /* Specifies whether a run will be terminated if 
-                           the tour length becomes equal to Optimum */
-int Subgradient;        /* Specifies whether the Pi-values should be 
-                           determined by subgradient optimization */
-int SubproblemSize;     /* Number of nodes in a subproblem */
-int SubsequentMoveType; /* Specifies the move type to be used for all 
-                           moves following the first move in a sequence 
-                           of moves. The value K >= 2 signifies that a 
-                           K-opt move is to be used */
-int SubsequentPatching; /* Species whether patching is used for 
-                           subsequent moves */
-SwapRecord *SwapStack;  /* Stack of SwapRecords */
-int Swaps;      /* Number of swaps made during a tentative move */
-double TimeLimit;       /* The time limit in seconds for each run */
-int TraceLevel; /* Specifies the level of detail of the output 
-                   given during the solution process. 
-                   The value 0 signifies a minimum amount of 
-                   output. The higher the value is the more 
-                   information is given */
-int Trial;      /* Ordinal number of the current trial */
+/* The CacheEntry structure is used to represent the entries of the cache
+   of computed distances (see C_FUNCTION) */
+
+struct CacheEntry {
+    int Id1, Id2;  /* The Ids of the end nodes of the edge (Id1 < Id2).
+                      Id1 is zero, if the entry is unused */
+    int Cost;      /* The distance, D(Id1, Id2), of the edge */
+};
+
+/* The CacheCounts structure is used by a worker thread to hand its cache
+   statistics over to the thread that joins it (see TakeCacheCounts) */
+
+struct CacheCounts {
+    GainType Hits, Misses, Evictions;
+};
+
+/* The IndexEntry structure is used to represent the entries of the hash
+   table of candidate edges (see IndexCandidateSets) */
+
+struct IndexEntry {
+    int From;      /* The Id of the node the candidate edge emanates from.
+                      From is zero, if the entry is unused */
+    int Position;  /* The position of the edge in the candidate array
+                      of From */
+};
+
+/*
+ * The solver state is kept in thread-local storage. Each thread that calls
+ * the functions of the program operates on its own copy of the variables
+ * below, so that independent solves may run concurrently in the same
+ * process. The variables are defined in Context.c, which also provides
+ * the LKHContext type for transferring the state between threads.
+ */
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#ifdef DEFINE_GLOBALS
+#define GLOBAL THREAD_LOCAL
+#else
+#define GLOBAL extern THREAD_LOCAL
+#endif
+
+typedef struct LKHContext LKHContext;
+
+GLOBAL int AscentCandidates;   /* Number of candidate edges to be associated
+                                  with each node during the ascent */
+GLOBAL IndexEntry *BackboneCandidateIndex;     /* Hash table of backbone
+                                                  candidate edges */
+GLOBAL int BackboneCandidateIndexMask; /* Mask for indexing
+                                          BackboneCandidateIndex */
+GLOBAL int BackboneCandidateIndexEntries;      /* Number of edges in
+                                                  BackboneCandidateIndex */
+GLOBAL int BackboneTrials;     /* Number of backbone trials in each run */
+GLOBAL int Backtracking;       /* Specifies whether backtracking is used for 
+                                  the first move in a sequence of moves */
+GLOBAL GainType BestCost;      /* Cost of the tour in BestTour */
+GLOBAL int *BestTour;  /* Table containing best tour found */
+GLOBAL GainType BetterCost;    /* Cost of the tour stored in BetterTour */
+GLOBAL int *BetterTour;        /* Table containing the currently best tour 
+                                  in a run */
+GLOBAL CacheEntry *Cache;      /* Cache of computed distances, organized
+                                  as CacheMask + 1 sets of CacheWays
+                                  entries */
+GLOBAL int CacheMask;  /* Mask for indexing the sets of the cache */
+GLOBAL GainType CacheHits, CacheMisses, CacheEvictions; /* Cache statistics */
+GLOBAL Candidate *CandidateArena;      /* Block of memory holding the
+                                          candidate sets of the nodes */
+GLOBAL long CandidateArenaSize;        /* Number of entries in
+                                          CandidateArena */
+GLOBAL int CandidateFiles;     /* Number of CANDIDATE_FILEs */
+GLOBAL IndexEntry *CandidateIndex;     /* Hash table of candidate edges */
+GLOBAL int CandidateIndexMask; /* Mask for indexing CandidateIndex */
+GLOBAL int CandidateIndexEntries;      /* Number of edges in
+                                          CandidateIndex */
+GLOBAL int CandidateIndexValid;        /* Specifies whether CandidateIndex
+                                          and BackboneCandidateIndex
+                                          reflect the candidate sets */
+GLOBAL GainType CandidateScans;        /* Number of scans of candidate
+                                          arrays since the hash tables
+                                          were built */
+GLOBAL ColdNode *ColdNodeSet; /* Array of the cold fields of all nodes,
+                                 indexed by Id */
+GLOBAL int *CostMatrix;        /* Cost matrix */
+GLOBAL char *ProblemMap;       /* Memory mapping of a binary PROBLEM_FILE
+                                  that holds CostMatrix, or 0 */
+GLOBAL size_t ProblemMapSize;  /* Size of ProblemMap */
+GLOBAL int Dimension;  /* Number of nodes in the problem */
+GLOBAL int DimensionSaved;     /* Saved value of Dimension */
+GLOBAL int DistanceCacheSize;  /* Number of entries in the cache of computed 
+                                  distances */
+GLOBAL double Excess;  /* Maximum alpha-value allowed for any 
+                          candidate edge is set to Excess times the 
+                          absolute value of the lower bound of a 
+                          solution tour */
+GLOBAL int ExtraCandidates;    /* Number of extra neighbors to be added to 
+                                  the candidate set of each node */
+GLOBAL Node *FirstActive, *LastActive; /* First and last node in the list 
+                                          of "active" nodes */
+GLOBAL Node *FirstNode;        /* First node in the list of nodes */
+GLOBAL Segment *FirstSegment;  /* A pointer to the first segment in the cyclic 
+                                  list of segments */
+GLOBAL SSegment *FirstSSegment;        /* A pointer to the first super segment in
+                                          the cyclic list of segments */
+GLOBAL int Gain23Used; /* Specifies whether Gain23 is used */
+GLOBAL int Gain23Resets;       /* Incremented to make Gain23 forget the
+                                  state kept from its earlier calls */
+GLOBAL int GainCriterionUsed;  /* Specifies whether L&K's gain criterion is 
+                                  used */
+GLOBAL int GroupSize;  /* Desired initial size of each segment */
+GLOBAL int SGroupSize; /* Desired initial size of each super segment */
+GLOBAL int Groups;     /* Current number of segments */
+GLOBAL int SGroups;    /* Current number of super segments */
+GLOBAL unsigned Hash;  /* Hash value corresponding to the current tour */
+GLOBAL Node **Heap;    /* Heap used for computing minimum spanning 
+                          trees */
+GLOBAL HashTable *HTable;      /* Hash table used for storing tours */
+GLOBAL int InitialPeriod;      /* Length of the first period in the ascent */
+GLOBAL int InitialStepSize;    /* Initial step size used in the ascent */
+GLOBAL double InitialTourFraction;     /* Fraction of the initial tour to be 
+                                          constructed by INITIAL_TOUR_FILE edges */
+GLOBAL char *LastLine; /* Last input line */
+GLOBAL double LowerBound;      /* Lower bound found by the ascent */
+GLOBAL int Kicks;      /* Specifies the number of K-swap-kicks */
+GLOBAL int KickType;   /* Specifies K for a K-swap-kick */
+GLOBAL int M;          /* The M-value is used when solving an ATSP-
+                          instance by transforming it to a STSP-instance */
+GLOBAL int MaxBreadth; /* The maximum number of candidate edges 
+                          considered at each level of the search for
+                          a move */
+GLOBAL int MaxCandidates;      /* Maximum number of candidate edges to be 
+                                  associated with each node */
+GLOBAL int MaxMatrixDimension; /* Maximum dimension for an explicit cost matrix */
+GLOBAL int MaxSwaps;   /* Maximum number of swaps made during the 
+                          search for a move */
+GLOBAL int MaxTrials;  /* Maximum number of trials in each run */
+GLOBAL int MergeTourFiles;     /* Number of MERGE_TOUR_FILEs */
+GLOBAL int MoveType;   /* Specifies the sequantial move type to be used 
+                          in local search. A value K >= 2 signifies 
+                          that a k-opt moves are tried for k <= K */
+GLOBAL int NodeRenumbering;    /* Specifies whether the nodes are renumbered
+                                  in the order of a space-filling curve */
+GLOBAL int NodeNumbersRead;    /* Specifies whether a section that refers
+                                  to the nodes by number (other than
+                                  NODE_COORD_SECTION) has been read */
+GLOBAL Node *NodeSet;  /* Array of all nodes */
+GLOBAL int Norm;       /* Measure of a 1-tree's discrepancy from a tour */
+GLOBAL int NonsequentialMoveType;      /* Specifies the nonsequential move type to
+                                          be used in local search. A value 
+                                          L >= 4 signifies that nonsequential
+                                          l-opt moves are tried for l <= L */
+GLOBAL GainType Optimum;       /* Known optimal tour length. 
+                                  If StopAtOptimum is 1, a run will be 
+                                  terminated as soon as a tour length 
+                                  becomes equal this value */
+GLOBAL int *OriginalId;        /* OriginalId[Id] is the number in the input
+                                  files of the node with the given Id, if
+                                  the nodes have been renumbered */
+GLOBAL int PatchingA;  /* Specifies the maximum number of alternating
+                          cycles to be used for patching disjoint cycles */
+GLOBAL int PatchingC;  /* Specifies the maximum number of disjoint cycles to be 
+                          patched (by one or more alternating cycles) */
+GLOBAL int PenaltiesRead;      /* Specifies whether the penalties have 
+                                  been read from PiFile */
+GLOBAL int Precision;  /* Internal precision in the representation of 
+                          transformed distances */
+GLOBAL int PredSucCostAvailable; /* PredCost and SucCost are available */
+GLOBAL unsigned *Rand; /* Table of random values */
+GLOBAL int *RenumberedId;      /* RenumberedId[i] is the Id of the node
+                                  with number i in the input files, if the
+                                  nodes have been renumbered */
+GLOBAL int RestrictedSearch;   /* Specifies whether the choice of the first 
+                                  edge to be broken is restricted */
+GLOBAL short Reversed; /* Boolean used to indicate whether a tour has 
+                          been reversed */
+GLOBAL int Run; /* Current run number */
+GLOBAL int Runs;       /* Total number of runs */
+GLOBAL unsigned Seed;  /* Initial seed for random number generation */
+GLOBAL int StopAtOptimum;      /* Specifies whether a run will be terminated if 
+                                  the tour length becomes equal to Optimum */
+GLOBAL int Subgradient;        /* Specifies whether the Pi-values should be 
+                                  determined by subgradient optimization */
+GLOBAL int SubproblemSize;     /* Number of nodes in a subproblem */
+GLOBAL int SubsequentMoveType; /* Specifies the move type to be used for all 
+                                  moves following the first move in a sequence 
+                                  of moves. The value K >= 2 signifies that a 
+                                  K-opt move is to be used */
+GLOBAL int SubsequentPatching; /* Species whether patching is used for 
+                                  subsequent moves */
+GLOBAL SwapRecord *SwapStack;  /* Stack of SwapRecords */
+GLOBAL int Swaps;      /* Number of swaps made during a tentative move */
+GLOBAL int Threads;    /* Number of threads used for executing runs */
+GLOBAL double TimeLimit;       /* The time limit in seconds for each run */
+GLOBAL Node **TourOrder;       /* The nodes in tour order, indexed by Rank
+                                  (used by the one-level representation) */
+GLOBAL int TraceLevel; /* Specifies the level of detail of the output 
+                          given during the solution process. 
+                          The value 0 signifies a minimum amount of 
+                          output. The higher the value is the more 
+                          information is given */
+GLOBAL int Trial;      /* Ordinal number of the current trial */
+GLOBAL int TreeType;   /* Specifies the tour representation (ONE_LEVEL,
+                          TWO_LEVEL or THREE_LEVEL), or -1 if it is
+                          chosen by the dimension of the problem */
+GLOBAL int CurrentTreeType;    /* The tour representation used for the
+                                  current problem or subproblem */
+GLOBAL int TrialExchangeInterval; /* Number of trials between exchanges
+                                     of tours between trial threads */
+GLOBAL int TrialThreads;       /* Number of threads used for performing
+                                  the trials of a run */
+GLOBAL double *XCoord, *YCoord, *ZCoord; /* Coordinates of the nodes,
+                                            indexed by Id (a copy of the
+                                            X, Y and Z fields) */
 
 /* The following variables are read by the functions ReadParameters and 
    ReadProblem: */
 
-char *ParameterFileName, *ProblemFileName, *PiFileName,
+GLOBAL char *ParameterFileName, *ProblemFileName, *PiFileName,
     *TourFileName, *OutputTourFileName, *InputTourFileName,
     **CandidateFileName, *InitialTourFileName,
-    *SubproblemTourFileName, **MergeTourFileName;
-char *Name, *Type, *EdgeWeightType, *EdgeWeightFormat,
+    *SubproblemTourFileName, **MergeTourFileName, *CacheDirectory,
+    *BinaryProblemFileName;
+GLOBAL char *Name, *Type, *EdgeWeightType, *EdgeWeightFormat,
     *EdgeDataFormat, *NodeCoordType, *DisplayDataType;
-int CandidateSetSymmetric, CandidateSetType,
+GLOBAL int AlphaSupergraph, AlphaSupergraphHops,
+    CandidateSetSymmetric, CandidateSetType,
     CoordType, DelaunayPartitioning, DelaunayPure,
     ExtraCandidateSetSymmetric, ExtraCandidateSetType,
     InitialTourAlgorithm,
@@ -303,12 +503,17 @@ int CandidateSetSymmetric, CandidateSetType,
     RohePartitioning, SierpinskiPartitioning,
     SubproblemBorders, SubproblemsCompressed, WeightType, WeightFormat;
 
-FILE *ParameterFile, *ProblemFile, *PiFile, *InputTourFile,
+GLOBAL FILE *ParameterFile, *ProblemFile, *PiFile, *InputTourFile,
     *TourFile, *InitialTourFile, *SubproblemTourFile, **MergeTourFile;
 // 大C用于计算两个客户点之间的距离，不是具体的计算函数，是对具体计算的一层缓存封装
 // 小c用于指向具体的距离计算函数，如欧几里得，att等
-CostFunction Distance, D, C, c;
-MoveFunction BestMove, BacktrackMove, BestSubsequentMove;
+GLOBAL CostFunction Distance, D, C, c;
+GLOBAL MoveFunction BestMove, BacktrackMove, BestSubsequentMove;
+GLOBAL GainFunction Gain23Function;     /* Gain23 or a variant of it */
+GLOBAL GainFunction LinKernighanFunction;       /* LinKernighan or a
+                                                   variant of it */
+GLOBAL TreeFunction MinimumSpanningTreeFunction; /* MinimumSpanningTree or
+                                                     a variant of it */
 
 /* Function prototypes: */
 
@@ -331,6 +536,8 @@ int Distance_MAX_3D(Node * Na, Node * Nb);
 int Distance_SPECIAL(Node * Na, Node * Nb);
 int Distance_XRAY1(Node * Na, Node * Nb);
 int Distance_XRAY2(Node * Na, Node * Nb);
+void DistanceBatch(Node * From, Node ** To, int Count, int *Dist);
+void DistanceRange(Node * From, int Id, int Count, int *Dist);
 
 int D_EXPLICIT(Node * Na, Node * Nb);
 int D_FUNCTION(Node * Na, Node * Nb);
@@ -349,13 +556,17 @@ int c_GEO_MEEUS(Node * Na, Node * Nb);
 int c_GEOM_MEEUS(Node * Na, Node * Nb);
 
 void Activate(Node * t);
+void AddCacheCounts(CacheCounts * Counts);
 int AddCandidate(Node * From, Node * To, int Cost, int Alpha);
 void AddExtraCandidates(int K, int CandidateSetType, int Symmetric);
 void AddTourCandidates(void);
 void AdjustCandidateSet(void);
+Node *AllocateNodes(int Count);
 void AllocateSegments(void);
+void AllocateCandidateSets(int Size);
 void AllocateStructures(void);
 GainType Ascent(void);
+void AssignCacheFiles(void);
 Node *Best2OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain);
 Node *Best3OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain);
 Node *Best4OptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain);
@@ -364,17 +575,22 @@ Node *BestKOptMove(Node * t1, Node * t2, GainType * G0, GainType * Gain);
 int Between(const Node * ta, const Node * tb, const Node * tc);
 int Between_SL(const Node * ta, const Node * tb, const Node * tc);
 int Between_SSL(const Node * ta, const Node * tb, const Node * tc);
+int BinaryFileName(const char *FileName);
 GainType BridgeGain(Node * s1, Node * s2, Node * s3, Node * s4,
                     Node * s5, Node * s6, Node * s7, Node * s8,
                     int Case6, GainType G);
 Node **BuildKDTree(int Cutoff);
 void ChooseInitialTour(void);
+int CloseFile(FILE * File);
 void Connect(Node * N1, int Max, int Sparse);
 void CandidateReport(void);
+void CopyStructures(void);
 void CreateCandidateSet(void);
 void CreateDelaunayCandidateSet(void);
 void CreateNearestNeighborCandidateSet(int K);
 void CreateQuadrantCandidateSet(int K);
+void CreateSupergraphCandidateSet(void);
+void DetachStructures(void);
 void eprintf(const char *fmt, ...);
 int Excludable(Node * ta, Node * tb);
 void Exclude(Node * ta, Node * tb);
@@ -384,21 +600,34 @@ void Flip(Node * t1, Node * t2, Node * t3);
 void Flip_SL(Node * t1, Node * t2, Node * t3);
 void Flip_SSL(Node * t1, Node * t2, Node * t3);
 int Forbidden(const Node * ta, const Node * tb);
+char *FormatInt(char *p, int v);
 void FreeCandidateSets(void);
+void FreeCopiedStructures(void);
+void FreeContext(LKHContext * Context);
 void FreeSegments(void);
 void FreeStructures(void);
 int fscanint(FILE *f, int *v);
 GainType Gain23(void);
 void GenerateCandidates(int MaxCandidates, GainType MaxAlpha, int Symmetric);
+void GenerateCandidatesInParallel(int MaxCandidates, GainType MaxAlpha);
 double GetTime(void);
 GainType GreedyTour(void);
+int HasDistanceKernel(void);
+void IndexCandidate(Node * From, int Position);
+void IndexCandidates(Node * From);
+void IndexCandidateSets(void);
 void InitializeStatistics(void);
+void InsertSubproblemTour(int CurrentSubproblem, GainType GlobalCost,
+                          int Improved);
 int IsBackboneCandidate(const Node * ta, const Node * tb);
 int IsCandidate(const Node * ta, const Node * tb);
 int IsCommonEdge(const Node * ta, const Node * tb);
 int IsPossibleCandidate(Node * From, Node * To);
 void KSwapKick(int K);
 GainType LinKernighan(void);
+void LoadContext(const LKHContext * Context);
+Candidate *LookupBackboneCandidate(const Node * ta, const Node * tb);
+Candidate *LookupCandidate(const Node * ta, const Node * tb);
 void Make2OptMove(Node * t1, Node * t2, Node * t3, Node * t4);
 void Make3OptMove(Node * t1, Node * t2, Node * t3, Node * t4, 
                   Node * t5, Node * t6, int Case);
@@ -409,32 +638,48 @@ void Make5OptMove(Node * t1, Node * t2, Node * t3, Node * t4,
                   Node * t5, Node * t6, Node * t7, Node * t8,
                   Node * t9, Node * t10, int Case);
 void MakeKOptMove(int K);
+char *MapBinaryFile(FILE * File, const char *Magic, size_t * Size);
 GainType MergeTourWithBestTour(void);
 GainType MergeWithTour(void);
 GainType Minimum1TreeCost(int Sparse);
 void MinimumSpanningTree(int Sparse);
+void MinimumSpanningTreeInParallel(void);
+int MooreIndex(double x, double y);
 void NormalizeNodeList(void);
 void NormalizeSegmentList(void);
+FILE *OpenFile(const char *FileName, const char *Mode);
 void OrderCandidateSet(int MaxCandidates, 
                        GainType MaxAlpha, int Symmetric);
 GainType PatchCycles(int k, GainType Gain);
+int PerformTrial(double EntryTime);
+void PerformTrialsInParallel(void);
 void printff(const char *fmt, ...);
+void PackCandidateSets(void);
 void PrintParameters(void);
 void PrintStatistics(void);
 unsigned Random(void);
 int ReadCandidates(int MaxCandidates);
 char *ReadLine(FILE * InputFile);
+int ReadMappedSection(FILE * File, long long Tokens,
+                      SectionParser Parser, void *Arg);
 void ReadParameters(void);
 int ReadPenalties(void);
 void ReadProblem(void);
 void ReadTour(char * FileName, FILE ** File);
 void RecordBestTour(void);
 void RecordBetterTour(void);
+void RenumberNodes(void);
 Node *RemoveFirstActive(void);
+void ReleaseCandidateSet(Candidate * Set);
 void ResetCandidateSet(void);
+Candidate *ResizeCandidateSet(Candidate * Set, int Used, int Size);
 void RestoreTour(void);
+const char *ScanDouble(const char *p, const char *End, double *v);
+const char *ScanInt(const char *p, const char *End, int *v);
 int SegmentSize(Node *ta, Node *tb);
+LKHContext *SaveContext(void);
 GainType SFCTour(int CurveType);
+int *SortedNodeIds(int *Count);
 void SolveCompressedSubproblem(int CurrentSubproblem, int Subproblems, 
                                GainType * GlobalBestCost);
 void SolveDelaunaySubproblems(void);
@@ -442,16 +687,26 @@ void SolveKarpSubproblems(void);
 void SolveKCenterSubproblems(void);
 void SolveKMeansSubproblems(void);
 void SolveRoheSubproblems(void);
+void SolveRunsInParallel(void);
 void SolveSFCSubproblems(void);
 int SolveSubproblem(int CurrentSubproblem, int Subproblems, 
                     GainType * GlobalBestCost);
 void SolveSubproblemBorderProblems(int Subproblems, GainType * GlobalCost);
+void SolveSubproblemsInParallel(int FirstSubproblem, int LastSubproblem,
+                                int Subproblems, GainType * GlobalBestCost);
 void SolveTourSegmentSubproblems(void);
+void SpecializeFunctions(void);
 void StoreTour(void);
 void SRandom(unsigned seed);
+int SubproblemsInParallel(void);
+void SwapCandidateIndexes(void);
 void SymmetrizeCandidateSet(void);
+void TakeCacheCounts(CacheCounts * Counts);
+char *TemporaryFileName(const char *FileName);
 void TrimCandidateSet(int MaxCandidates);
+void UnindexCandidates(Node * From);
 void UpdateStatistics(GainType Cost, double Time);
+void WriteBinaryProblem(void);
 void WriteCandidates(void);
 void WritePenalties(void);
 void WriteTour(char * FileName, int * Tour, GainType Cost);
@@ -14,8 +14,8 @@
  * tour. 
  *
  * If THREE_LEVEL_TREE is defined the three-level tree representation is used
- * for a tour.  If TWO_LEVEL_TREE is defined the three-level tree 
- * representation is used.  Otherwise the linked list representation is used. 
+ * for a tour.  If ONE_LEVEL_TREE is defined the linked list representation
+ * is used.  Otherwise the two-level tree representation is used.
  *
  * All representations support the following primitive operations:
  *
@@ -30,9 +30,12 @@
  *
  *     (4) make a 2-opt move (FLIP).
  *	
- * The default representation is the two-level tree representation. 
- * In order to use the linked list representation, uncomment the 
- * following preprocessor command line.	
+ * The representation is fixed for each source file that includes the
+ * header. The source files themselves are compiled with the two-level
+ * tree representation. The functions that use the header are also
+ * compiled for the other two representations (see TreeVariant.h), and
+ * the representation to be used is chosen at run time for each problem
+ * and subproblem (see AllocateSegments).
  */
 
 #ifdef THREE_LEVEL_TREE
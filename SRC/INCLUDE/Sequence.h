@@ -10,16 +10,16 @@
 
 #include "LKH.h"
 
-Node **t;       /* The sequence of nodes to be used in a move */
-Node **T;       /* The currently best t's */
-Node **tSaved;  /* For saving t when using the BacktrackKOptMove function */
-int *p;         /* The permutation corresponding to the sequence in which
-                   the t's occur on the tour */
-int *q;         /* The inverse permutation of p */
-int *incl;      /* Array: incl[i] == j, if (t[i], t[j]) is an inclusion edge */
-int *cycle;     /* Array: cycle[i] is cycle number of t[i] */
-GainType *G;    /* For storing the G-values in the BestKOptMove function */
-int K;          /* The value K for the current K-opt move */
+GLOBAL Node **t;       /* The sequence of nodes to be used in a move */
+GLOBAL Node **T;       /* The currently best t's */
+GLOBAL Node **tSaved;  /* For saving t when using the BacktrackKOptMove function */
+GLOBAL int *p;         /* The permutation corresponding to the sequence in which
+                          the t's occur on the tour */
+GLOBAL int *q;         /* The inverse permutation of p */
+GLOBAL int *incl;      /* Array: incl[i] == j, if (t[i], t[j]) is an inclusion edge */
+GLOBAL int *cycle;     /* Array: cycle[i] is cycle number of t[i] */
+GLOBAL GainType *G;    /* For storing the G-values in the BestKOptMove function */
+GLOBAL int K;          /* The value K for the current K-opt move */
 
 int FeasibleKOptMove(int k);
 void FindPermutation(int k);
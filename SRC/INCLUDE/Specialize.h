@@ -0,0 +1,193 @@
+#ifndef _SPECIALIZE_H
+#define _SPECIALIZE_H
+
+/*
+ * This header is used for compiling statically dispatched variants of the
+ * functions that evaluate edge costs in their inner loops: Best2OptMove,
+ * Best3OptMove, Best4OptMove, Best5OptMove, BestKOptMove, Gain23,
+ * BridgeGain and MinimumSpanningTree.
+ *
+ * A file that includes the header must first define one of the macros
+ * SPECIALIZE_EXPLICIT, SPECIALIZE_EUC_2D, SPECIALIZE_CEIL_2D,
+ * SPECIALIZE_ATT or SPECIALIZE_GEO. The header then redefines C, c and D
+ * as macros that call static inline functions for the given edge weight
+ * type (instead of calling through the function pointers), and compiles
+ * the functions above with the type name appended to their names
+ * (e.g., Best5OptMove_EUC_2D).
+ *
+ * If the macro ONE_LEVEL_TREE is also defined, the functions of
+ * TreeVariant.h are compiled instead, for the linked list representation
+ * of the tour and with both names appended to their names (e.g.,
+ * Best5OptMove_ONE_LEVEL_EUC_2D). MinimumSpanningTree does not depend on
+ * the tour representation and is then not compiled.
+ *
+ * The inline functions compute the same values as the functions
+ * referenced by the pointers: C_EXPLICIT and D_EXPLICIT when the costs are
+ * given by the cost matrix, and C_FUNCTION, D_FUNCTION and the lower bound
+ * functions (c_EUC_2D, etc.) otherwise. For EUC_2D, CEIL_2D and ATT the
+ * distances are computed directly instead of being looked up in the
+ * distance cache. For GEO the distance cache is used.
+ *
+ * The variant to be used is selected by the SpecializeFunctions function.
+ */
+
+#include "LKH.h"
+#include "Segment.h"
+#include "Sequence.h"
+#include "Heap.h"
+
+/* No fused multiply-add, so that the distances are identical to those
+   computed by the functions in Distance.c */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#if defined(SPECIALIZE_EXPLICIT)
+#define Specialized(f) f##_EXPLICIT
+#elif defined(SPECIALIZE_EUC_2D)
+#define Specialized(f) f##_EUC_2D
+#elif defined(SPECIALIZE_CEIL_2D)
+#define Specialized(f) f##_CEIL_2D
+#elif defined(SPECIALIZE_ATT)
+#define Specialized(f) f##_ATT
+#elif defined(SPECIALIZE_GEO)
+#define Specialized(f) f##_GEO
+#else
+#error "Specialize.h: no edge weight type specified"
+#endif
+
+#ifdef SPECIALIZE_EXPLICIT
+
+static inline int C_Inline(Node * Na, Node * Nb)
+{
+    return Na->Id < Nb->Id ? Nb->C[Na->Id] : Na->C[Nb->Id];
+}
+
+static inline int D_Inline(Node * Na, Node * Nb)
+{
+    return C_Inline(Na, Nb) + Na->Pi + Nb->Pi;
+}
+
+/* The lower bound function c is zero when the cost matrix is used */
+static inline int c_Inline(Node * Na, Node * Nb)
+{
+    return c(Na, Nb);
+}
+
+#else
+
+#if defined(SPECIALIZE_EUC_2D)
+
+static inline int Distance_Inline(Node * Na, Node * Nb)
+{
+    double xd = Na->X - Nb->X, yd = Na->Y - Nb->Y;
+    return (int) (sqrt(xd * xd + yd * yd) + 0.5);
+}
+
+static inline int c_Inline(Node * Na, Node * Nb)
+{
+    int dx = (int) (fabs(Na->X - Nb->X) + 0.5),
+        dy = (int) (fabs(Na->Y - Nb->Y) + 0.5);
+    return (dx > dy ? dx : dy) * Precision + Na->Pi + Nb->Pi;
+}
+
+#elif defined(SPECIALIZE_CEIL_2D)
+
+static inline int Distance_Inline(Node * Na, Node * Nb)
+{
+    double xd = Na->X - Nb->X, yd = Na->Y - Nb->Y;
+    return (int) ceil(sqrt(xd * xd + yd * yd));
+}
+
+static inline int c_Inline(Node * Na, Node * Nb)
+{
+    int dx = (int) ceil(fabs(Na->X - Nb->X)),
+        dy = (int) ceil(fabs(Na->Y - Nb->Y));
+    return (dx > dy ? dx : dy) * Precision + Na->Pi + Nb->Pi;
+}
+
+#elif defined(SPECIALIZE_ATT)
+
+static inline int Distance_Inline(Node * Na, Node * Nb)
+{
+    double xd = Na->X - Nb->X, yd = Na->Y - Nb->Y;
+    return (int) ceil(sqrt((xd * xd + yd * yd) / 10.0));
+}
+
+static inline int c_Inline(Node * Na, Node * Nb)
+{
+    int dx = (int) (ceil(0.31622 * fabs(Na->X - Nb->X))),
+        dy = (int) (ceil(0.31622 * fabs(Na->Y - Nb->Y)));
+    return (dx > dy ? dx : dy) * Precision + Na->Pi + Nb->Pi;
+}
+
+#elif defined(SPECIALIZE_GEO)
+
+static inline int Distance_Inline(Node * Na, Node * Nb)
+{
+    return Distance_GEO(Na, Nb);
+}
+
+static inline int c_Inline(Node * Na, Node * Nb)
+{
+    return c_GEO(Na, Nb);
+}
+
+#endif
+
+static inline int D_Inline(Node * Na, Node * Nb)
+{
+    return (Fixed(Na, Nb) ? 0 : Distance_Inline(Na, Nb) * Precision) +
+        Na->Pi + Nb->Pi;
+}
+
+#ifdef SPECIALIZE_GEO
+/* GEO distances are expensive; use the distance cache */
+static inline int C_Inline(Node * Na, Node * Nb)
+{
+    return C_FUNCTION(Na, Nb);
+}
+#else
+static inline int C_Inline(Node * Na, Node * Nb)
+{
+    if (PredSucCostAvailable) {
+        if (Na->Suc == Nb)
+            return Na->SucCost;
+        if (Na->Pred == Nb)
+            return Na->PredCost;
+    }
+    return D_Inline(Na, Nb);
+}
+#endif
+
+#endif
+
+#define C(a, b) C_Inline(a, b)
+#define c(a, b) c_Inline(a, b)
+#define D(a, b) D_Inline(a, b)
+
+#ifdef ONE_LEVEL_TREE
+#include "TreeVariant.h"
+#else
+
+#define Best2OptMove Specialized(Best2OptMove)
+#define Best3OptMove Specialized(Best3OptMove)
+#define Best4OptMove Specialized(Best4OptMove)
+#define Best5OptMove Specialized(Best5OptMove)
+#define BestKOptMove Specialized(BestKOptMove)
+#define Gain23 Specialized(Gain23)
+#define BridgeGain Specialized(BridgeGain)
+#define MinimumSpanningTree Specialized(MinimumSpanningTree)
+
+#include "../Best2OptMove.c"
+#include "../Best3OptMove.c"
+#include "../Best4OptMove.c"
+#include "../Best5OptMove.c"
+#include "../BestKOptMove.c"
+#include "../BridgeGain.c"
+#include "../Gain23.c"
+#include "../MinimumSpanningTree.c"
+
+#endif
+
+#endif
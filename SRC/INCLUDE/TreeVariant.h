@@ -0,0 +1,93 @@
+#ifndef _TREE_VARIANT_H
+#define _TREE_VARIANT_H
+
+/*
+ * This header is used for compiling variants of the functions that
+ * access the tour through the macros of Segment.h (PRED, SUC, BETWEEN
+ * and FLIP): LinKernighan, the move functions, Gain23, BridgeGain,
+ * PatchCycles, RestoreTour, NormalizeNodeList, SegmentSize and the
+ * functions of Sequence.c.
+ *
+ * A file that includes the header must first define one of the macros
+ * ONE_LEVEL_TREE or THREE_LEVEL_TREE. The functions above are then
+ * compiled for the linked list representation or the three-level tree
+ * representation of the tour, respectively, with the name of the
+ * representation appended to their names (e.g., LinKernighan_ONE_LEVEL).
+ * The linked list variants are also compiled for each of the edge weight
+ * types of Specialize.h, which then includes this header (e.g.,
+ * LinKernighan_ONE_LEVEL_EUC_2D).
+ * The functions for the two-level tree representation are compiled from
+ * their own source files.
+ *
+ * Since each function only calls variants for the same representation,
+ * the representation is chosen once for each problem and subproblem
+ * (see AllocateSegments) instead of for each access of the tour. The
+ * variants to be used are selected by the SpecializeFunctions function.
+ */
+
+#include "Segment.h"
+#include "LKH.h"
+#include "Sequence.h"
+#include "Hashing.h"
+
+#if defined(ONE_LEVEL_TREE) && defined(Specialized)
+#define Represented(f) Specialized(f##_ONE_LEVEL)
+#elif defined(ONE_LEVEL_TREE)
+#define Represented(f) f##_ONE_LEVEL
+#elif defined(THREE_LEVEL_TREE)
+#define Represented(f) f##_THREE_LEVEL
+#else
+#error "TreeVariant.h: no tour representation specified"
+#endif
+
+#define Best2OptMove Represented(Best2OptMove)
+#define Best3OptMove Represented(Best3OptMove)
+#define Best4OptMove Represented(Best4OptMove)
+#define Best5OptMove Represented(Best5OptMove)
+#define BestKOptMove Represented(BestKOptMove)
+#define BridgeGain Represented(BridgeGain)
+#define Gain23 Represented(Gain23)
+#define LinKernighan Represented(LinKernighan)
+#define Make2OptMove Represented(Make2OptMove)
+#define Make3OptMove Represented(Make3OptMove)
+#define Make4OptMove Represented(Make4OptMove)
+#define Make5OptMove Represented(Make5OptMove)
+#define MakeKOptMove Represented(MakeKOptMove)
+#define NormalizeNodeList Represented(NormalizeNodeList)
+#define PatchCycles Represented(PatchCycles)
+#define RestoreTour Represented(RestoreTour)
+#define SegmentSize Represented(SegmentSize)
+
+/* Sequence.c is compiled as a whole, so all of its functions are renamed */
+#define FindPermutation Represented(FindPermutation)
+#define FeasibleKOptMove Represented(FeasibleKOptMove)
+#define Cycles Represented(Cycles)
+#define Added Represented(Added)
+#define Deleted Represented(Deleted)
+#define MarkAdded Represented(MarkAdded)
+#define MarkDeleted Represented(MarkDeleted)
+#define UnmarkAdded Represented(UnmarkAdded)
+#define UnmarkDeleted Represented(UnmarkDeleted)
+
+/* The files are included in an order where each function is defined
+   before it is called */
+#include "../SegmentSize.c"
+#include "../Sequence.c"
+#include "../RestoreTour.c"
+#include "../NormalizeNodeList.c"
+#include "../Make2OptMove.c"
+#include "../Make3OptMove.c"
+#include "../Make4OptMove.c"
+#include "../Make5OptMove.c"
+#include "../MakeKOptMove.c"
+#include "../PatchCycles.c"
+#include "../Best2OptMove.c"
+#include "../Best3OptMove.c"
+#include "../Best4OptMove.c"
+#include "../Best5OptMove.c"
+#include "../BestKOptMove.c"
+#include "../BridgeGain.c"
+#include "../Gain23.c"
+#include "../LinKernighan.c"
+
+#endif
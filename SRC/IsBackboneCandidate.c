@@ -5,14 +5,11 @@
  * belongs to the set of backbone candidate edges.
  *
  * If the edge is a candidate edge the function returns 1; otherwise 0.
+ * The test is made by means of the hash table of backbone candidate edges
+ * (see IndexCandidateSets).
  */
 
 int IsBackboneCandidate(const Node * ta, const Node * tb)
 {
-    Candidate *Nta;
-
-    for (Nta = ta->BackboneCandidateSet; Nta && Nta->To; Nta++)
-        if (Nta->To == tb)
-            return 1;
-    return 0;
+    return LookupBackboneCandidate(ta, tb) != 0;
 }
@@ -5,14 +5,11 @@
  * belongs to the set of candidate edges.
  *
  * If the edge is a candidate edge the function returns 1; otherwise 0.
+ * The test is made by means of the hash table of candidate edges
+ * (see IndexCandidateSets).
  */
 
 int IsCandidate(const Node * ta, const Node * tb)
 {
-    Candidate *Nta;
-
-    for (Nta = ta->CandidateSet; Nta && Nta->To; Nta++)
-        if (Nta->To == tb)
-            return 1;
-    return 0;
+    return LookupCandidate(ta, tb) != 0;
 }
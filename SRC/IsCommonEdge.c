@@ -14,7 +14,7 @@ int IsCommonEdge(const Node * ta, const Node * tb)
     if (MergeTourFiles < 2)
         return 0;
     for (i = 0; i < MergeTourFiles; i++)
-        if (ta->MergeSuc[i] != tb && tb->MergeSuc[i] != ta)
+        if (Cold(ta)->MergeSuc[i] != tb && Cold(tb)->MergeSuc[i] != ta)
             return 0;
     return 1;
 }
@@ -13,7 +13,7 @@ int IsPossibleCandidate(Node * From, Node * To)
     Node *Na, *Nb, *Nc, *N;
 
     if (InInitialTour(From, To) ||
-        From->SubproblemSuc == To || To->SubproblemSuc == From ||
+        Cold(From)->SubproblemSuc == To || Cold(To)->SubproblemSuc == From ||
         FixedOrCommon(From, To))
         return 1;
     if (From->FixedTo2 || To->FixedTo2)
@@ -26,7 +26,8 @@ int IsPossibleCandidate(Node * From, Node * To)
             Na->Head = Na->Tail = Na;
         while ((Na = Na->Suc) != FirstNode);
         Na = FirstNode;
-        while ((Nb = Na->MergeSuc[0]) != FirstNode && FixedOrCommon(Na, Nb))
+        while ((Nb = Cold(Na)->MergeSuc[0]) != FirstNode &&
+               FixedOrCommon(Na, Nb))
             Na = Nb;
         if (Nb != FirstNode) {
             N = Nb;
@@ -35,11 +36,11 @@ int IsPossibleCandidate(Node * From, Node * To)
                 do {
                     Na = Nb; 
                     Na->Head = Nc;
-                    Nb = Na->MergeSuc[0];
+                    Nb = Cold(Na)->MergeSuc[0];
                 } while (FixedOrCommon(Na, Nb));
                 do  
                     Nc->Tail = Na;
-                while ((Nc = Nc->MergeSuc[0]) != Nb);
+                while ((Nc = Cold(Nc)->MergeSuc[0]) != Nb);
             } while (Nc != N);
         } else {
             do
@@ -16,6 +16,8 @@ int main(int argc, char *argv[])
     ReadParameters();
     MaxMatrixDimension = 10000;
     ReadProblem();
+    if (BinaryProblemFileName)
+        return EXIT_SUCCESS;    /* The problem has only been converted */
 
     if (SubproblemSize > 0) { // 如果存在子问题，需要先使用各种聚类聚集？？？这里存在向VRP问题转化的可能性
         if (DelaunayPartitioning)
@@ -51,6 +53,13 @@ int main(int argc, char *argv[])
         Runs = 0;
     }
 
+    if (Threads > 1 && MaxPopulationSize <= 1) {
+        /* Execute the runs concurrently */
+        SolveRunsInParallel();
+        PrintStatistics();
+        return EXIT_SUCCESS;
+    }
+
     /* Find a specified number (Runs) of local optima */
     for (Run = 1; Run <= Runs; Run++) {
         LastTime = GetTime();
@@ -93,9 +102,9 @@ int main(int argc, char *argv[])
         }
         OldOptimum = Optimum;
         if (Cost < Optimum) {
-            if (FirstNode->InputSuc) {
+            if (Cold(FirstNode)->InputSuc) {
                 Node *N = FirstNode;
-                while ((N = N->InputSuc = N->Suc) != FirstNode);
+                while ((N = Cold(N)->InputSuc = N->Suc) != FirstNode);
             }
             Optimum = Cost;
             printff("*** New optimum = " GainFormat " ***\n\n", Optimum);
@@ -131,7 +140,7 @@ int main(int argc, char *argv[])
                     AddCandidate(N, N->Suc, d, INT_MAX);
                     AddCandidate(N->Suc, N, d, INT_MAX);
                 }
-                N = N->InitialSuc = N->Suc;
+                N = Cold(N)->InitialSuc = N->Suc;
             }
             while (N != FirstNode);
         }
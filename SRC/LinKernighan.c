@@ -55,10 +55,13 @@ GainType LinKernighan()
         t2 = t1->OldSuc = t1->Suc;
         t1->OldPred = t1->Pred;
         t1->Rank = ++i;
+#ifdef ONE_LEVEL_TREE
+        TourOrder[i] = t1;
+#endif
         Cost += (t1->SucCost = t2->PredCost = C(t1, t2)) - t1->Pi - t2->Pi;
         Hash ^= Rand[t1->Id] * Rand[t2->Id];
         t1->Cost = INT_MAX;
-        for (Nt1 = t1->CandidateSet; (t2 = Nt1->To); Nt1++)
+        for (Nt1 = t1->CandidateSet; (t2 = CandidateNode(Nt1)); Nt1++)
             if (t2 != t1->Pred && t2 != t1->Suc && Nt1->Cost < t1->Cost)
                 t1->Cost = Nt1->Cost;
         t1->Parent = S;
@@ -151,7 +154,7 @@ GainType LinKernighan()
         HashInsert(HTable, Hash, Cost);
         /* Try to find improvements using non-sequential 4/5-opt moves */
         Gain = 0;
-        if (Gain23Used && (Gain = Gain23()) > 0) {
+        if (Gain23Used && (Gain = Gain23Function()) > 0) {
             /* An improvement has been found */
             assert(Gain % Precision == 0);
             Cost -= Gain / Precision;
@@ -0,0 +1,61 @@
+#include "LKH.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * The MapBinaryFile function maps the file of the stream File into
+ * memory, if the file is a regular file that starts with the 8 characters
+ * of Magic (CandidateMagic or PenaltyMagic). The size of the file is
+ * stored in *Size.
+ *
+ * The function returns a pointer to the start of the mapping, which must
+ * be removed by munmap, or 0 if the file is not such a binary file (for
+ * example, a text file, or a file that is read through a decompression
+ * program; see OpenFile). The stream is not used.
+ */
+
+static int LittleEndian(void);
+
+char *MapBinaryFile(FILE * File, const char *Magic, size_t * Size)
+{
+    struct stat Stat;
+    char Buffer[8], *Map;
+
+    if (fstat(fileno(File), &Stat) || !S_ISREG(Stat.st_mode) ||
+        pread(fileno(File), Buffer, 8, 0) != 8 ||
+        memcmp(Buffer, Magic, 8))
+        return 0;
+    if (!LittleEndian())
+        eprintf("Binary files are only supported on little-endian "
+                "machines");
+    Map = (char *) mmap(0, Stat.st_size, PROT_READ, MAP_PRIVATE,
+                        fileno(File), 0);
+    if (Map == MAP_FAILED)
+        eprintf("Cannot map binary file");
+    madvise(Map, Stat.st_size, MADV_SEQUENTIAL);
+    *Size = Stat.st_size;
+    return Map;
+}
+
+/*
+ * The BinaryFileName function returns 1 if a file named FileName is to be
+ * written in binary form (see WriteCandidates and WritePenalties), that
+ * is, if the name ends in ".bin"; otherwise 0. Binary files are only
+ * written on little-endian machines.
+ */
+
+int BinaryFileName(const char *FileName)
+{
+    size_t Length = strlen(FileName);
+
+    return Length > 4 && !strcmp(FileName + Length - 4, ".bin") &&
+        LittleEndian();
+}
+
+static int LittleEndian()
+{
+    int One = 1;
+
+    return *(char *) &One == 1;
+}
@@ -12,15 +12,26 @@
  * sum of squares of all V-values, is a measure of a minimum 1-tree/s 
  * discrepancy from a tour. If Norm is zero, then the 1-tree constitutes a 
  * tour, and an optimal tour has been found.
+ *
+ * If THREADS > 1, the minimum spanning tree of a sparse graph with at
+ * least ParallelTreeDimension nodes is determined by the function
+ * MinimumSpanningTreeInParallel. For smaller graphs the cost of starting
+ * the threads exceeds the gain.
  */
 
+#define ParallelTreeDimension 10000
+
 GainType Minimum1TreeCost(int Sparse)
 {
     Node *N, *N1 = 0;
     GainType Sum = 0;
     int Max = INT_MIN;
 
-    MinimumSpanningTree(Sparse);
+    if (Sparse && Threads > 1 && Dimension >= ParallelTreeDimension &&
+        FirstNode->CandidateSet)
+        MinimumSpanningTreeInParallel();
+    else
+        MinimumSpanningTreeFunction(Sparse);
     N = FirstNode;
     do {
         N->V = -2;
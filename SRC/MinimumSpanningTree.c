@@ -1,5 +1,6 @@
 #include "LKH.h"
 #include "Heap.h"
+#include <pthread.h>
 
 /*
  * dad为最小生成树结构的索引，该树以id等于1的点为root
@@ -19,15 +20,53 @@
  * is used  to speed up the determination of which edge to include next into 
  * the tree. The Rank field of a node is used to contain its priority (usually 
  * equal to the shortest distance (Cost) to nodes of the tree).        
+ *
+ * When the graph is dense, the non-tree nodes are kept in an array, in list
+ * order, together with their costs, and the node to be included next is
+ * found while the costs are updated (see Update). If the distances are
+ * computed by a vector kernel (see DistanceBatch), the nodes are updated in
+ * blocks. The nodes of a block that pass the lower bound test are collected,
+ * and their distances to the new tree node are computed in one batch.
+ *
+ * If THREADS > 1 and the graph has at least ParallelDenseDimension nodes,
+ * the array is divided among the worker threads at each step. The tree
+ * does not depend on the number of threads.
  */
 
+#define ParallelDenseDimension 5000
+
+typedef struct DenseTree {
+    Node **Out;         /* The non-blue nodes in list order */
+    int *Key;           /* Key[i] is the cost of Out[i] */
+    int Outs;           /* Number of nodes in Out */
+    Node *Blue;         /* The last node included in the tree, or 0 when
+                           the workers are to stop */
+    int Batched;        /* Are distances computed by DistanceBatch? */
+    int Workers;        /* Number of threads, including the calling one */
+    int *Min, *Best;    /* Smallest cost found by each worker, and its
+                           index in Out */
+    LKHContext *MainContext;    /* Context of the calling thread */
+    pthread_mutex_t Lock;
+    pthread_cond_t Released;
+    int Waiting, Generation;
+} DenseTree;
+
+typedef struct WorkerArg {
+    DenseTree *T;
+    int w;
+} WorkerArg;
+
+static void *Worker(void *Arg);
+static void Barrier(DenseTree * T);
+static void Update(DenseTree * T, int w);
+
 void MinimumSpanningTree(int Sparse)
 {
     Node *Blue;         /* Points to the last node included in the tree */
     Node *NextBlue = 0; /* Points to the provisional next node to be included */
     Node *N;
     Candidate *NBlue;
-    int d;
+    int d, i;
 
     Blue = N = FirstNode;
     Blue->Dad = 0;              /* The root of the tree has no father */
@@ -41,7 +80,8 @@ void MinimumSpanningTree(int Sparse)
             HeapLazyInsert(N);
         }
         /* Update all neighbors to the blue node */
-        for (NBlue = Blue->CandidateSet; (N = NBlue->To); NBlue++) { // 遍历blue的candidateSet
+        for (NBlue = Blue->CandidateSet;
+             (N = CandidateNode(NBlue)); NBlue++) { // 遍历blue的candidateSet
             if (FixedOrCommon(Blue, N)) {
                 N->Dad = Blue;
                 N->Cost = NBlue->Cost + Blue->Pi + N->Pi;
@@ -58,7 +98,8 @@ void MinimumSpanningTree(int Sparse)
             Follow(NextBlue, Blue);
             Blue = NextBlue;
             /* Update all neighbors to the blue node */
-            for (NBlue = Blue->CandidateSet; (N = NBlue->To); NBlue++) {
+            for (NBlue = Blue->CandidateSet;
+                 (N = CandidateNode(NBlue)); NBlue++) {
                 if (!N->Loc)
                     continue;
                 if (FixedOrCommon(Blue, N)) {
@@ -76,35 +117,203 @@ void MinimumSpanningTree(int Sparse)
         }
     } else { // 这种实现的时间复杂度应该是N平方，应该存在改进空间
         /* The graph is dense */
+        DenseTree T;
+        pthread_t *Thread = 0;
+        WorkerArg *Arg = 0;
+        int Min, Best, w;
+
+        T.Outs = 0;
         while ((N = N->Suc) != FirstNode)
-            N->Cost = INT_MAX;
+            T.Outs++;
+        assert(T.Out = (Node **) malloc(T.Outs * sizeof(Node *)));
+        assert(T.Key = (int *) malloc(T.Outs * sizeof(int)));
+        for (i = 0; (N = N->Suc) != FirstNode; i++) {
+            T.Out[i] = N;
+            T.Key[i] = INT_MAX;
+        }
+        T.Batched = D == D_FUNCTION && HasDistanceKernel();
+        T.Workers = Threads > 1 && T.Outs >= ParallelDenseDimension ?
+            Threads : 1;
+        assert(T.Min = (int *) malloc(T.Workers * sizeof(int)));
+        assert(T.Best = (int *) malloc(T.Workers * sizeof(int)));
+        if (T.Workers > 1) {
+            pthread_mutex_init(&T.Lock, 0);
+            pthread_cond_init(&T.Released, 0);
+            T.Waiting = T.Generation = 0;
+            T.MainContext = SaveContext();
+            assert(Thread =
+                   (pthread_t *) malloc(T.Workers * sizeof(pthread_t)));
+            assert(Arg =
+                   (WorkerArg *) malloc(T.Workers * sizeof(WorkerArg)));
+            for (w = 1; w < T.Workers; w++) {
+                Arg[w].T = &T;
+                Arg[w].w = w;
+                if (pthread_create(&Thread[w], 0, Worker, &Arg[w]))
+                    eprintf("Cannot create thread %d", w);
+            }
+        }
         /* Loop as long as there a more nodes to include in the tree */
-        while ((N = Blue->Suc) != FirstNode) {
-            int Min = INT_MAX;
-            /* Update all non-blue nodes (the successors of Blue in the list) */
-            do {
-                if (FixedOrCommon(Blue, N)) {
-                    N->Dad = Blue;
-                    N->Cost = D(Blue, N);
-                    NextBlue = N;
-                    Min = INT_MIN;
-                } else {
-                    if (!Blue->FixedTo2 && !N->FixedTo2 &&
-                        !Forbidden(Blue, N) &&
-                        (!c || c(Blue, N) < N->Cost) &&
-                        (d = D(Blue, N)) < N->Cost) {
-                        N->Cost = d;
-                        N->Dad = Blue;
-                    }
-                    if (N->Cost < Min) {
-                        Min = N->Cost;
-                        NextBlue = N;
-                    }
+        while (T.Outs > 0) {
+            /* Update all non-blue nodes */
+            T.Blue = Blue;
+            Barrier(&T);
+            Update(&T, 0);
+            Barrier(&T);
+            Min = INT_MAX;
+            Best = 0;
+            for (w = 0; w < T.Workers; w++) {
+                if (T.Min[w] < Min || T.Min[w] == INT_MIN) {
+                    Min = T.Min[w];
+                    Best = T.Best[w];
                 }
             }
-            while ((N = N->Suc) != FirstNode);
+            NextBlue = T.Out[Best];
+            NextBlue->Cost = T.Key[Best];
+            T.Outs--;
+            memmove(T.Out + Best, T.Out + Best + 1,
+                    (T.Outs - Best) * sizeof(Node *));
+            memmove(T.Key + Best, T.Key + Best + 1,
+                    (T.Outs - Best) * sizeof(int));
             Follow(NextBlue, Blue); // nextBlue的前一个节点与后一个节点进行双向互联，nextBlue自己与自己互连，nextBlue与Blue的前一个节点互联，这两个节点互联
             Blue = NextBlue;
         }
+        if (T.Workers > 1) {
+            T.Blue = 0;
+            Barrier(&T);
+            for (w = 1; w < T.Workers; w++)
+                pthread_join(Thread[w], 0);
+            FreeContext(T.MainContext);
+            pthread_mutex_destroy(&T.Lock);
+            pthread_cond_destroy(&T.Released);
+            free(Thread);
+            free(Arg);
+        }
+        free(T.Out);
+        free(T.Key);
+        free(T.Min);
+        free(T.Best);
+    }
+}
+
+static void *Worker(void *Arg)
+{
+    DenseTree *T = ((WorkerArg *) Arg)->T;
+    int w = ((WorkerArg *) Arg)->w;
+
+    LoadContext(T->MainContext);
+    for (;;) {
+        Barrier(T);
+        if (!T->Blue)
+            break;
+        Update(T, w);
+        Barrier(T);
+    }
+    return 0;
+}
+
+static void Barrier(DenseTree * T)
+{
+    int g;
+
+    if (T->Workers == 1)
+        return;
+    pthread_mutex_lock(&T->Lock);
+    g = T->Generation;
+    if (++T->Waiting == T->Workers) {
+        T->Waiting = 0;
+        T->Generation++;
+        pthread_cond_broadcast(&T->Released);
+    } else
+        while (g == T->Generation)
+            pthread_cond_wait(&T->Released, &T->Lock);
+    pthread_mutex_unlock(&T->Lock);
+}
+
+/*
+ * The Update function updates the costs of the non-blue nodes in the part
+ * of T->Out given to worker w after node T->Blue has been included in the
+ * tree, and records the node to be included next (the one with the smallest
+ * cost, or the last one with a fixed or common edge to T->Blue). Ties are
+ * broken in favor of the first node, so the tree is the same for any number
+ * of workers.
+ *
+ * If T->Blue has no fixed or common edges, and no edges are forbidden, the
+ * tests for these cases are done once for T->Blue instead of once for each
+ * node.
+ */
+
+static void Update(DenseTree * T, int w)
+{
+    Node *Blue = T->Blue, *N, *Other[DistanceBatchSize];
+    Node **Out = T->Out;
+    int *Key = T->Key, Index[DistanceBatchSize], Dist[DistanceBatchSize];
+    int First = (int) ((long long) T->Outs * w / T->Workers);
+    int Last = (int) ((long long) T->Outs * (w + 1) / T->Workers);
+    int Min = INT_MAX, Best = First, d, i, j, k;
+
+    if (Blue->FixedTo1 || Blue->FixedTo2 || MergeTourFiles >= 2 ||
+        ProblemType == ATSP) {
+        for (i = First; i < Last; i++) {
+            N = Out[i];
+            if (FixedOrCommon(Blue, N)) {
+                N->Dad = Blue;
+                Key[i] = D(Blue, N);
+                Best = i;
+                Min = INT_MIN;
+            } else {
+                if (!Blue->FixedTo2 && !N->FixedTo2 &&
+                    !Forbidden(Blue, N) &&
+                    (!c || c(Blue, N) < Key[i]) &&
+                    (d = D(Blue, N)) < Key[i]) {
+                    Key[i] = d;
+                    N->Dad = Blue;
+                }
+                if (Key[i] < Min) {
+                    Min = Key[i];
+                    Best = i;
+                }
+            }
+        }
+    } else if (T->Batched) {
+        for (i = First; i < Last; i = j) {
+            /* Collect a block of at most DistanceBatchSize nodes that
+               pass the lower bound test */
+            for (j = i, k = 0; j < Last && k < DistanceBatchSize; j++) {
+                N = Out[j];
+                if (!N->FixedTo2 && (!c || c(Blue, N) < Key[j])) {
+                    Other[k] = N;
+                    Index[k++] = j;
+                }
+            }
+            DistanceBatch(Blue, Other, k, Dist);
+            while (--k >= 0) {
+                d = Dist[k] * Precision + Blue->Pi + Other[k]->Pi;
+                if (d < Key[Index[k]]) {
+                    Key[Index[k]] = d;
+                    Other[k]->Dad = Blue;
+                }
+            }
+            for (; i < j; i++) {
+                if (Key[i] < Min) {
+                    Min = Key[i];
+                    Best = i;
+                }
+            }
+        }
+    } else {
+        for (i = First; i < Last; i++) {
+            N = Out[i];
+            if (!N->FixedTo2 && (!c || c(Blue, N) < Key[i]) &&
+                (d = D(Blue, N)) < Key[i]) {
+                Key[i] = d;
+                N->Dad = Blue;
+            }
+            if (Key[i] < Min) {
+                Min = Key[i];
+                Best = i;
+            }
+        }
     }
+    T->Min[w] = Min;
+    T->Best[w] = Best;
 }
@@ -0,0 +1,565 @@
+#include "LKH.h"
+#include <pthread.h>
+
+/*
+ * The MinimumSpanningTreeInParallel function determines a minimum spanning
+ * tree in the sparse graph given by the candidate sets using Boruvka's
+ * algorithm on a number of worker threads (THREADS). It is called by
+ * Minimum1TreeCost instead of MinimumSpanningTree during the subgradient
+ * optimization of large problems (see Ascent).
+ *
+ * The algorithm proceeds in rounds. In each round every component of the
+ * current forest selects its shortest edge to another component, and all
+ * selected edges are added to the forest. Since an edge that has become
+ * internal to a component stays so, the usable candidate edges of each
+ * node are kept in a list that is sorted lazily (by selection) from the
+ * front: a new shortest edge is selected only when the current one has
+ * become internal. The collection of the edges and the search for the
+ * shortest edges are divided among the workers, whereas the selected
+ * edges are merged into the forest (by union-find) by the calling thread.
+ * A node is dropped from the search as soon as all its candidate edges
+ * lie within its own component.
+ *
+ * Edges are compared by the same rules as in MinimumSpanningTree: fixed or
+ * common edges precede all other edges, and edges that would give a node
+ * more than two fixed edges are disregarded. Edges of equal cost are
+ * ordered by the Ids of their end nodes (see EdgeLess). With this total
+ * order the minimum spanning tree is unique.
+ *
+ * The nodes are then ordered as Prim's algorithm would include them,
+ * starting at FirstNode, by running Prim's algorithm on the tree edges
+ * only (the shortest edge leaving the included nodes is always a tree
+ * edge). Prim's algorithm uses its own heap, in which ties are broken by
+ * EdgeLess. Hence the tree, the order of the nodes and therefore the
+ * lower bound do not depend on the number of threads (for THREADS > 1).
+ * (The heap of MinimumSpanningTree breaks ties by the order of insertion,
+ * which cannot be reproduced by Boruvka's algorithm.)
+ *
+ * At return the fields Dad, Cost, Pred and Suc of the nodes are set as
+ * described for MinimumSpanningTree. Nodes that cannot be reached through
+ * candidate edges are connected to FirstNode with cost INT_MAX, as in
+ * MinimumSpanningTree. The candidate sets are assumed to be symmetric (as
+ * are those of the ascent); otherwise Prim's algorithm, which only uses
+ * the candidate edges of the included nodes, may choose another tree.
+ *
+ * The state of a call is kept in a SparseTree on the stack of the caller.
+ */
+
+enum Phases { COUNT, COLLECT, FIND_SHORTEST, RELABEL, FINISH };
+
+typedef struct Edge {
+    int Key;            /* Transformed cost, or INT_MIN for a fixed edge */
+    int To;             /* Id of the other end node */
+    int Pos;            /* Position in the candidate set of its node */
+} Edge;
+
+typedef struct SparseTree {
+    Node **AllNodes;    /* All nodes of the graph */
+    int Nodes;          /* Number of nodes in AllNodes */
+    Node **Active;      /* Nodes that may have edges to other components */
+    int Actives;        /* Number of nodes in Active */
+    Edge **Shortest;    /* Shortest edge from Active[i] to another
+                           component (or 0) */
+    int *Comp;          /* The component of a node, indexed by Id */
+    int *Parent;        /* Union-find tree of components, indexed by Id */
+    Edge *EdgeSet;      /* The usable candidate edges of all nodes */
+    int *Cursor;        /* Shortest remaining edge of a node in EdgeSet,
+                           indexed by Id */
+    int *End;           /* End of the edges of a node, indexed by Id */
+    int *Start;         /* Start of the tree edges of a node in Neighbor,
+                           indexed by Id (their end is End) */
+    int *Neighbor;      /* Id of the other end node of a tree edge */
+    int *NeighborKey;   /* Its key, as the Key of an Edge */
+    int *NeighborCost;  /* Its cost */
+    Node **Heap;        /* The heap of Prim's algorithm */
+    int HeapCount;      /* Number of nodes in Heap */
+    int Phase;          /* The work to be done by the threads */
+    int Workers;        /* Number of threads, including the calling one */
+    LKHContext *MainContext;    /* Context of the calling thread */
+    pthread_mutex_t Lock;
+    pthread_cond_t Released;
+    int Waiting, Generation;
+} SparseTree;
+
+typedef struct WorkerArg {
+    SparseTree *T;
+    int w;
+} WorkerArg;
+
+static void *Worker(void *Arg);
+static void RunPhase(SparseTree * T, int Phase);
+static void Work(SparseTree * T, int w);
+static void Barrier(SparseTree * T);
+static int Find(SparseTree * T, int Id);
+static int EdgeLess(int Key1, int a1, int b1, int Key2, int a2, int b2);
+static int Less(Node * a, Edge * Ea, Node * b, Edge * Eb);
+static int SelectShortest(SparseTree * T, Node * N, int k);
+static void Prim(SparseTree * T);
+static void Update(SparseTree * T, Node * Blue, Node * N, int Key,
+                   int Cost);
+static void SiftUp(SparseTree * T, Node * N);
+static void SiftDown(SparseTree * T, Node * N);
+
+#define EdgeCost(a, Na) ((Na)->Cost + (a)->Pi + NodeSet[(Na)->To].Pi)
+
+void MinimumSpanningTreeInParallel()
+{
+    SparseTree T;
+    pthread_t *Thread = 0;
+    WorkerArg *Arg = 0;
+    Node *N, *From, *To;
+    Edge *E;
+    int *CompBest, *Touched, *TreeKey, *TreeCost;
+    Node **TreeFrom, **TreeTo;
+    int MaxId = 0, Edges = 0, Merged, Touches, i, j, a, b;
+    long long Total;
+
+    N = FirstNode;
+    T.Nodes = 0;
+    do {
+        T.Nodes++;
+        if (N->Id > MaxId)
+            MaxId = N->Id;
+    } while ((N = N->Suc) != FirstNode);
+    assert(T.AllNodes = (Node **) malloc(T.Nodes * sizeof(Node *)));
+    assert(T.Heap = (Node **) malloc((T.Nodes + 1) * sizeof(Node *)));
+    i = 0;
+    do
+        T.AllNodes[i++] = N;
+    while ((N = N->Suc) != FirstNode);
+    T.Workers = Threads < T.Nodes ? Threads : T.Nodes;
+    assert(T.Active = (Node **) malloc(T.Nodes * sizeof(Node *)));
+    assert(T.Shortest = (Edge **) malloc(T.Nodes * sizeof(Edge *)));
+    assert(T.Comp = (int *) malloc((MaxId + 1) * sizeof(int)));
+    assert(T.Parent = (int *) malloc((MaxId + 1) * sizeof(int)));
+    assert(CompBest = (int *) malloc((MaxId + 1) * sizeof(int)));
+    assert(Touched = (int *) malloc(2 * T.Nodes * sizeof(int)));
+    assert(TreeFrom = (Node **) malloc(T.Nodes * sizeof(Node *)));
+    assert(TreeTo = (Node **) malloc(T.Nodes * sizeof(Node *)));
+    assert(TreeKey = (int *) malloc(T.Nodes * sizeof(int)));
+    assert(TreeCost = (int *) malloc(T.Nodes * sizeof(int)));
+    assert(T.Cursor = (int *) malloc((MaxId + 1) * sizeof(int)));
+    assert(T.End = (int *) malloc((MaxId + 1) * sizeof(int)));
+    for (i = 0; i < T.Nodes; i++) {
+        N = T.Active[i] = T.AllNodes[i];
+        T.Comp[N->Id] = T.Parent[N->Id] = N->Id;
+    }
+    T.Actives = T.Nodes;
+
+    pthread_mutex_init(&T.Lock, 0);
+    pthread_cond_init(&T.Released, 0);
+    T.Waiting = T.Generation = 0;
+    T.MainContext = SaveContext();
+    assert(Thread = (pthread_t *) malloc(T.Workers * sizeof(pthread_t)));
+    assert(Arg = (WorkerArg *) malloc(T.Workers * sizeof(WorkerArg)));
+    for (i = 1; i < T.Workers; i++) {
+        Arg[i].T = &T;
+        Arg[i].w = i;
+        if (pthread_create(&Thread[i], 0, Worker, &Arg[i]))
+            eprintf("Cannot create thread %d", i);
+    }
+    /* Collect the usable candidate edges of each node */
+    RunPhase(&T, COUNT);
+    for (i = 0, Total = 0; i < T.Nodes; i++) {
+        N = T.AllNodes[i];
+        T.Cursor[N->Id] = (int) Total;
+        Total += T.End[N->Id];
+    }
+    assert(Total < INT_MAX);
+    assert(T.EdgeSet = (Edge *) malloc((Total + 1) * sizeof(Edge)));
+    RunPhase(&T, COLLECT);
+    do {
+        RunPhase(&T, FIND_SHORTEST);
+        /* Let each component select its shortest edge, and drop the nodes
+           that have no edges to other components */
+        for (i = 0; i < T.Actives; i++)
+            CompBest[T.Comp[T.Active[i]->Id]] = -1;
+        for (i = j = 0; i < T.Actives; i++) {
+            if (!(E = T.Shortest[i]))
+                continue;
+            N = T.Active[j] = T.Active[i];
+            T.Shortest[j] = E;
+            a = T.Comp[N->Id];
+            if (CompBest[a] == -1 ||
+                Less(N, E, T.Active[CompBest[a]], T.Shortest[CompBest[a]]))
+                CompBest[a] = j;
+            j++;
+        }
+        T.Actives = j;
+        /* Add the selected edges to the forest */
+        Merged = Touches = 0;
+        for (i = 0; i < T.Actives; i++) {
+            From = T.Active[i];
+            if (CompBest[T.Comp[From->Id]] != i)
+                continue;
+            To = &NodeSet[T.Shortest[i]->To];
+            if ((a = Find(&T, T.Comp[From->Id])) ==
+                (b = Find(&T, T.Comp[To->Id])))
+                continue;
+            T.Parent[a] = b;
+            Touched[Touches++] = a;
+            Touched[Touches++] = b;
+            TreeFrom[Edges] = From;
+            TreeTo[Edges] = To;
+            TreeKey[Edges] = T.Shortest[i]->Key;
+            TreeCost[Edges++] =
+                EdgeCost(From, From->CandidateSet + T.Shortest[i]->Pos);
+            Merged = 1;
+        }
+        if (Merged) {
+            for (i = 0; i < Touches; i++)
+                T.Parent[Touched[i]] = Find(&T, Touched[i]);
+            RunPhase(&T, RELABEL);
+        }
+    } while (Merged && T.Actives > 0 && Edges < T.Nodes - 1);
+    T.Phase = FINISH;
+    Barrier(&T);
+    for (i = 1; i < T.Workers; i++)
+        pthread_join(Thread[i], 0);
+    FreeContext(T.MainContext);
+    pthread_mutex_destroy(&T.Lock);
+    pthread_cond_destroy(&T.Released);
+    free(Thread);
+    free(Arg);
+
+    /* Connect each component that cannot be reached from FirstNode to
+       FirstNode through its node with the smallest Id (the one that
+       Prim's algorithm would include first) */
+    if (Edges < T.Nodes - 1) {
+        for (i = 0; i < T.Nodes; i++)
+            CompBest[Find(&T, T.AllNodes[i]->Id)] = 0;
+        for (i = 0; i < T.Nodes; i++) {
+            N = T.AllNodes[i];
+            a = Find(&T, N->Id);
+            if (!CompBest[a] || N->Id < CompBest[a])
+                CompBest[a] = N->Id;
+        }
+        b = Find(&T, FirstNode->Id);
+        for (i = 0; i < T.Nodes; i++) {
+            N = T.AllNodes[i];
+            if ((a = Find(&T, N->Id)) == b || CompBest[a] != N->Id)
+                continue;
+            TreeFrom[Edges] = FirstNode;
+            TreeTo[Edges] = N;
+            TreeKey[Edges] = INT_MAX;
+            TreeCost[Edges++] = INT_MAX;
+        }
+    }
+
+    /* Collect the tree edges of each node, and let Prim's algorithm
+       order the nodes */
+    T.Start = CompBest;
+    for (i = 0; i < T.Nodes; i++)
+        T.End[T.AllNodes[i]->Id] = 0;
+    for (i = 0; i < Edges; i++) {
+        T.End[TreeFrom[i]->Id]++;
+        T.End[TreeTo[i]->Id]++;
+    }
+    for (i = j = 0; i < T.Nodes; i++) {
+        N = T.AllNodes[i];
+        T.Start[N->Id] = j;
+        j += T.End[N->Id];
+        T.End[N->Id] = T.Start[N->Id];
+    }
+    assert(T.Neighbor = (int *) malloc(2 * Edges * sizeof(int)));
+    assert(T.NeighborKey = (int *) malloc(2 * Edges * sizeof(int)));
+    assert(T.NeighborCost = (int *) malloc(2 * Edges * sizeof(int)));
+    for (i = 0; i < Edges; i++) {
+        j = T.End[TreeFrom[i]->Id]++;
+        T.Neighbor[j] = TreeTo[i]->Id;
+        T.NeighborKey[j] = TreeKey[i];
+        T.NeighborCost[j] = TreeCost[i];
+        j = T.End[TreeTo[i]->Id]++;
+        T.Neighbor[j] = TreeFrom[i]->Id;
+        T.NeighborKey[j] = TreeKey[i];
+        T.NeighborCost[j] = TreeCost[i];
+    }
+    Prim(&T);
+
+    free(T.Neighbor);
+    free(T.NeighborKey);
+    free(T.NeighborCost);
+    free(T.AllNodes);
+    free(T.Heap);
+    free(T.Active);
+    free(T.Shortest);
+    free(T.Comp);
+    free(T.Parent);
+    free(CompBest);
+    free(Touched);
+    free(TreeFrom);
+    free(TreeTo);
+    free(TreeKey);
+    free(TreeCost);
+    free(T.Cursor);
+    free(T.End);
+    free(T.EdgeSet);
+}
+
+static void *Worker(void *Arg)
+{
+    SparseTree *T = ((WorkerArg *) Arg)->T;
+    int w = ((WorkerArg *) Arg)->w;
+
+    LoadContext(T->MainContext);
+    for (;;) {
+        Barrier(T);
+        if (T->Phase == FINISH)
+            break;
+        Work(T, w);
+        Barrier(T);
+    }
+    return 0;
+}
+
+/* The RunPhase function lets all threads do the work of a phase. The calling
+   thread does its own share and waits for the others to finish */
+
+static void RunPhase(SparseTree * T, int Phase)
+{
+    T->Phase = Phase;
+    Barrier(T);
+    Work(T, 0);
+    Barrier(T);
+}
+
+static void Work(SparseTree * T, int w)
+{
+    Node *N;
+    Candidate *NN;
+    int i, Last, c, k;
+
+    if (T->Phase == COUNT || T->Phase == COLLECT || T->Phase == RELABEL) {
+        i = (int) ((long long) T->Nodes * w / T->Workers);
+        Last = (int) ((long long) T->Nodes * (w + 1) / T->Workers);
+    } else {
+        i = (int) ((long long) T->Actives * w / T->Workers);
+        Last = (int) ((long long) T->Actives * (w + 1) / T->Workers);
+    }
+    for (; i < Last; i++) {
+        if (T->Phase == COUNT) {
+            N = T->AllNodes[i];
+            for (NN = N->CandidateSet, k = 0; NN->To; NN++)
+                k++;
+            T->End[N->Id] = k;
+        } else if (T->Phase == COLLECT) {
+            N = T->AllNodes[i];
+            k = T->Cursor[N->Id];
+            for (NN = N->CandidateSet; NN->To; NN++) {
+                if (FixedOrCommon(N, CandidateNode(NN)))
+                    T->EdgeSet[k].Key = INT_MIN;
+                else if (!N->FixedTo2 && !NodeSet[NN->To].FixedTo2)
+                    T->EdgeSet[k].Key = EdgeCost(N, NN);
+                else
+                    continue;
+                T->EdgeSet[k].To = NN->To;
+                T->EdgeSet[k++].Pos = NN - N->CandidateSet;
+            }
+            T->End[N->Id] = k;
+            T->Cursor[N->Id] = SelectShortest(T, N, T->Cursor[N->Id]);
+        } else if (T->Phase == FIND_SHORTEST) {
+            N = T->Active[i];
+            c = T->Comp[N->Id];
+            k = T->Cursor[N->Id];
+            if (k < T->End[N->Id] &&
+                T->Comp[T->EdgeSet[k].To] == c)
+                T->Cursor[N->Id] = k = SelectShortest(T, N, k);
+            T->Shortest[i] = k < T->End[N->Id] ? &T->EdgeSet[k] : 0;
+        } else if (T->Phase == RELABEL) {
+            N = T->AllNodes[i];
+            T->Comp[N->Id] = T->Parent[T->Comp[N->Id]];
+        }
+    }
+}
+
+static void Barrier(SparseTree * T)
+{
+    int g;
+
+    if (T->Workers == 1)
+        return;
+    pthread_mutex_lock(&T->Lock);
+    g = T->Generation;
+    if (++T->Waiting == T->Workers) {
+        T->Waiting = 0;
+        T->Generation++;
+        pthread_cond_broadcast(&T->Released);
+    } else
+        while (g == T->Generation)
+            pthread_cond_wait(&T->Released, &T->Lock);
+    pthread_mutex_unlock(&T->Lock);
+}
+
+static int Find(SparseTree * T, int Id)
+{
+    int Root = Id, Next;
+
+    while (T->Parent[Root] != Root)
+        Root = T->Parent[Root];
+    while (Id != Root) {
+        Next = T->Parent[Id];
+        T->Parent[Id] = Root;
+        Id = Next;
+    }
+    return Root;
+}
+
+/* The SelectShortest function moves the shortest of the edges of node N
+   in EdgeSet[k .. End[N->Id] - 1] that leave the component of N to the
+   front of these edges. Edges found to be internal are dropped by moving
+   them before the shortest edge, whose position is returned */
+
+static int SelectShortest(SparseTree * T, Node * N, int k)
+{
+    Edge E, *EdgeSet = T->EdgeSet;
+    int j, Best = -1, c = T->Comp[N->Id];
+
+    for (j = k; j < T->End[N->Id]; j++) {
+        if (T->Comp[EdgeSet[j].To] == c) {
+            E = EdgeSet[j];
+            EdgeSet[j] = EdgeSet[k];
+            EdgeSet[k] = E;
+            if (Best == k)
+                Best = j;
+            k++;
+        } else if (Best == -1 ||
+                   EdgeLess(EdgeSet[j].Key, N->Id, EdgeSet[j].To,
+                            EdgeSet[Best].Key, N->Id, EdgeSet[Best].To))
+            Best = j;
+    }
+    if (Best != -1 && Best != k) {
+        E = EdgeSet[Best];
+        EdgeSet[Best] = EdgeSet[k];
+        EdgeSet[k] = E;
+    }
+    return k;
+}
+
+/* The EdgeLess function tests whether the edge (a1, b1) with key Key1
+   precedes the edge (a2, b2) with key Key2 (the nodes are given by their
+   Ids). Edges are ordered by their keys, then by the smaller Id of their
+   end nodes, and then by the larger Id */
+
+static int EdgeLess(int Key1, int a1, int b1, int Key2, int a2, int b2)
+{
+    int Low1 = a1 < b1 ? a1 : b1, Low2 = a2 < b2 ? a2 : b2;
+
+    if (Key1 != Key2)
+        return Key1 < Key2;
+    if (Low1 != Low2)
+        return Low1 < Low2;
+    return a1 + b1 - Low1 < a2 + b2 - Low2;
+}
+
+/* The Less function tests whether the edge Ea of node a precedes the
+   edge Eb of node b */
+
+static int Less(Node * a, Edge * Ea, Node * b, Edge * Eb)
+{
+    return EdgeLess(Ea->Key, a->Id, Ea->To, Eb->Key, b->Id, Eb->To);
+}
+
+/*
+ * The Prim function determines the minimum spanning tree by Prim's
+ * algorithm, starting at FirstNode, using the tree edges collected in
+ * T->Neighbor. The nodes are linked in the order in which they are included in the
+ * tree.
+ *
+ * As in MinimumSpanningTree, the Rank field of a node not in the tree is
+ * the key of its shortest edge to the tree, (Dad, Node), and Loc is its
+ * location in the heap. A node that has no edge to the tree has key
+ * INT_MAX and FirstNode as Dad.
+ */
+
+static void Prim(SparseTree * T)
+{
+    Node *Blue = FirstNode, *N;
+    int i;
+
+    T->HeapCount = 0;
+    Blue->Dad = 0;
+    Blue->Loc = 0;
+    for (i = 0; i < T->Nodes; i++) {
+        if ((N = T->AllNodes[i]) == Blue)
+            continue;
+        N->Dad = Blue;
+        N->Cost = N->Rank = INT_MAX;
+        T->Heap[++T->HeapCount] = N;
+        N->Loc = T->HeapCount;
+    }
+    for (i = T->HeapCount / 2; i >= 1; i--)
+        SiftDown(T, T->Heap[i]);
+    for (;;) {
+        /* Update all neighbors of the blue node */
+        for (i = T->Start[Blue->Id]; i < T->End[Blue->Id]; i++)
+            Update(T, Blue, &NodeSet[T->Neighbor[i]],
+                   T->NeighborKey[i], T->NeighborCost[i]);
+        if (!T->HeapCount)
+            break;
+        /* Include the foremost node of the heap */
+        N = T->Heap[1];
+        T->Heap[1] = T->Heap[T->HeapCount--];
+        T->Heap[1]->Loc = 1;
+        if (T->HeapCount)
+            SiftDown(T, T->Heap[1]);
+        N->Loc = 0;
+        Follow(N, Blue);
+        Blue = N;
+    }
+}
+
+/* The Update function makes the edge (Blue, N) with the given key and
+   cost the shortest edge from N to the tree if it precedes the current
+   one */
+
+static void Update(SparseTree * T, Node * Blue, Node * N, int Key,
+                   int Cost)
+{
+    if (N->Loc &&
+        EdgeLess(Key, Blue->Id, N->Id, N->Rank, N->Dad->Id, N->Id)) {
+        N->Dad = Blue;
+        N->Cost = Cost;
+        N->Rank = Key;
+        SiftUp(T, N);
+    }
+}
+
+/* Precedes(a, b) tests whether the shortest edge from node a to the tree
+   precedes that of node b */
+
+#define Precedes(a, b)\
+    EdgeLess((a)->Rank, (a)->Id, (a)->Dad->Id,\
+             (b)->Rank, (b)->Id, (b)->Dad->Id)
+
+static void SiftUp(SparseTree * T, Node * N)
+{
+    int Loc = N->Loc, Parent = Loc / 2;
+
+    while (Parent && Precedes(N, T->Heap[Parent])) {
+        T->Heap[Loc] = T->Heap[Parent];
+        T->Heap[Loc]->Loc = Loc;
+        Loc = Parent;
+        Parent /= 2;
+    }
+    T->Heap[Loc] = N;
+    N->Loc = Loc;
+}
+
+static void SiftDown(SparseTree * T, Node * N)
+{
+    int Loc = N->Loc, Child;
+
+    while (Loc <= T->HeapCount / 2) {
+        Child = 2 * Loc;
+        if (Child < T->HeapCount &&
+            Precedes(T->Heap[Child + 1], T->Heap[Child]))
+            Child++;
+        if (!Precedes(T->Heap[Child], N))
+            break;
+        T->Heap[Loc] = T->Heap[Child];
+        T->Heap[Loc]->Loc = Loc;
+        Loc = Child;
+    }
+    T->Heap[Loc] = N;
+    N->Loc = Loc;
+}
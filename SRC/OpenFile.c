@@ -0,0 +1,192 @@
+#define _GNU_SOURCE             /* For pipe2 */
+#include "LKH.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * The OpenFile function opens a file for reading (Mode "r") or writing
+ * (Mode "w") in the same way as fopen, except that compressed files are
+ * decompressed and compressed on the fly:
+ *
+ * A file that is opened for reading and starts with the signature of a
+ * gzip or zstd stream is read through a "gzip -dc" or "zstd -dc" process.
+ * A file that is opened for writing and whose name ends in ".gz" or ".zst"
+ * is written through a "gzip -c" or "zstd -c" process.
+ *
+ * The process is connected to the returned stream by a pipe, so the data
+ * are never stored uncompressed on disk. The stream is sequential; ftell
+ * and fseek do not work on it (ReadMappedSection falls back to reading
+ * the stream). A stream returned by OpenFile must be closed by CloseFile.
+ *
+ * All descriptors are opened with the close-on-exec flag, so they are not
+ * inherited by other processes started by the program. When a file is
+ * written through a compression program, SIGPIPE is ignored by the
+ * program (but not by the compression program). If the compression
+ * program dies, a write to the pipe then fails with EPIPE instead of
+ * killing the program, and the failure is reported by CloseFile.
+ *
+ * The function returns 0 if the file cannot be opened. This is also the
+ * case if a file cannot be written because its compression program cannot
+ * be started; the file is then removed.
+ */
+
+typedef struct Filter {
+    FILE *File;                 /* The stream of the caller */
+    pid_t Pid;                  /* The process of the program */
+    const char *Program;        /* The name of the program */
+    char *FileName;             /* The name of the file */
+    int Write;                  /* Specifies whether the file is written */
+    struct Filter *Next;
+} Filter;
+
+extern char **environ;
+
+static Filter *Filters;
+static pthread_mutex_t FilterLock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *Compressor(const char *FileName);
+static const char *Decompressor(int Fd);
+
+FILE *OpenFile(const char *FileName, const char *Mode)
+{
+    posix_spawn_file_actions_t Actions;
+    posix_spawnattr_t Attributes;
+    sigset_t Default;
+    int Write = Mode[0] == 'w', Fd, Pipe[2], Error;
+    const char *Program;
+    char *Argv[4];
+    Filter *F;
+
+    if ((Fd = open(FileName, (Write ? O_WRONLY | O_CREAT | O_TRUNC :
+                              O_RDONLY) | O_CLOEXEC, 0666)) < 0)
+        return 0;
+    if (!(Program = Write ? Compressor(FileName) : Decompressor(Fd)))
+        return fdopen(Fd, Mode);
+    if (pipe2(Pipe, O_CLOEXEC)) {
+        if (!Write)
+            eprintf("Cannot create pipe for \"%s\"", FileName);
+        close(Fd);
+        remove(FileName);
+        return 0;
+    }
+    if (Write)
+        signal(SIGPIPE, SIG_IGN);
+    /* The program gets the default action for SIGPIPE, so that a
+       decompression program whose reader has closed the pipe is
+       terminated (see CloseFile) */
+    posix_spawnattr_init(&Attributes);
+    sigemptyset(&Default);
+    sigaddset(&Default, SIGPIPE);
+    posix_spawnattr_setsigdefault(&Attributes, &Default);
+    posix_spawnattr_setflags(&Attributes, POSIX_SPAWN_SETSIGDEF);
+    posix_spawn_file_actions_init(&Actions);
+    posix_spawn_file_actions_adddup2(&Actions, Write ? Pipe[0] : Fd, 0);
+    posix_spawn_file_actions_adddup2(&Actions, Write ? Fd : Pipe[1], 1);
+    Argv[0] = (char *) Program;
+    Argv[1] = (char *) "-q";
+    Argv[2] = (char *) (Write ? "-c" : "-dc");
+    Argv[3] = 0;
+    assert(F = (Filter *) malloc(sizeof(Filter)));
+    Error = posix_spawnp(&F->Pid, Program, &Actions, &Attributes, Argv,
+                         environ);
+    posix_spawn_file_actions_destroy(&Actions);
+    posix_spawnattr_destroy(&Attributes);
+    close(Fd);
+    close(Write ? Pipe[0] : Pipe[1]);
+    if (Error) {
+        if (!Write)
+            eprintf("Cannot execute %s for \"%s\"", Program, FileName);
+        close(Pipe[1]);
+        free(F);
+        remove(FileName);
+        return 0;
+    }
+    assert(F->File = fdopen(Write ? Pipe[1] : Pipe[0], Mode));
+    F->Program = Program;
+    assert(F->FileName = (char *) malloc(strlen(FileName) + 1));
+    strcpy(F->FileName, FileName);
+    F->Write = Write;
+    pthread_mutex_lock(&FilterLock);
+    F->Next = Filters;
+    Filters = F;
+    pthread_mutex_unlock(&FilterLock);
+    return F->File;
+}
+
+/*
+ * The CloseFile function closes a stream returned by OpenFile. If the
+ * stream is connected to a compression program, the function waits for
+ * the program to finish. If a decompression program failed, an error is
+ * reported. A reader may close the stream before the end of the data; the
+ * decompression program is then terminated by SIGPIPE, which is not an
+ * error.
+ *
+ * The function returns the value of fclose, or EOF if a compression
+ * program failed. The caller decides how to report the failure (the tour
+ * writer thread must not terminate the program; see WriteTour).
+ */
+
+int CloseFile(FILE * File)
+{
+    Filter *F, **P;
+    int Result, Status;
+
+    pthread_mutex_lock(&FilterLock);
+    for (P = &Filters; (F = *P) && F->File != File; P = &F->Next);
+    if (F)
+        *P = F->Next;
+    pthread_mutex_unlock(&FilterLock);
+    Result = fclose(File);
+    if (!F)
+        return Result;
+    while (waitpid(F->Pid, &Status, 0) < 0)
+        if (errno != EINTR)
+            eprintf("Cannot wait for %s (\"%s\")", F->Program,
+                    F->FileName);
+    if (WIFEXITED(Status) ? WEXITSTATUS(Status) != 0 :
+        F->Write || !WIFSIGNALED(Status) || WTERMSIG(Status) != SIGPIPE) {
+        if (!F->Write)
+            eprintf("%s failed on \"%s\"", F->Program, F->FileName);
+        Result = EOF;
+    }
+    free(F->FileName);
+    free(F);
+    return Result;
+}
+
+/* The Compressor function returns the name of the program that compresses
+   the file FileName, as given by its suffix, or 0 if the file is not to
+   be compressed */
+
+static const char *Compressor(const char *FileName)
+{
+    size_t Length = strlen(FileName);
+
+    if (Length > 3 && !strcmp(FileName + Length - 3, ".gz"))
+        return "gzip";
+    if (Length > 4 && !strcmp(FileName + Length - 4, ".zst"))
+        return "zstd";
+    return 0;
+}
+
+/* The Decompressor function returns the name of the program that
+   decompresses the file with descriptor Fd, as given by the first bytes
+   of the file, or 0 if the file is not compressed */
+
+static const char *Decompressor(int Fd)
+{
+    unsigned char Magic[4];
+    ssize_t Bytes = pread(Fd, Magic, sizeof(Magic), 0);
+
+    if (Bytes >= 2 && Magic[0] == 0x1f && Magic[1] == 0x8b)
+        return "gzip";
+    if (Bytes == 4 && Magic[0] == 0x28 && Magic[1] == 0xb5 &&
+        Magic[2] == 0x2f && Magic[3] == 0xfd)
+        return "zstd";
+    return 0;
+}
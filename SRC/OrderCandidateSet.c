@@ -15,6 +15,11 @@
  * A non-zero value of Symmetric specifies that the candidate set is to be
  * complemented such that every candidate edge is associated with both its 
  * two end nodes (in this way MaxCandidates may be exceeded).
+ *
+ * If ALPHA_SUPERGRAPH is specified with a number of hops, H > 1, the
+ * candidate set is further augmented with the edges (i,k) for which k
+ * can be reached from i by following at most H edges of the minimum
+ * spanning tree.
  */
 
 #define Ancestor OldPred        /* Nearest possible least ancestor */
@@ -25,6 +30,11 @@
 
 static int BetaValue(Node * From, Node * To);
 static Candidate *FindCandidate(Node * From, Node * To);
+static void Augment(Node * From, Node * To, GainType MaxAlpha);
+static void AugmentTreeNeighbors(Node * From, Node * N, Node * Prev,
+                                 int Hops, GainType MaxAlpha);
+
+static THREAD_LOCAL Node **FirstSon, **NextSon;
 #undef max
 static int max(const int a, const int b);
 
@@ -32,8 +42,9 @@ void OrderCandidateSet(int MaxCandidates, GainType MaxAlpha, int Symmetric)
 {
     Node *From, *To, *N;
     Candidate *NFrom, *NN;
-    int Alpha, Beta;
+    int Beta, Hops;
 
+    CandidateIndexValid = 0;
     if (TraceLevel >= 2)
         printff("Ordering candidates ... ");
     if (MaxAlpha < 0 || MaxAlpha > INT_MAX)
@@ -84,7 +95,7 @@ void OrderCandidateSet(int MaxCandidates, GainType MaxAlpha, int Symmetric)
 
     /* Compute Alpha-values for candidates */
     do {
-        for (NFrom = From->CandidateSet; NFrom && (To = NFrom->To);
+        for (NFrom = From->CandidateSet; NFrom && (To = CandidateNode(NFrom));
              NFrom++) {
             if (FixedOrCommon(From, To))
                 NFrom->Alpha = INT_MIN;
@@ -105,6 +116,13 @@ void OrderCandidateSet(int MaxCandidates, GainType MaxAlpha, int Symmetric)
     while ((From = From->Suc) != FirstNode);
 
     if (MaxCandidates > 0 && !DelaunayPure) {
+        Hops = AlphaSupergraph ? AlphaSupergraphHops : 0;
+        if (Hops > 1) {
+            assert(FirstSon =
+                   (Node **) calloc(1 + DimensionSaved, sizeof(Node *)));
+            assert(NextSon =
+                   (Node **) malloc((1 + DimensionSaved) * sizeof(Node *)));
+        }
         do {
             int Count = 0;
             for (NFrom = From->CandidateSet; NFrom->To; NFrom++)
@@ -112,6 +130,10 @@ void OrderCandidateSet(int MaxCandidates, GainType MaxAlpha, int Symmetric)
             From->OriginalCandidates = Count;
             From->Mark = 0;
             From->AlphaComputed = 0;
+            if (Hops > 1 && (To = From->Dad)) {
+                NextSon[From->Id] = FirstSon[To->Id];
+                FirstSon[To->Id] = From;
+            }
         }
         while ((From = From->Suc) != FirstNode);
 
@@ -120,37 +142,21 @@ void OrderCandidateSet(int MaxCandidates, GainType MaxAlpha, int Symmetric)
             int i, j;
             From->Mark = From;
             for (i = 0; i < From->OriginalCandidates; i++) {
-                N = From->CandidateSet[i].To;
+                N = CandidateNode(&From->CandidateSet[i]);
                 N->Mark = From;
-                for (j = 0; j < N->OriginalCandidates; j++) {
-                    To = N->CandidateSet[j].To;
-                    if (To->Mark == From)
-                        continue;
-                    To->Mark = From;
-                    if (FindCandidate(From, To))
-                        continue;
-                    if (FixedOrCommon(From, To))
-                        Alpha = INT_MIN;
-                    else if (From->FixedTo2 || To->FixedTo2
-                             || Forbidden(From, To))
-                        continue;
-                    else if ((NN = FindCandidate(To, From)))
-                        Alpha = NN->Alpha;
-                    else {
-                        if (To->AlphaComputed)
-                            continue;
-                        Beta = BetaValue(From, To);
-                        if (Beta == INT_MIN)
-                            continue;
-                        Alpha = max(D(From, To) - Beta, 0);
-                    }
-                    if (Alpha <= MaxAlpha)
-                        AddCandidate(From, To, D(From, To), Alpha);
-                }
+                for (j = 0; j < N->OriginalCandidates; j++)
+                    Augment(From, CandidateNode(&N->CandidateSet[j]),
+                            MaxAlpha);
             }
+            if (Hops > 1)
+                AugmentTreeNeighbors(From, From, 0, Hops, MaxAlpha);
             From->AlphaComputed = 1;
         }
         while ((From = From->Suc) != FirstNode);
+        if (Hops > 1) {
+            free(FirstSon);
+            free(NextSon);
+        }
     }
 
     /* Order candidates according to their Alpha-values */
@@ -212,6 +218,63 @@ static int BetaValue(Node * From, Node * To)
     return Beta;
 }
 
+/*
+ * The Augment function adds the edge (From,To) to the candidate set of 
+ * From, unless it is already present, is known to have an Alpha-value
+ * greater than MaxAlpha, or cannot be a candidate edge. Nodes that have
+ * been considered for the current From node are marked with From.
+ */
+
+static void Augment(Node * From, Node * To, GainType MaxAlpha)
+{
+    Candidate *NN;
+    int Alpha, Beta;
+
+    if (To->Mark == From)
+        return;
+    To->Mark = From;
+    if (FindCandidate(From, To))
+        return;
+    if (FixedOrCommon(From, To))
+        Alpha = INT_MIN;
+    else if (From->FixedTo2 || To->FixedTo2 || Forbidden(From, To))
+        return;
+    else if ((NN = FindCandidate(To, From)))
+        Alpha = NN->Alpha;
+    else {
+        if (To->AlphaComputed)
+            return;
+        Beta = BetaValue(From, To);
+        if (Beta == INT_MIN)
+            return;
+        Alpha = max(D(From, To) - Beta, 0);
+    }
+    if (Alpha <= MaxAlpha)
+        AddCandidate(From, To, D(From, To), Alpha);
+}
+
+/*
+ * The AugmentTreeNeighbors function augments the candidate set of From
+ * with the nodes that can be reached from N by following at most Hops
+ * edges of the minimum spanning tree without returning to Prev.
+ */
+
+static void AugmentTreeNeighbors(Node * From, Node * N, Node * Prev,
+                                 int Hops, GainType MaxAlpha)
+{
+    Node *Son;
+
+    if (N != From)
+        Augment(From, N, MaxAlpha);
+    if (Hops-- == 0)
+        return;
+    if (N->Dad && N->Dad != Prev)
+        AugmentTreeNeighbors(From, N->Dad, N, Hops, MaxAlpha);
+    for (Son = FirstSon[N->Id]; Son; Son = NextSon[Son->Id])
+        if (Son != Prev)
+            AugmentTreeNeighbors(From, Son, N, Hops, MaxAlpha);
+}
+
 /*
  * The FindCandidate function returns the Candidate structure that is
  * associated with the node From and is pointing to the node To. The
@@ -222,7 +285,7 @@ static Candidate *FindCandidate(Node * From, Node * To)
 {
     Candidate *NFrom;
     for (NFrom = From->CandidateSet; NFrom->To; NFrom++)
-        if (NFrom->To == To)
+        if (NFrom->To == To->Id)
             return NFrom;
     return 0;
 }
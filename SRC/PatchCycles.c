@@ -21,7 +21,7 @@ static GainType PatchCyclesRec(int k, int m, int M, GainType G0);
 static int ShortestCycle(int M, int k);
 static int Cycle(Node * N, int k);
 
-static int CurrentCycle, Patchwork = 0, RecLevel = 0;
+static THREAD_LOCAL int CurrentCycle, Patchwork = 0, RecLevel = 0;
 #define MaxPatchwork Dimension
 
 /*
@@ -87,7 +87,7 @@ static GainType PatchCyclesRec(int k, int m, int M, GainType G0)
     incl[incl[i] = i + 1] = i;
 
     /* Choose (s2,s3) as a candidate edge emanating from s2 */
-    for (Ns2 = s2->CandidateSet; (s3 = Ns2->To); Ns2++) {
+    for (Ns2 = s2->CandidateSet; (s3 = CandidateNode(Ns2)); Ns2++) {
         if (s3 == s2->Pred || s3 == s2->Suc || Added(s2, s3) ||
             (NewCycle = Cycle(s3, k)) == CurrentCycle)
             continue;
@@ -151,7 +151,7 @@ static GainType PatchCyclesRec(int k, int m, int M, GainType G0)
         incl[incl[2 * k + 1] = 2 * (k + m) + 2] = 2 * k + 1;
         Breadth2 = 0;
         /* Choose (s2,s3) as a candidate edge emanating from s2 */
-        for (Ns2 = s2->CandidateSet; (s3 = Ns2->To); Ns2++) {
+        for (Ns2 = s2->CandidateSet; (s3 = CandidateNode(Ns2)); Ns2++) {
             if (s3 == s2->Pred || s3 == s2->Suc || Added(s2, s3))
                 continue;
             if (++Breadth2 > MaxBreadth)
@@ -168,7 +168,8 @@ static GainType PatchCyclesRec(int k, int m, int M, GainType G0)
                 G2 = G1 + C(s3, s4);
                 Breadth4 = 0;
                 /* Choose (s4,s5) as a candidate edge emanating from s4 */
-                for (Ns4 = s4->CandidateSet; (s5 = Ns4->To); Ns4++) {
+                for (Ns4 = s4->CandidateSet;
+                     (s5 = CandidateNode(Ns4)); Ns4++) {
                     if (s5 == s4->Pred || s5 == s4->Suc || s5 == s1 ||
                         Added(s4, s5) ||
                         (NewCycle == CurrentCycle &&
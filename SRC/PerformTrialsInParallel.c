@@ -0,0 +1,229 @@
+#include "LKH.h"
+#include <pthread.h>
+
+/*
+ * The PerformTrialsInParallel function is called by FindTour instead of
+ * the sequential loop over the trials when TRIAL_THREADS > 1.
+ *
+ * The trials are performed by TrialThreads worker threads. Each worker
+ * loads the context of the calling thread and works on private copies of
+ * the tour and the candidate sets (see CopyStructures). A worker performs
+ * its trials as in the sequential case (see PerformTrial), but uses its
+ * own sequence of random numbers. The total number of trials performed
+ * by the workers is limited by MaxTrials.
+ *
+ * Every TrialExchangeInterval trials a worker exchanges tours with the
+ * other workers through a shared tour: the better one of its own best
+ * tour and the shared tour is merged with the other one by means of
+ * MergeWithTour. If the result is better than the worker's own best tour,
+ * it is recorded as such. If the worker's best tour is better than the
+ * shared tour, it replaces the shared tour.
+ *
+ * At return, the BestSuc fields of the nodes of the calling thread
+ * represent the best tour found, BetterCost is its cost, and Trial is
+ * the number of trials performed.
+ */
+
+typedef struct TrialPool {
+    pthread_mutex_t Lock;
+    LKHContext *Context;        /* Context of the calling thread */
+    int *Tour;          /* Shared best tour */
+    GainType Cost;      /* Cost of the shared tour */
+    int Version;        /* Number of updates of the shared tour */
+    int Trials;         /* Number of trials started */
+    int Stop;           /* Specifies whether the workers should stop */
+    int TraceLevel;     /* TraceLevel of the calling thread */
+    char *OutputTourFileName;   /* OutputTourFileName of the calling thread */
+} TrialPool;
+
+typedef struct TrialWorker {
+    pthread_t Thread;
+    TrialPool *Pool;
+    unsigned Seed;      /* Seed for the worker's random numbers */
+    CacheCounts Counts; /* The worker's distance cache statistics */
+} TrialWorker;
+
+static void *Worker(void *Arg);
+static void Exchange(TrialPool * P, int *Version, double EntryTime);
+static void TourToNext(int *Tour);
+
+void PerformTrialsInParallel()
+{
+    TrialPool P;
+    TrialWorker *W;
+    Node *N;
+    int i;
+
+    pthread_mutex_init(&P.Lock, 0);
+    P.Context = SaveContext();
+    assert(P.Tour = (int *) malloc((DimensionSaved + 1) * sizeof(int)));
+    P.Cost = PLUS_INFINITY;
+    P.Version = P.Trials = P.Stop = 0;
+    P.TraceLevel = TraceLevel;
+    P.OutputTourFileName = OutputTourFileName;
+    assert(W = (TrialWorker *) malloc(TrialThreads * sizeof(TrialWorker)));
+    for (i = 0; i < TrialThreads; i++) {
+        W[i].Pool = &P;
+        W[i].Seed = Random();
+    }
+    for (i = 0; i < TrialThreads; i++)
+        if (pthread_create(&W[i].Thread, 0, Worker, &W[i]))
+            eprintf("Cannot create thread %d", i + 1);
+    for (i = 0; i < TrialThreads; i++) {
+        pthread_join(W[i].Thread, 0);
+        AddCacheCounts(&W[i].Counts);
+    }
+    if (P.Cost != PLUS_INFINITY) {
+        TourToNext(P.Tour);
+        for (i = 1; i <= Dimension; i++) {
+            N = &NodeSet[i];
+            N->Suc = Cold(N)->BestSuc = N->Next;
+        }
+        memcpy(BetterTour, P.Tour, (DimensionSaved + 1) * sizeof(int));
+        BetterCost = P.Cost;
+    }
+    Trial = P.Trials < MaxTrials ? P.Trials : MaxTrials;
+    FreeContext(P.Context);
+    free(P.Tour);
+    free(W);
+    pthread_mutex_destroy(&P.Lock);
+}
+
+static void *Worker(void *Arg)
+{
+    TrialWorker *W = (TrialWorker *) Arg;
+    TrialPool *P = W->Pool;
+    int Version = 0, Stop;
+    double EntryTime;
+
+    LoadContext(P->Context);
+    CopyStructures();
+    SRandom(W->Seed);
+    TraceLevel = 0;
+    OutputTourFileName = 0;
+    HashInitialize(HTable);
+    EntryTime = GetTime();
+    for (Trial = 1;; Trial++) {
+        pthread_mutex_lock(&P->Lock);
+        if (!(Stop = P->Stop || P->Trials >= MaxTrials))
+            P->Trials++;
+        pthread_mutex_unlock(&P->Lock);
+        if (Stop)
+            break;
+        if (!PerformTrial(EntryTime)) {
+            pthread_mutex_lock(&P->Lock);
+            P->Stop = 1;
+            pthread_mutex_unlock(&P->Lock);
+            break;
+        }
+        if (Trial % TrialExchangeInterval == 0)
+            Exchange(P, &Version, EntryTime);
+    }
+    Exchange(P, &Version, EntryTime);
+    TakeCacheCounts(&W->Counts);
+    FreeCopiedStructures();
+    return 0;
+}
+
+/*
+ * The Exchange function merges the best tour of the calling worker with
+ * the shared tour, and updates the shared tour if the worker's best tour
+ * is better. EntryTime is the time at which the worker was started.
+ */
+
+static void Exchange(TrialPool * P, int *Version, double EntryTime)
+{
+    GainType Cost;
+    Node *N;
+    int i;
+
+    if (BetterCost == PLUS_INFINITY)
+        return;
+    pthread_mutex_lock(&P->Lock);
+    if (P->Cost != PLUS_INFINITY && P->Version != *Version) {
+        TourToNext(P->Tour);
+        if (P->Cost < BetterCost) {
+            /* Merge the shared tour with the worker's best tour */
+            Hash = 0;
+            for (i = 1; i <= Dimension; i++) {
+                N = &NodeSet[i];
+                N->Suc = N->Next;
+                Hash ^= Rand[N->Id] * Rand[N->Suc->Id];
+            }
+            for (i = 1; i <= Dimension; i++) {
+                N = &NodeSet[i];
+                N->Next = Cold(N)->BestSuc;
+            }
+        } else {
+            /* Merge the worker's best tour with the shared tour */
+            for (i = 1; i <= Dimension; i++) {
+                N = &NodeSet[i];
+                N->Suc = Cold(N)->BestSuc;
+            }
+        }
+        Cost = MergeWithTour();
+        if (Cost < BetterCost) {
+            BetterCost = Cost;
+            RecordBetterTour();
+            AdjustCandidateSet();
+            HashInitialize(HTable);
+            HashInsert(HTable, Hash, Cost);
+        }
+    }
+    if (BetterCost < P->Cost) {
+        memcpy(P->Tour, BetterTour, (DimensionSaved + 1) * sizeof(int));
+        P->Cost = BetterCost;
+        P->Version++;
+        TraceLevel = P->TraceLevel;
+        if (TraceLevel >= 1) {
+            printff("* %d: Cost = " GainFormat, P->Trials, BetterCost);
+            if (Optimum != MINUS_INFINITY && Optimum != 0)
+                printff(", Gap = %0.4f%%",
+                        100.0 * (BetterCost - Optimum) / Optimum);
+            printff(", Time = %0.2f sec. %s\n",
+                    fabs(GetTime() - EntryTime),
+                    BetterCost < Optimum ? "<" :
+                    BetterCost == Optimum ? "=" : "");
+        }
+        if (BetterCost < BestCost) {
+            OutputTourFileName = P->OutputTourFileName;
+            WriteTour(OutputTourFileName, BetterTour, BetterCost);
+            OutputTourFileName = 0;
+        }
+        TraceLevel = 0;
+        if (StopAtOptimum && BetterCost == Optimum)
+            P->Stop = 1;
+    }
+    *Version = P->Version;
+    pthread_mutex_unlock(&P->Lock);
+}
+
+/*
+ * The TourToNext function lets the Next fields of the nodes represent
+ * the tour given in the array Tour (in the format of BetterTour).
+ */
+
+static void TourToNext(int *Tour)
+{
+    Node *N1, *N2, *M1, *M2;
+    int i;
+
+    if (ProblemType != ATSP) {
+        for (i = 1; i <= Dimension; i++) {
+            N1 = &NodeSet[Tour[i - 1]];
+            N2 = &NodeSet[Tour[i]];
+            N1->Next = N2;
+        }
+    } else {
+        int Dim = Dimension / 2;
+        for (i = 1; i <= Dim; i++) {
+            N1 = &NodeSet[Tour[i - 1]];
+            N2 = &NodeSet[Tour[i]];
+            M1 = &NodeSet[N1->Id + Dim];
+            M2 = &NodeSet[N2->Id + Dim];
+            M1->Next = N1;
+            N1->Next = M2;
+            M2->Next = N2;
+        }
+    }
+}
@@ -10,9 +10,20 @@ void PrintParameters()
 {
     int i;
 
+    if (AlphaSupergraph == 0)
+        printff("# ALPHA_SUPERGRAPH =\n");
+    else
+        printff("ALPHA_SUPERGRAPH = %s %d\n",
+                AlphaSupergraph == DELAUNAY ? "DELAUNAY" : "QUADRANT",
+                AlphaSupergraphHops);
     printff("ASCENT_CANDIDATES = %d\n", AscentCandidates);
     printff("BACKBONE_TRIALS = %d\n", BackboneTrials);
     printff("BACKTRACKING = %s\n", Backtracking ? "YES" : "NO");
+    printff("%sBINARY_PROBLEM_FILE = %s\n",
+            BinaryProblemFileName ? "" : "# ",
+            BinaryProblemFileName ? BinaryProblemFileName : "");
+    printff("%sCACHE_DIRECTORY = %s\n",
+            CacheDirectory ? "" : "# ", CacheDirectory ? CacheDirectory : "");
     if (CandidateFiles == 0)
         printff("# CANDIDATE_FILE =\n");
     else
@@ -24,6 +35,10 @@ void PrintParameters()
             CandidateSetType == NN ? "NEAREST-NEIGHBOR" :
             CandidateSetType == QUADRANT ? "QUADRANT" : "",
             DelaunayPure ? " PURE" : "");
+    if (DistanceCacheSize >= 0)
+        printff("DISTANCE_CACHE_SIZE = %d\n", DistanceCacheSize);
+    else
+        printff("# DISTANCE_CACHE_SIZE =\n");
     if (Excess >= 0)
         printff("EXCESS = %g\n", Excess);
     else
@@ -78,6 +93,7 @@ void PrintParameters()
         for (i = 0; i < MergeTourFiles; i++)
             printff("MERGE_TOUR_FILE = %s\n", MergeTourFileName[i]);
     printff("MOVE_TYPE = %d\n", MoveType);
+    printff("NODE_RENUMBERING = %s\n", NodeRenumbering ? "YES" : "NO");
     printff("%sNONSEQUENTIAL_MOVE_TYPE = %d\n",
             PatchingA > 1 ? "" : "# ", NonsequentialMoveType);
     if (Optimum == MINUS_INFINITY)
@@ -127,11 +143,20 @@ void PrintParameters()
             SubsequentMoveType == 0 ? MoveType : SubsequentMoveType);
     printff("SUBSEQUENT_PATCHING = %s\n",
             SubsequentPatching ? "YES" : "NO");
+    printff("THREADS = %d\n", Threads);
     if (TimeLimit == DBL_MAX)
         printff("# TIME_LIMIT =\n");
     else
         printff("TIME_LIMIT = %0.1f\n", TimeLimit);
     printff("%sTOUR_FILE = %s\n",
             TourFileName ? "" : "# ", TourFileName ? TourFileName : "");
-    printff("TRACE_LEVEL = %d\n\n", TraceLevel);
+    printff("TRACE_LEVEL = %d\n", TraceLevel);
+    if (TreeType == -1)
+        printff("# TREE_TYPE =\n");
+    else
+        printff("TREE_TYPE = %s\n",
+                TreeType == ONE_LEVEL ? "ONE-LEVEL" :
+                TreeType == TWO_LEVEL ? "TWO-LEVEL" : "THREE-LEVEL");
+    printff("TRIAL_EXCHANGE_INTERVAL = %d\n", TrialExchangeInterval);
+    printff("TRIAL_THREADS = %d\n\n", TrialThreads);
 }
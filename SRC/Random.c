@@ -15,8 +15,7 @@
  * pseudo-random numbers.  
  */
 
-unsigned Random(void);
-void SRandom(unsigned Seed);
+#include "LKH.h"
 
 #undef STDLIB_RANDOM
 /* #define STDLIB_RANDOM */
@@ -38,7 +37,7 @@ void SRandom(unsigned Seed)
 #include <limits.h>
 #define PRANDMAX INT_MAX
 
-static int a = 0, b = 24, arr[55], initialized = 0;
+static THREAD_LOCAL int a = 0, b = 24, arr[55], initialized = 0;
 
 unsigned Random()
 {
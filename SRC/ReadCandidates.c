@@ -1,4 +1,5 @@
 #include "LKH.h"
+#include <sys/mman.h>
 
 /*
  * The ReadCandidates function attempts to read candidate edges from 
@@ -12,6 +13,11 @@
  * candidate edges. For each candidate edge its end node number and 
  * alpha-value are given.
  *
+ * A file in the binary form written by WriteCandidates (starting with
+ * CandidateMagic) is read from a memory mapping of the file. If no
+ * candidate sets have been allocated yet, the candidate edges are stored
+ * directly in a single block of memory (CandidateArena).
+ *
  * The parameter MaxCandidates specifies the maximum number of candidate edges 
  * allowed for each node.
  *
@@ -20,36 +26,52 @@
  * The function is called from the CreateCandidateSet function. 
  */
 
+static void ReadBinaryCandidates(const char *Map, size_t Size,
+                                 int Dimension, const char *FileName);
+static Candidate *StoreCandidates(Node * From, const int *Edge, int Count,
+                                  Candidate * Set, int Dimension);
+
 int ReadCandidates(int MaxCandidates)
 {
     FILE *CandidateFile = 0;
     Node *From, *To;
     int Dimension, i, f, Id, Alpha, Count;
+    char *Map;
+    size_t Size;
 
     if (CandidateFiles == 0 ||
         (CandidateFiles == 1 &&
-         !(CandidateFile = fopen(CandidateFileName[0], "r"))))
+         !(CandidateFile = OpenFile(CandidateFileName[0], "r"))))
         return 0;
     Dimension = ProblemType != ATSP ? DimensionSaved : 2 * DimensionSaved;
     for (f = 0; f < CandidateFiles; f++) {
         if (CandidateFiles >= 2 &&
-            !(CandidateFile = fopen(CandidateFileName[f], "r")))
+            !(CandidateFile = OpenFile(CandidateFileName[f], "r")))
             eprintf("Cannot open CANDIDATE_FILE: \"%s\"",
                     CandidateFileName[f]);
         if (TraceLevel >= 1)
             printff("Reading CANDIDATE_FILE: \"%s\" ... ",
                     CandidateFileName[f]);
+        if ((Map = MapBinaryFile(CandidateFile, CandidateMagic, &Size))) {
+            ReadBinaryCandidates(Map, Size, Dimension,
+                                 CandidateFileName[f]);
+            munmap(Map, Size);
+            CloseFile(CandidateFile);
+            if (TraceLevel >= 1)
+                printff("done\n");
+            continue;
+        }
         fscanint(CandidateFile, &i);
         if (i != Dimension)
             eprintf("CANDIDATE_FILE \"%s\" does not match problem",
                     CandidateFileName[f]);
         while (fscanint(CandidateFile, &Id) == 1 && Id != -1) {
             assert(Id >= 1 && Id <= Dimension);
-            From = &NodeSet[Id];
+            From = &NodeSet[InternalId(Id)];
             fscanint(CandidateFile, &Id);
             assert(Id >= 0 && Id <= Dimension);
             if (Id > 0)
-                From->Dad = &NodeSet[Id];
+                From->Dad = &NodeSet[InternalId(Id)];
             assert(From != From->Dad);
             fscanint(CandidateFile, &Count);
             assert(Count >= 0 && Count < Dimension);
@@ -59,12 +81,12 @@ int ReadCandidates(int MaxCandidates)
             for (i = 0; i < Count; i++) {
                 fscanint(CandidateFile, &Id);
                 assert(Id >= 1 && Id <= Dimension);
-                To = &NodeSet[Id];
+                To = &NodeSet[InternalId(Id)];
                 fscanint(CandidateFile, &Alpha);
                 AddCandidate(From, To, D(From, To), Alpha);
             }
         }
-        fclose(CandidateFile);
+        CloseFile(CandidateFile);
         if (TraceLevel >= 1)
             printff("done\n");
     }
@@ -73,3 +95,106 @@ int ReadCandidates(int MaxCandidates)
         TrimCandidateSet(MaxCandidates);
     return 1;
 }
+
+/*
+ * The ReadBinaryCandidates function reads the candidate edges of a
+ * binary file (see WriteCandidates), mapped into memory at Map.
+ *
+ * If CandidateArena has not been allocated, it is allocated with room for
+ * all candidate edges of the file, and the candidate sets of the nodes
+ * that have none are stored in it (see StoreCandidates). Otherwise, the
+ * candidate edges are added by AddCandidate, as for a text file.
+ */
+
+static void ReadBinaryCandidates(const char *Map, size_t Size,
+                                 int Dimension, const char *FileName)
+{
+    const long long *Header = (const long long *) Map;
+    const int *Dad, *Count, *Edge;
+    long long Edges = 0;
+    Candidate *Next = 0;
+    Node *From, *To;
+    int i, j;
+
+    if (Size < CANDIDATE_HEADER_FIELDS * sizeof(long long) ||
+        Header[CANDIDATE_DIMENSION] != Dimension)
+        eprintf("CANDIDATE_FILE \"%s\" does not match problem", FileName);
+    Dad = (const int *) (Header + CANDIDATE_HEADER_FIELDS);
+    Count = Dad + Dimension;
+    Edge = Count + Dimension;
+    if (Size < (size_t) ((const char *) Edge - Map))
+        eprintf("CANDIDATE_FILE \"%s\" is truncated", FileName);
+    for (i = 0; i < Dimension; i++) {
+        assert(Count[i] >= 0 && Count[i] < Dimension);
+        Edges += Count[i];
+    }
+    if (Edges != Header[CANDIDATE_EDGES] ||
+        Size != (size_t) ((const char *) Edge - Map) +
+        2 * Edges * sizeof(int))
+        eprintf("CANDIDATE_FILE \"%s\" is truncated", FileName);
+    if (!CandidateArena) {
+        CandidateArenaSize = Edges + Dimension;
+        assert(CandidateArena =
+               (Candidate *) malloc(CandidateArenaSize *
+                                    sizeof(Candidate)));
+        Next = CandidateArena;
+    }
+    CandidateIndexValid = 0;
+    for (i = 0; i < Dimension; Edge += 2 * Count[i++]) {
+        From = &NodeSet[InternalId(i + 1)];
+        assert(Dad[i] >= 0 && Dad[i] <= Dimension);
+        if (Dad[i] > 0)
+            From->Dad = &NodeSet[InternalId(Dad[i])];
+        assert(From != From->Dad);
+        if (Next && !From->CandidateSet) {
+            From->CandidateSet = Next;
+            Next = StoreCandidates(From, Edge, Count[i], Next, Dimension);
+            continue;
+        }
+        if (!From->CandidateSet)
+            assert(From->CandidateSet =
+                   (Candidate *) calloc(Count[i] + 1, sizeof(Candidate)));
+        for (j = 0; j < 2 * Count[i]; j += 2) {
+            assert(Edge[j] >= 1 && Edge[j] <= Dimension);
+            To = &NodeSet[InternalId(Edge[j])];
+            AddCandidate(From, To, D(From, To), Edge[j + 1]);
+        }
+    }
+}
+
+/*
+ * The StoreCandidates function stores the Count candidate edges at Edge
+ * (pairs of end node number and alpha-value) as the candidate set of node
+ * From, starting at Set, and returns a pointer to the entry after the
+ * terminating entry of the set. The edges are stored as if they had been
+ * added one by one by AddCandidate.
+ */
+
+static Candidate *StoreCandidates(Node * From, const int *Edge, int Count,
+                                  Candidate * Set, int Dimension)
+{
+    Candidate *NFrom, *End = Set;
+    Node *To;
+    int j;
+
+    for (j = 0; j < Count; j++, Edge += 2) {
+        assert(Edge[0] >= 1 && Edge[0] <= Dimension);
+        To = &NodeSet[InternalId(Edge[0])];
+        if (From->Subproblem != FirstNode->Subproblem || From == To ||
+            To->Subproblem != FirstNode->Subproblem ||
+            !IsPossibleCandidate(From, To))
+            continue;
+        for (NFrom = Set; NFrom < End && NFrom->To != To->Id; NFrom++);
+        if (NFrom < End) {
+            if (NFrom->Alpha == INT_MAX)
+                NFrom->Alpha = Edge[1];
+            continue;
+        }
+        End->To = To->Id;
+        End->Cost = D(From, To);
+        End->Alpha = Edge[1];
+        End++;
+    }
+    End->To = 0;
+    return End + 1;
+}
@@ -6,8 +6,8 @@
  * return, a newline, both, or EOF.
  */
 
-static char *Buffer;
-static int MaxBuffer;
+static THREAD_LOCAL char *Buffer;
+static THREAD_LOCAL int MaxBuffer;
 
 static int EndOfLine(FILE * InputFile, int c)
 {
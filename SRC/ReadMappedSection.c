@@ -0,0 +1,275 @@
+#include "LKH.h"
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * The ReadMappedSection function reads the data of a section of a problem
+ * file (for example, NODE_COORD_SECTION) from a memory mapping of the file
+ * instead of through the stream File. The section starts at the current
+ * position of File and consists of a given number of whitespace-separated
+ * tokens.
+ *
+ * The text from the current position to the end of the file is divided
+ * into chunks, one for each worker thread (at most THREADS). The chunk
+ * boundaries are moved forward to whitespace, so that no token is split.
+ * The workers first count the tokens of their chunks. Then each worker
+ * calls the function Parse for the tokens of its chunk that belong to the
+ * section, knowing the index of its first token in the section. Small
+ * sections are read by the calling thread alone.
+ *
+ * Parse must return a pointer to the character after its last token if
+ * all its tokens were parsed; otherwise 0. It must not change any state
+ * that a later parse of the same tokens by the stream-based code would not
+ * overwrite. The functions ScanInt and ScanDouble may be used for the
+ * parsing.
+ *
+ * If the section was read, File is positioned just after its last token
+ * (as if it had been read with fscanint and fscanf), and the function
+ * returns 1. Otherwise (the file could not be mapped, the section has too
+ * few tokens, or a token could not be parsed), File is left at the start
+ * of the section, and the function returns 0. The caller is then expected
+ * to read the section through the stream, which also produces the
+ * appropriate error message, if any.
+ */
+
+#define MinChunkSize (1 << 20)  /* Smallest number of bytes given to
+                                   a worker */
+
+#define IsSpace(c) ((c) == ' ' || ((c) >= '\t' && (c) <= '\r'))
+
+typedef struct Chunk {
+    const char *Begin, *End;    /* The text of the chunk */
+    long long FirstToken;       /* Index in the section of its first token */
+    long long Tokens;           /* Number of tokens of the chunk that
+                                   belong to the section */
+    SectionParser Parse;
+    void *Arg;
+    int Worker;
+    const char *Stop;           /* End of the last token parsed, or 0 if
+                                   parsing failed */
+} Chunk;
+
+static void *Count(void *Arg);
+static void *Parse(void *Arg);
+static void RunWorkers(Chunk * Chunks, int Workers, void *(*Work) (void *));
+
+int ReadMappedSection(FILE * File, long long Tokens,
+                      SectionParser Parser, void *Arg)
+{
+    struct stat Stat;
+    long Offset;
+    char *Map;
+    const char *Begin, *End, *p;
+    Chunk *Chunks;
+    long long First;
+    int Workers, w, Result = 1;
+
+    if (Tokens <= 0 || (Offset = ftell(File)) < 0 ||
+        fstat(fileno(File), &Stat) || !S_ISREG(Stat.st_mode) ||
+        Stat.st_size <= Offset)
+        return 0;
+    Map = (char *) mmap(0, Stat.st_size, PROT_READ, MAP_PRIVATE,
+                        fileno(File), 0);
+    if (Map == MAP_FAILED)
+        return 0;
+    Begin = Map + Offset;
+    End = Map + Stat.st_size;
+    Workers = (End - Begin) / MinChunkSize;
+    if (Workers > Threads)
+        Workers = Threads;
+    if (Workers < 1)
+        Workers = 1;
+    assert(Chunks = (Chunk *) malloc(Workers * sizeof(Chunk)));
+    for (w = 0, p = Begin; w < Workers; w++) {
+        Chunks[w].Begin = p;
+        p = w == Workers - 1 ? End :
+            Begin + (long long) (End - Begin) * (w + 1) / Workers;
+        if (p < Chunks[w].Begin)
+            p = Chunks[w].Begin;
+        while (p < End && !IsSpace(*p))
+            p++;
+        Chunks[w].End = p;
+        Chunks[w].Parse = Parser;
+        Chunks[w].Arg = Arg;
+        Chunks[w].Worker = w;
+    }
+    RunWorkers(Chunks, Workers, Count);
+    for (w = 0, First = 0; w < Workers; w++) {
+        Chunks[w].FirstToken = First;
+        First += Chunks[w].Tokens;
+        if (First > Tokens)
+            Chunks[w].Tokens -= First - Tokens;
+        if (Chunks[w].Tokens < 0)
+            Chunks[w].Tokens = 0;
+    }
+    if (First < Tokens)
+        Result = 0;
+    else {
+        RunWorkers(Chunks, Workers, Parse);
+        for (w = 0; w < Workers; w++) {
+            if (!Chunks[w].Stop)
+                Result = 0;
+            else if (Chunks[w].Tokens > 0)
+                p = Chunks[w].Stop;
+        }
+        if (Result)
+            fseek(File, (long) (p - Map), SEEK_SET);
+    }
+    free(Chunks);
+    munmap(Map, Stat.st_size);
+    return Result;
+}
+
+/* The RunWorkers function lets Workers threads do Work, one for each chunk.
+   The calling thread takes the first chunk */
+
+static void RunWorkers(Chunk * Chunks, int Workers, void *(*Work) (void *))
+{
+    pthread_t *Thread;
+    int w;
+
+    assert(Thread = (pthread_t *) malloc(Workers * sizeof(pthread_t)));
+    for (w = 1; w < Workers; w++)
+        if (pthread_create(&Thread[w], 0, Work, &Chunks[w]))
+            eprintf("Cannot create thread %d", w);
+    Work(&Chunks[0]);
+    for (w = 1; w < Workers; w++)
+        pthread_join(Thread[w], 0);
+    free(Thread);
+}
+
+static void *Count(void *Arg)
+{
+    Chunk *C = (Chunk *) Arg;
+    const char *p = C->Begin;
+    long long Tokens = 0;
+
+    while (p < C->End) {
+        while (p < C->End && IsSpace(*p))
+            p++;
+        if (p == C->End)
+            break;
+        Tokens++;
+        while (p < C->End && !IsSpace(*p))
+            p++;
+    }
+    C->Tokens = Tokens;
+    return 0;
+}
+
+static void *Parse(void *Arg)
+{
+    Chunk *C = (Chunk *) Arg;
+
+    C->Stop = C->Tokens == 0 ? C->Begin :
+        C->Parse(C->Begin, C->End, C->FirstToken, C->Tokens, C->Arg,
+                 C->Worker);
+    return 0;
+}
+
+/*
+ * The ScanInt function parses the next token of the text from p to End as
+ * an int, in the same way as fscanint. The token must be followed by
+ * whitespace or by End. The function returns a pointer to the character
+ * after the token, or 0 if the token is not an integer.
+ */
+
+const char *ScanInt(const char *p, const char *End, int *v)
+{
+    unsigned int Val = 0;
+    int Sign = 1;
+
+    while (p < End && IsSpace(*p))
+        p++;
+    if (p < End && (*p == '-' || *p == '+')) {
+        if (*p == '-')
+            Sign = -1;
+        p++;
+    }
+    if (p == End || *p < '0' || *p > '9')
+        return 0;
+    do
+        Val = 10 * Val + (*p++ - '0');
+    while (p < End && *p >= '0' && *p <= '9');
+    if (p < End && !IsSpace(*p))
+        return 0;
+    *v = Sign * (int) Val;
+    return p;
+}
+
+/*
+ * The ScanDouble function parses the next token of the text from p to End
+ * as a double, giving the same value as fscanf with "%lf". The token must
+ * be followed by whitespace or by End. The function returns a pointer to
+ * the character after the token, or 0 if the token is not a number.
+ *
+ * A decimal number with at most 15 significant digits and a decimal
+ * exponent of at most 22 in absolute value is converted with a single
+ * floating-point multiplication or division, which is exact since both
+ * operands are exactly representable. Other tokens are converted by strtod.
+ */
+
+const char *ScanDouble(const char *p, const char *End, double *v)
+{
+    static const double Power[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *Token;
+    char Buffer[64], *Rest;
+    long long Mantissa = 0;
+    int Negative = 0, Digits = 0, Significant = 0, Exponent = 0, e = 0,
+        ExponentNegative = 0;
+    size_t Length;
+
+    while (p < End && IsSpace(*p))
+        p++;
+    Token = p;
+    if (p < End && (*p == '-' || *p == '+'))
+        Negative = *p++ == '-';
+    for (; p < End && *p >= '0' && *p <= '9'; p++, Digits++) {
+        if (Significant > 0 || *p != '0')
+            Significant++;
+        if (Significant <= 15)
+            Mantissa = 10 * Mantissa + (*p - '0');
+        else
+            Exponent++;
+    }
+    if (p < End && *p == '.') {
+        for (p++; p < End && *p >= '0' && *p <= '9'; p++, Digits++) {
+            if (Significant > 0 || *p != '0')
+                Significant++;
+            if (Significant <= 15) {
+                Mantissa = 10 * Mantissa + (*p - '0');
+                Exponent--;
+            }
+        }
+    }
+    if (Digits > 0 && p < End && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < End && (*p == '-' || *p == '+'))
+            ExponentNegative = *p++ == '-';
+        if (p == End || *p < '0' || *p > '9')
+            Digits = 0;
+        for (; p < End && *p >= '0' && *p <= '9' && e < 10000; p++)
+            e = 10 * e + (*p - '0');
+        Exponent += ExponentNegative ? -e : e;
+    }
+    if (Digits > 0 && Significant <= 15 && (p == End || IsSpace(*p)) &&
+        Exponent >= -22 && Exponent <= 22) {
+        *v = Exponent >= 0 ? (double) Mantissa * Power[Exponent] :
+            (double) Mantissa / Power[-Exponent];
+        if (Negative)
+            *v = -*v;
+        return p;
+    }
+    /* Let strtod convert the token */
+    for (p = Token; p < End && !IsSpace(*p); p++);
+    if ((Length = p - Token) == 0 || Length >= sizeof(Buffer))
+        return 0;
+    memcpy(Buffer, Token, Length);
+    Buffer[Length] = '\0';
+    *v = strtod(Buffer, &Rest);
+    return *Rest == '\0' ? p : 0;
+}
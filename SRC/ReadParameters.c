@@ -16,8 +16,27 @@
  * PROBLEM_FILE = <string>
  * Specifies the name of the problem file.
  *
+ * The files read by the program (the problem file, tour files, PI_FILE and 
+ * CANDIDATE_FILE) may be compressed with gzip or zstd. The files written by
+ * the program are compressed if their names end in ".gz" or ".zst" (see 
+ * OpenFile).
+ *
  * Additional control information may be supplied in the following format:
  *
+ * ALPHA_SUPERGRAPH = { DELAUNAY | QUADRANT } [ <integer> ]
+ * Specifies that the ascent and the computation of the Alpha-values of 
+ * the ALPHA candidate set are to be restricted to the edges of a sparse
+ * graph, instead of all edges. The graph is either the Delaunay graph or
+ * the graph of the 2 * MAX_CANDIDATES nearest quadrant neighbors of each
+ * node. This makes the preprocessing time close to O(n log n) for large 
+ * instances. The graph is extended with the edges (i,j) and (j,k) for 
+ * every edge (i,j) in the graph, and with edges to the nodes that can be 
+ * reached by following at most <integer> edges of the minimum spanning 
+ * tree. The integer must be positive and is 2 by default. The 
+ * specification can only be used for instances given by coordinates, and
+ * is ignored for the other candidate set types.
+ * Default: none (all edges are used).
+ *
  * ASCENT_CANDIDATES = <integer>
  * The number of candidate edges to be associated with each node during 
  * the ascent. The candidate set is complemented such that every candidate 
@@ -33,6 +52,26 @@
  * move in a sequence of moves (where K = MOVE_TYPE). 
  * Default: NO.
  *
+ * BINARY_PROBLEM_FILE = <string>
+ * Specifies the name of a file to which the problem is to be written in
+ * binary form (see ReadProblem and WriteBinaryProblem). The program stops
+ * when the file has been written. The file can be given as PROBLEM_FILE in
+ * later runs, and is then read without parsing.
+ * Default: none.
+ *
+ * CACHE_DIRECTORY = <string>
+ * Specifies the name of a directory in which the penalties and candidate
+ * sets are cached. The files are named by a fingerprint of the problem 
+ * file, the tour files that contribute candidate edges (INPUT_TOUR_FILE 
+ * and MERGE_TOUR_FILE), and the parameters that determine the ascent and 
+ * the candidate sets, and are written in binary form. If the files of the
+ * fingerprint exist, they are read as a PI_FILE and a CANDIDATE_FILE, and
+ * the ascent is skipped. Otherwise,
+ * they are written when the candidate sets have been created. The 
+ * directory is ignored if a PI_FILE or a CANDIDATE_FILE is given, or if 
+ * SUBPROBLEM_SIZE is positive. 
+ * Default: none.
+ *
  * CANDIDATE_FILE = <string>
  * Specifies the name of a file to which the candidate sets are to be 
  * written. If, however, the file already exists, the candidate edges are 
@@ -45,6 +84,9 @@
  * It is possible to give more than one CANDIDATE_FILE specification. In this
  * case the given files are read and the union of their candidate edges is
  * used as candidate sets.
+ * If the name of the file ends in ".bin", the file is written in a binary
+ * form, which is read much faster (see WriteCandidates). A file in binary
+ * form is recognized when it is read, whatever its name.
  *
  * CANDIDATE_SET_TYPE = { ALPHA | DELAUNAY [ PURE ] | NEAREST-NEIGHBOR | 
  *                        QUADRANT } 
@@ -55,6 +97,14 @@
  * edges of the Delaunay graph are used as candidates. 
  * Default: ALPHA.
  *
+ * DISTANCE_CACHE_SIZE = <integer>
+ * The number of entries in the cache of computed distances, which is used 
+ * when the distances are not given by an explicit matrix. The value is 
+ * rounded up to a power of two. The cache is 4-way set-associative. 
+ * A value of 0 specifies that no cache is to be used. Statistics for 
+ * the cache are reported if TRACE_LEVEL >= 1. 
+ * Default: the smallest power of two >= 2*DIMENSION.
+ *
  * COMMENT <string>
  * A comment.
  *
@@ -169,6 +219,14 @@
  * A value K >= 2 signifies that a sequential K-opt move is used.
  * Default: 5.
  *
+ * NODE_RENUMBERING = { YES | NO }
+ * Specifies whether the nodes of a two-dimensional TSP instance are
+ * renumbered internally in the order of a Moore curve, so that nodes
+ * close to each other in the plane are also close to each other in
+ * memory. Node numbers in input and output files always refer to the
+ * numbering of the problem file.
+ * Default: NO.
+ *
  * NONSEQUENTIAL_MOVE_TYPE = <integer>
  * Specifies the nonsequential move type to be used. A value K >= 4 
  * signifies that attempts are made to improve a tour by nonsequential 
@@ -219,6 +277,8 @@
  *       <integer> <integer>
  * where the first integer is a node number, and the second integer is 
  * the Pi-value associated with the node.
+ * If the name of the file ends in ".bin", the file is written in a binary
+ * form (see WritePenalties).
  * The file name "0" represents a file with all Pi-values equal to zero.
  *
  * POPULATION_SIZE = <integer>
@@ -298,6 +358,22 @@
  * in a sequence of moves.
  * Default: YES.
  *
+ * THREADS = <integer>
+ * Specifies the number of threads used for executing runs concurrently.
+ * Each thread solves its runs on a private copy of the tour, and the best
+ * tour found so far is shared by all threads. Trace output of the trials
+ * of each run is suppressed when more than one thread is used. The value
+ * is ignored when POPULATION_SIZE > 1.
+ * When SUBPROBLEM_SIZE is specified, the threads are instead used for
+ * solving the subproblems of each round of the partitioning concurrently.
+ * Their improvements are committed to the tour in order of subproblem 
+ * number. The subproblems are solved sequentially when SUBPROBLEM_SIZE
+ * is specified with COMPRESSED, when the problem has explicit edge
+ * weights, and when CANDIDATE_FILE or POPULATION_SIZE > 1 is used.
+ * The threads are also used for computing the Alpha-values of the
+ * candidate sets.
+ * Default: 1.
+ *
  * TIME_LIMIT = <real>
  * Specifies a time limit in seconds for each run.
  * Default: value of DBL_MAX. 
@@ -315,6 +391,30 @@
  * the value is the more information is given.
  * Default: 1. 
  *
+ * TREE_TYPE = { ONE-LEVEL | TWO-LEVEL | THREE-LEVEL }
+ * Specifies the representation of the tour used by the Lin-Kernighan
+ * search: a doubly linked list whose nodes are also kept in an array in
+ * tour order (ONE-LEVEL), a two-level tree (TWO-LEVEL), or a three-level
+ * tree (THREE-LEVEL).
+ * Default: chosen for the problem and for each subproblem by its
+ * dimension: ONE-LEVEL if less than 400, THREE-LEVEL if greater than
+ * 1000000, and TWO-LEVEL otherwise.
+ *
+ * TRIAL_EXCHANGE_INTERVAL = <integer>
+ * Specifies the number of trials a trial thread performs between two
+ * exchanges of its best tour with the best tour shared by all trial
+ * threads. The value is ignored when TRIAL_THREADS = 1.
+ * Default: 10.
+ *
+ * TRIAL_THREADS = <integer>
+ * Specifies the number of threads used for performing the trials of each
+ * run concurrently. Each thread performs trials on a private copy of the
+ * tour and the candidate sets, and the best tours of the threads are
+ * periodically merged (see TRIAL_EXCHANGE_INTERVAL). The trials are
+ * performed sequentially when backbone trials are used, and when 
+ * subproblems are solved.
+ * Default: 1.
+ *
  * List of abbreviations
  * ---------------------
  *
@@ -335,6 +435,7 @@
  *     MOORE             M
  *     NEAREST-NEIGHBOR  N
  *     NO                N
+ *     ONE-LEVEL         O
  *     PURE              P
  *     QUADRANT          Q
  *     QUICK-BORUVKA     Q
@@ -342,6 +443,8 @@
  *     ROHE              R
  *     SIERPINSKI        S
  *     SYMMETRIC         S
+ *     THREE-LEVEL       TH
+ *     TWO-LEVEL         TW
  *     WALK              W
  *     YES               Y    
  */
@@ -358,8 +461,11 @@ void ReadParameters()
     unsigned int i;
 
     ProblemFileName = PiFileName = InputTourFileName =
-        OutputTourFileName = TourFileName = 0;
+        OutputTourFileName = TourFileName = CacheDirectory =
+        BinaryProblemFileName = 0;
     CandidateFiles = MergeTourFiles = 0;
+    AlphaSupergraph = 0;
+    AlphaSupergraphHops = 2;
     AscentCandidates = 50;
     BackboneTrials = 0;
     Backtracking = 0;
@@ -368,6 +474,7 @@ void ReadParameters()
     Crossover = ERXT;
     DelaunayPartitioning = 0;
     DelaunayPure = 0;
+    DistanceCacheSize = -1;
     Excess = -1;
     ExtraCandidates = 0;
     ExtraCandidateSetSymmetric = 0;
@@ -390,6 +497,7 @@ void ReadParameters()
     MaxTrials = -1;
     MoorePartitioning = 0;
     MoveType = 5;
+    NodeRenumbering = 0;
     NonsequentialMoveType = -1;
     Optimum = MINUS_INFINITY;
     PatchingA = 1;
@@ -411,8 +519,12 @@ void ReadParameters()
     SubproblemSize = 0;
     SubsequentMoveType = 0;
     SubsequentPatching = 1;
+    Threads = 1;
     TimeLimit = DBL_MAX;
     TraceLevel = 1;
+    TreeType = -1;
+    TrialExchangeInterval = 10;
+    TrialThreads = 1;
 
     if (ParameterFileName) {
         if (!(ParameterFile = fopen(ParameterFileName, "r")))
@@ -442,7 +554,24 @@ void ReadParameters()
             continue;
         for (i = 0; i < strlen(Keyword); i++)
             Keyword[i] = (char) toupper(Keyword[i]);
-        if (!strcmp(Keyword, "ASCENT_CANDIDATES")) {
+        if (!strcmp(Keyword, "ALPHA_SUPERGRAPH")) {
+            if (!(Token = strtok(0, Delimiters)))
+                eprintf("%s", "ALPHA_SUPERGRAPH: "
+                        "DELAUNAY or QUADRANT expected");
+            for (i = 0; i < strlen(Token); i++)
+                Token[i] = (char) toupper(Token[i]);
+            if (!strncmp(Token, "DELAUNAY", strlen(Token)))
+                AlphaSupergraph = DELAUNAY;
+            else if (!strncmp(Token, "QUADRANT", strlen(Token)))
+                AlphaSupergraph = QUADRANT;
+            else
+                eprintf("%s", "ALPHA_SUPERGRAPH: "
+                        "DELAUNAY or QUADRANT expected");
+            if ((Token = strtok(0, Delimiters)) &&
+                (!sscanf(Token, "%d", &AlphaSupergraphHops) ||
+                 AlphaSupergraphHops < 1))
+                eprintf("ALPHA_SUPERGRAPH: positive integer expected");
+        } else if (!strcmp(Keyword, "ASCENT_CANDIDATES")) {
             if (!(Token = strtok(0, Delimiters)) ||
                 !sscanf(Token, "%d", &AscentCandidates))
                 eprintf("ASCENT_CANDIDATES: integer expected");
@@ -457,6 +586,12 @@ void ReadParameters()
         } else if (!strcmp(Keyword, "BACKTRACKING")) {
             if (!ReadYesOrNo(&Backtracking))
                 eprintf("BACKTRACKING: YES or NO expected");
+        } else if (!strcmp(Keyword, "BINARY_PROBLEM_FILE")) {
+            if (!(BinaryProblemFileName = GetFileName(0)))
+                eprintf("BINARY_PROBLEM_FILE: string expected");
+        } else if (!strcmp(Keyword, "CACHE_DIRECTORY")) {
+            if (!(CacheDirectory = GetFileName(0)))
+                eprintf("CACHE_DIRECTORY: string expected");
         } else if (!strcmp(Keyword, "CANDIDATE_FILE")) {
             if (!(Name = GetFileName(0)))
                 eprintf("CANDIDATE_FILE: string expected");
@@ -508,7 +643,13 @@ void ReadParameters()
             }
         } else if (!strcmp(Keyword, "COMMENT"))
             continue;
-        else if (!strcmp(Keyword, "EOF"))
+        else if (!strcmp(Keyword, "DISTANCE_CACHE_SIZE")) {
+            if (!(Token = strtok(0, Delimiters)) ||
+                !sscanf(Token, "%d", &DistanceCacheSize))
+                eprintf("DISTANCE_CACHE_SIZE: integer expected");
+            if (DistanceCacheSize < 0)
+                eprintf("DISTANCE_CACHE_SIZE: non-negative integer expected");
+        } else if (!strcmp(Keyword, "EOF"))
             break;
         else if (!strcmp(Keyword, "EXCESS")) {
             if (!(Token = strtok(0, Delimiters)) ||
@@ -669,6 +810,9 @@ void ReadParameters()
                 eprintf("MOVE_TYPE: integer expected");
             if (MoveType < 2)
                 eprintf("MOVE_TYPE: >= 2 expected");
+        } else if (!strcmp(Keyword, "NODE_RENUMBERING")) {
+            if (!ReadYesOrNo(&NodeRenumbering))
+                eprintf("NODE_RENUMBERING: YES or NO expected");
         } else if (!strcmp(Keyword, "NONSEQUENTIAL_MOVE_TYPE")) {
             if (!(Token = strtok(0, Delimiters)) ||
                 !sscanf(Token, "%d", &NonsequentialMoveType))
@@ -806,6 +950,12 @@ void ReadParameters()
         } else if (!strcmp(Keyword, "SUBSEQUENT_PATCHING")) {
             if (!ReadYesOrNo(&SubsequentPatching))
                 eprintf("SUBSEQUENT_PATCHING: YES or NO expected");
+        } else if (!strcmp(Keyword, "THREADS")) {
+            if (!(Token = strtok(0, Delimiters)) ||
+                !sscanf(Token, "%d", &Threads))
+                eprintf("THREADS: integer expected");
+            if (Threads < 1)
+                eprintf("THREADS: >= 1 expected");
         } else if (!strcmp(Keyword, "TIME_LIMIT")) {
             if (!(Token = strtok(0, Delimiters)) ||
                 !sscanf(Token, "%lf", &TimeLimit))
@@ -819,6 +969,33 @@ void ReadParameters()
             if (!(Token = strtok(0, Delimiters)) ||
                 !sscanf(Token, "%d", &TraceLevel))
                 eprintf("TRACE_LEVEL: integer expected");
+        } else if (!strcmp(Keyword, "TREE_TYPE")) {
+            if (!(Token = strtok(0, Delimiters)))
+                eprintf("TREE_TYPE: "
+                        "ONE-LEVEL, TWO-LEVEL or THREE-LEVEL expected");
+            for (i = 0; i < strlen(Token); i++)
+                Token[i] = (char) toupper(Token[i]);
+            if (!strncmp(Token, "ONE-LEVEL", strlen(Token)))
+                TreeType = ONE_LEVEL;
+            else if (!strncmp(Token, "TWO-LEVEL", strlen(Token)))
+                TreeType = TWO_LEVEL;
+            else if (!strncmp(Token, "THREE-LEVEL", strlen(Token)))
+                TreeType = THREE_LEVEL;
+            else
+                eprintf("TREE_TYPE: "
+                        "ONE-LEVEL, TWO-LEVEL or THREE-LEVEL expected");
+        } else if (!strcmp(Keyword, "TRIAL_EXCHANGE_INTERVAL")) {
+            if (!(Token = strtok(0, Delimiters)) ||
+                !sscanf(Token, "%d", &TrialExchangeInterval))
+                eprintf("TRIAL_EXCHANGE_INTERVAL: integer expected");
+            if (TrialExchangeInterval < 1)
+                eprintf("TRIAL_EXCHANGE_INTERVAL: >= 1 expected");
+        } else if (!strcmp(Keyword, "TRIAL_THREADS")) {
+            if (!(Token = strtok(0, Delimiters)) ||
+                !sscanf(Token, "%d", &TrialThreads))
+                eprintf("TRIAL_THREADS: integer expected");
+            if (TrialThreads < 1)
+                eprintf("TRIAL_THREADS: >= 1 expected");
         } else
             eprintf("Unknown keyword: %s", Keyword);
         if ((Token = strtok(0, Delimiters)) && Token[0] != '#')
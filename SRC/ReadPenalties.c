@@ -1,4 +1,5 @@
 #include "LKH.h"
+#include <sys/mman.h>
 
 /*
  * The ReadPenalties function attempts to read node penalties (Pi-values)
@@ -11,6 +12,9 @@
  * where the first integer is a node number, and the second integer 
  * is the Pi-value associated with the node.
  *
+ * A file in the binary form written by WritePenalties (starting with
+ * PenaltyMagic) is read from a memory mapping of the file.
+ *
  * If reading succeeds, the function returns 1; otherwise 0.
  *
  * The function is called from the CreateCandidateSet function. 
@@ -18,37 +22,58 @@
 
 int ReadPenalties()
 {
-    int i, Id;
-    Node *Na, *Nb = 0;
-    static int PenaltiesRead = 0;
+    int i, Id, Pi;
+    Node *Na = 0, *Nb = 0;
+    char *Map;
+    const int *Pair = 0;
+    size_t Size;
 
     if (PiFileName == 0)
         return 0;
     if (PenaltiesRead || !strcmp(PiFileName, "0"))
         return PenaltiesRead = 1;
-    if (!(PiFile = fopen(PiFileName, "r")))
+    if (!(PiFile = OpenFile(PiFileName, "r")))
         return 0;
     if (TraceLevel >= 1)
         printff("Reading PI_FILE: \"%s\" ... ", PiFileName);
-    fscanint(PiFile, &i);
-    if (i != Dimension)
-        eprintf("PI_FILE \"%s\" does not match problem", PiFileName);
-    fscanint(PiFile, &Id);
-    assert(Id >= 1 && Id <= Dimension);
-    FirstNode = Na = &NodeSet[Id];
-    fscanint(PiFile, &Na->Pi);
-    for (i = 2; i <= Dimension; i++) {
-        fscanint(PiFile, &Id);
+    if ((Map = MapBinaryFile(PiFile, PenaltyMagic, &Size))) {
+        if (Size < PENALTY_HEADER_FIELDS * sizeof(long long) ||
+            ((long long *) Map)[PENALTY_DIMENSION] != Dimension)
+            eprintf("PI_FILE \"%s\" does not match problem", PiFileName);
+        if (Size != PENALTY_HEADER_FIELDS * sizeof(long long) +
+            2 * (size_t) Dimension * sizeof(int))
+            eprintf("PI_FILE \"%s\" is truncated", PiFileName);
+        Pair = (const int *) (Map + PENALTY_HEADER_FIELDS *
+                              sizeof(long long));
+    } else {
+        fscanint(PiFile, &i);
+        if (i != Dimension)
+            eprintf("PI_FILE \"%s\" does not match problem", PiFileName);
+    }
+    for (i = 1; i <= Dimension; i++) {
+        if (Pair) {
+            Id = *Pair++;
+            Pi = *Pair++;
+        } else {
+            fscanint(PiFile, &Id);
+            fscanint(PiFile, &Pi);
+        }
         assert(Id >= 1 && Id <= Dimension);
-        Nb = &NodeSet[Id];
-        fscanint(PiFile, &Nb->Pi);
-        Nb->Pred = Na;
-        Na->Suc = Nb;
+        Nb = &NodeSet[InternalId(Id)];
+        Nb->Pi = Pi;
+        if (i == 1)
+            FirstNode = Nb;
+        else {
+            Nb->Pred = Na;
+            Na->Suc = Nb;
+        }
         Na = Nb;
     }
     FirstNode->Pred = Nb;
     Nb->Suc = FirstNode;
-    fclose(PiFile);
+    if (Map)
+        munmap(Map, Size);
+    CloseFile(PiFile);
     if (TraceLevel >= 1)
         printff("done\n");
     return PenaltiesRead = 1;
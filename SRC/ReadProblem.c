@@ -1,5 +1,7 @@
 #include "LKH.h"
 #include "Heap.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /*      
  * The ReadProblem function reads the problem data in TSPLIB format from the 
@@ -194,12 +196,25 @@
  * The edge weights are given in the format specifies by the EDGE_WEIGHT_FORMAT 
  * entry. At present, all explicit data are integral and is given in one of the
  * (self-explanatory) matrix formats, with explicitly known lengths.
+ *
+ * BINARY_SECTION :
+ * The node coordinates, the edge weights and the fixed edges are given in
+ * binary form (not available in TSPLIB). The keyword is followed by a
+ * header and by the data, as written by the WriteBinaryProblem function
+ * (see BINARY_PROBLEM_FILE in ReadParameters). The data are used directly
+ * from a memory mapping of the file; in particular, CostMatrix is not
+ * copied. The section replaces NODE_COORD_SECTION, EDGE_WEIGHT_SECTION
+ * and FIXED_EDGES_SECTION.
  */
 
 static const char Delimiters[] = " :=\n\t\r\f\v\xef\xbb\xbf";
 static void CheckSpecificationPart(void);
 static char *Copy(char *S);
 static void CreateNodes(void);
+static void FixATSPPairs(void);
+static void FixEdge(int i, int j);
+static void LinkCostMatrix(void);
+static void Read_BINARY_SECTION(void);
 static void Read_DIMENSION(void);
 static void Read_DISPLAY_DATA_SECTION(void);
 static void Read_DISPLAY_DATA_TYPE(void);
@@ -216,18 +231,50 @@ static void Read_TOUR_SECTION(FILE ** File);
 static void Read_TYPE(void);
 static int TwoDWeightType(void);
 static int ThreeDWeightType(void);
+static int ReadMappedWeights(void);
+static void ScanWeights(void);
+static const char *ParseCoordinates(const char *p, const char *End,
+                                    long long First, long long Tokens,
+                                    void *Arg, int Worker);
+static const char *ParseWeights(const char *p, const char *End,
+                                long long First, long long Tokens,
+                                void *Arg, int Worker);
+
+/* The coordinates of a NODE_COORD_SECTION read by ReadMappedSection */
+typedef struct CoordinateRecords {
+    int Fields;         /* Number of numbers in a record (3 or 4) */
+    int *Id;
+    double *X, *Y, *Z;
+} CoordinateRecords;
+
+/* The columns of the weights given on a row of EDGE_WEIGHT_SECTION,
+   where a row is a row or a column of the matrix, depending on the
+   format (see ParseWeights) */
+enum Columns { ALL_COLUMNS, AFTER_ROW, BEFORE_ROW, FROM_ROW, TO_ROW };
+
+/* The layout of an EDGE_WEIGHT_SECTION read by ReadMappedSection */
+typedef struct WeightLayout {
+    Node *NodeSet;
+    int n;              /* Number of rows */
+    int Columns;        /* One of the values of enum Columns */
+    int Asymmetric;     /* Is the full matrix stored (ATSP)? */
+    int Bound;          /* Larger weights are set to Bound */
+    int Clamp;          /* Is Bound to be applied? */
+    int *Max;           /* Largest weight found by each worker (ATSP) */
+} WeightLayout;
 
 void ReadProblem()
 {
     int i, K;
     char *Line, *Keyword;
 
-    if (!(ProblemFile = fopen(ProblemFileName, "r")))
+    if (!(ProblemFile = OpenFile(ProblemFileName, "r")))
         eprintf("Cannot open PROBLEM_FILE: \"%s\"", ProblemFileName);
     if (TraceLevel >= 1)
         printff("Reading PROBLEM_FILE: \"%s\" ... ", ProblemFileName);
     FreeStructures();
     FirstNode = 0;
+    NodeNumbersRead = 0;
     WeightType = WeightFormat = ProblemType = -1;
     CoordType = NO_COORDS;
     Name = Copy("Unnamed");
@@ -241,7 +288,9 @@ void ReadProblem()
             continue;
         for (i = 0; i < (int) strlen(Keyword); i++)
             Keyword[i] = (char) toupper(Keyword[i]);
-        if (!strcmp(Keyword, "COMMENT"));
+        if (!strcmp(Keyword, "BINARY_SECTION"))
+            Read_BINARY_SECTION();
+        else if (!strcmp(Keyword, "COMMENT"));
         else if (!strcmp(Keyword, "DEMAND_SECTION"))
             eprintf("Not implemented: %s", Keyword);
         else if (!strcmp(Keyword, "DEPOT_SECTION"))
@@ -279,6 +328,7 @@ void ReadProblem()
         else
             eprintf("Unknown keyword: %s", Keyword);
     }
+    WriteBinaryProblem();
     Swaps = 0; // 尝试性Move的交换次数
 
     /* Adjust parameters */
@@ -318,6 +368,7 @@ void ReadProblem()
         Distance != 0 && Distance != Distance_1 && 
         Distance != Distance_ATSP && Distance != Distance_SPECIAL) {
         Node *Ni, *Nj;
+        int Dist[DistanceBatchSize], Batched = HasDistanceKernel(), j, k;
         assert(CostMatrix = // 这里costMatrix 是用一维数组来存储2维矩阵下三角的指针。由于节点到自己的距离恒为1，且if条件已经将ASTP等非对称情况排除，所以最后需要的数组大小就为D*D-1 /2
                (int *) calloc((size_t) Dimension * (Dimension - 1) / 2,
                               sizeof(int)));
@@ -325,7 +376,18 @@ void ReadProblem()
         do {
             Ni->C = // C为CostMatrix中该Node与其他Node下三角矩阵的首元素 -1 的地址，表示一行，为何减一原因不明
                 &CostMatrix[(size_t) (Ni->Id - 1) * (Ni->Id - 2) / 2] - 1;
-            if (ProblemType != HPP || Ni->Id < Dimension) // 仅在问题为HPP类型，且到达计算下三角矩阵的最后一行时，该下三角矩阵的最后一行才设置为0
+            if (Batched && (ProblemType != HPP || Ni->Id < Dimension)) {
+                /* Compute the row in batches (see DistanceRange). The
+                   nodes preceding Ni are the nodes with smaller Id */
+                for (j = 1; j < Ni->Id; j += k) {
+                    k = Ni->Id - j < DistanceBatchSize ?
+                        Ni->Id - j : DistanceBatchSize;
+                    DistanceRange(Ni, j, k, Dist);
+                    for (i = 0; i < k; i++)
+                        Ni->C[j + i] = Fixed(Ni, &NodeSet[j + i]) ? 0 :
+                            Dist[i];
+                }
+            } else if (ProblemType != HPP || Ni->Id < Dimension) // 仅在问题为HPP类型，且到达计算下三角矩阵的最后一行时，该下三角矩阵的最后一行才设置为0
                 for (Nj = FirstNode; Nj != Ni; Nj = Nj->Suc) // 由于Ni->C[Nj->Id]中Id是从1开始计数，而C数组从0开始计数，所以上面的首元素地址要-1
                     Ni->C[Nj->Id] = Fixed(Ni, Nj) ? 0 : Distance(Ni, Nj); // 计算下三角矩阵的值，Fixed的意义暂不明确
             else
@@ -383,7 +445,7 @@ void ReadProblem()
     } else
         printff("PROBLEM_FILE = %s\n",
                 ProblemFileName ? ProblemFileName : "");
-    fclose(ProblemFile);
+    CloseFile(ProblemFile);
     if (InitialTourFileName) // 后续为读取各种初始化就给定的tour和subproblemTour的文件
         ReadTour(InitialTourFileName, &InitialTourFile);
     if (InputTourFileName)
@@ -446,6 +508,13 @@ static void CheckSpecificationPart()
         && MaxCandidates > 0)
         eprintf
             ("Illegal EDGE_WEIGHT_TYPE for CANDIDATE_SET_TYPE = DELAUNAY");
+    if (CandidateSetType != ALPHA || MaxCandidates == 0)
+        AlphaSupergraph = 0;
+    if (AlphaSupergraph == DELAUNAY && !TwoDWeightType())
+        eprintf("Illegal EDGE_WEIGHT_TYPE for ALPHA_SUPERGRAPH = DELAUNAY");
+    if (AlphaSupergraph == QUADRANT && !TwoDWeightType()
+        && !ThreeDWeightType())
+        eprintf("Illegal EDGE_WEIGHT_TYPE for ALPHA_SUPERGRAPH = QUADRANT");
     if (CandidateSetType == NN && !TwoDWeightType()
         && !ThreeDWeightType() && MaxCandidates > 0)
         eprintf
@@ -519,7 +588,12 @@ static void CreateNodes()
         if (Dimension > MaxMatrixDimension)
             eprintf("Dimension too large in HPP problem");
     }
-    assert(NodeSet = (Node *) calloc(Dimension + 1, sizeof(Node)));
+    NodeSet = AllocateNodes(Dimension + 1);
+    assert(ColdNodeSet =
+           (ColdNode *) calloc(Dimension + 1, sizeof(ColdNode)));
+    assert(XCoord = (double *) calloc(Dimension + 1, sizeof(double)));
+    assert(YCoord = (double *) calloc(Dimension + 1, sizeof(double)));
+    assert(ZCoord = (double *) calloc(Dimension + 1, sizeof(double)));
     for (i = 1; i <= Dimension; i++, Prev = N) {
         N = &NodeSet[i];
         if (i == 1)
@@ -528,7 +602,7 @@ static void CreateNodes()
             Link(Prev, N); // 宏替换，Prev 和 N两个节点进行双向连接
         N->Id = i;
         if (MergeTourFiles >= 1) // 若存在MergeTourFiles，则需要为每个node的MergeSuc字段申请MergeTourFiles个Node * 大小的内存
-            assert(N->MergeSuc =
+            assert(Cold(N)->MergeSuc =
                    (Node **) calloc(MergeTourFiles, sizeof(Node *)));
     }
     Link(N, FirstNode);
@@ -541,6 +615,121 @@ static void Read_NAME()
         eprintf("NAME: string expected");
 }
 
+/*
+ * The Read_BINARY_SECTION function reads the data of a problem file
+ * written by WriteBinaryProblem. The header and the data are taken from a
+ * memory mapping of the file. The mapping is kept (in ProblemMap) if the
+ * problem has explicit weights, and CostMatrix then points into it.
+ *
+ * The mapping is private and writable, so that changes to CostMatrix
+ * (see SolveSubproblem) do not reach the file.
+ */
+
+static void Read_BINARY_SECTION()
+{
+    struct stat Stat;
+    long long H[BINARY_HEADER_FIELDS], Weights, w;
+    long Offset;
+    char *Map;
+    double *X;
+    int *Edge, Bound, One = 1, n, i;
+    Node *N;
+
+    CheckSpecificationPart();
+    if (!FirstNode)
+        CreateNodes();
+    if (*(char *) &One != 1)
+        eprintf("BINARY_SECTION: only supported on little-endian machines");
+    if ((Offset = ftell(ProblemFile)) < 0 ||
+        fstat(fileno(ProblemFile), &Stat) || !S_ISREG(Stat.st_mode))
+        eprintf("BINARY_SECTION: PROBLEM_FILE must be an uncompressed "
+                "regular file");
+    if (Offset + (long long) sizeof(H) > (long long) Stat.st_size)
+        eprintf("BINARY_SECTION: header missing");
+    Map = (char *) mmap(0, Stat.st_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE, fileno(ProblemFile), 0);
+    if (Map == MAP_FAILED)
+        eprintf("BINARY_SECTION: cannot map PROBLEM_FILE");
+    memcpy(H, Map + Offset, sizeof(H));
+    n = ProblemType == ATSP ? Dimension / 2 :
+        ProblemType == HPP ? Dimension - 1 : Dimension;
+    Weights = WeightType != EXPLICIT && ProblemType != ATSP ? 0 :
+        ProblemType == ATSP ? (long long) n * n :
+        (long long) Dimension * (Dimension - 1) / 2;
+    if (memcmp(&H[BINARY_MAGIC], BinaryMagic, sizeof(long long)))
+        eprintf("BINARY_SECTION: unknown format");
+    if (H[BINARY_DIMENSION] != n)
+        eprintf("BINARY_SECTION: conflicts with DIMENSION");
+    if (H[BINARY_COORDINATES] != (CoordType == TWOD_COORDS ? 2 :
+                                  CoordType == THREED_COORDS ? 3 : 0))
+        eprintf("BINARY_SECTION: conflicts with EDGE_WEIGHT_TYPE");
+    if (H[BINARY_WEIGHTS] != Weights)
+        eprintf("BINARY_SECTION: conflicts with EDGE_WEIGHT_TYPE");
+    if (H[BINARY_END] > Stat.st_size || H[BINARY_FIXED_EDGES] < 0 ||
+        H[BINARY_COORDINATE_OFFSET] % 8 || H[BINARY_WEIGHT_OFFSET] % 8 ||
+        H[BINARY_FIXED_EDGE_OFFSET] % 8 ||
+        H[BINARY_COORDINATE_OFFSET] < Offset ||
+        H[BINARY_COORDINATE_OFFSET] +
+        H[BINARY_COORDINATES] * n * (long long) sizeof(double) >
+        H[BINARY_WEIGHT_OFFSET] ||
+        H[BINARY_WEIGHT_OFFSET] + Weights * (long long) sizeof(int) >
+        H[BINARY_FIXED_EDGE_OFFSET] ||
+        H[BINARY_FIXED_EDGE_OFFSET] +
+        H[BINARY_FIXED_EDGES] * 2 * (long long) sizeof(int) >
+        H[BINARY_END])
+        eprintf("BINARY_SECTION: file truncated or corrupt");
+    if (Weights > 0) {
+        CostMatrix = (int *) (Map + H[BINARY_WEIGHT_OFFSET]);
+        madvise(Map, Stat.st_size, MADV_WILLNEED);
+        LinkCostMatrix();
+        /* Limit the weights as Read_EDGE_WEIGHT_SECTION does */
+        Bound = INT_MAX / 2 / Precision;
+        if (H[BINARY_MAX_WEIGHT] > Bound && WeightFormat != LOWER_COL)
+            for (w = 0; w < Weights; w++)
+                if (CostMatrix[w] > Bound)
+                    CostMatrix[w] = Bound;
+        if (ProblemType == ATSP) {
+            if (H[BINARY_MAX_OFF_DIAGONAL_WEIGHT] > Bound)
+                H[BINARY_MAX_OFF_DIAGONAL_WEIGHT] = Bound;
+            if (H[BINARY_MAX_OFF_DIAGONAL_WEIGHT] > M)
+                M = (int) H[BINARY_MAX_OFF_DIAGONAL_WEIGHT];
+            FixATSPPairs();
+        }
+        ProblemMap = Map;
+        ProblemMapSize = Stat.st_size;
+    }
+    if (ProblemType == HPP)
+        Dimension--;
+    if (H[BINARY_COORDINATES] > 0) {
+        X = (double *) (Map + H[BINARY_COORDINATE_OFFSET]);
+        for (i = 1; i <= n; i++) {
+            N = &NodeSet[i];
+            N->X = *X++;
+            N->Y = *X++;
+            if (CoordType == THREED_COORDS)
+                N->Z = *X++;
+            if (Name && !strcmp(Name, "d657")) {
+                N->X = (float) N->X;
+                N->Y = (float) N->Y;
+            }
+            StoreCoordinates(N);
+        }
+        if (NodeRenumbering && ProblemType == TSP &&
+            CoordType == TWOD_COORDS && !NodeNumbersRead && !RenumberedId)
+            RenumberNodes();
+    }
+    Edge = (int *) (Map + H[BINARY_FIXED_EDGE_OFFSET]);
+    for (w = 0; w < H[BINARY_FIXED_EDGES]; w++, Edge += 2)
+        FixEdge(Edge[0], Edge[1]);
+    if (H[BINARY_FIXED_EDGES] > 0)
+        NodeNumbersRead = 1;
+    if (ProblemType == HPP)
+        Dimension++;
+    fseek(ProblemFile, (long) H[BINARY_END], SEEK_SET);
+    if (!ProblemMap)
+        munmap(Map, Stat.st_size);
+}
+
 static void Read_DIMENSION()
 {
     char *Token = strtok(0, Delimiters);
@@ -575,15 +764,16 @@ static void Read_DISPLAY_DATA_SECTION()
         if (Id <= 0 || Id > Dimension)
             eprintf("(DIPLAY_DATA_SECTION) Node number out of range: %d",
                     Id);
-        N = &NodeSet[Id];
+        N = &NodeSet[InternalId(Id)];
         if (N->V == 1)
             eprintf("(DIPLAY_DATA_SECTION) Node number occurs twice: %d",
-                    N->Id);
+                    Id);
         N->V = 1;
         if (!fscanf(ProblemFile, "%lf", &N->X))
             eprintf("Missing X-coordinate in DIPLAY_DATA_SECTION");
         if (!fscanf(ProblemFile, "%lf", &N->Y))
             eprintf("Missing Y-coordinate in DIPLAY_DATA_SECTION");
+        StoreCoordinates(N);
     }
     N = FirstNode;
     do
@@ -592,9 +782,10 @@ static void Read_DISPLAY_DATA_SECTION()
     while ((N = N->Suc) != FirstNode);
     if (!N->V)
         eprintf("(DIPLAY_DATA_SECTION) No coordinates given for node %d",
-                N->Id);
+                ExternalId(N->Id));
     if (ProblemType == HPP)
         Dimension++;
+    NodeNumbersRead = 1;
 }
 
 static void Read_DISPLAY_DATA_TYPE()
@@ -658,8 +849,8 @@ static void Read_EDGE_DATA_SECTION()
                 i += Dimension / 2;
                 j += Dimension / 2;
             }
-            Ni = &NodeSet[i];
-            Nj = &NodeSet[j];
+            Ni = &NodeSet[InternalId(i)];
+            Nj = &NodeSet[InternalId(j)];
             AddCandidate(Ni, Nj, 0, 1);
             if (ProblemType != ATSP)
                 AddCandidate(Nj, Ni, 0, 1);
@@ -673,6 +864,7 @@ static void Read_EDGE_DATA_SECTION()
     if (ProblemType == HPP)
         Dimension++;
     Distance = Distance_1;
+    NodeNumbersRead = 1;
 }
 
 static void Read_EDGE_WEIGHT_FORMAT()
@@ -709,30 +901,41 @@ static void Read_EDGE_WEIGHT_FORMAT()
 
 static void Read_EDGE_WEIGHT_SECTION()
 {
-    Node *Ni, *Nj;
-    int i, j, n, W;
+    int n;
 
     CheckSpecificationPart();
     if (!FirstNode)
         CreateNodes();
-    if (ProblemType != ATSP) {
+    if (ProblemType != ATSP)
         assert(CostMatrix =
                (int *) calloc((size_t) Dimension * (Dimension - 1) / 2,
                               sizeof(int)));
-        Ni = FirstNode->Suc;
-        do {
-            Ni->C =
-                &CostMatrix[(size_t) (Ni->Id - 1) * (Ni->Id - 2) / 2] - 1;
-        }
-        while ((Ni = Ni->Suc) != FirstNode);
-    } else {
+    else {
         n = Dimension / 2;
         assert(CostMatrix = (int *) calloc((size_t) n * n, sizeof(int)));
-        for (Ni = FirstNode; Ni->Id <= n; Ni = Ni->Suc)
-            Ni->C = &CostMatrix[(size_t) (Ni->Id - 1) * n] - 1;
     }
+    LinkCostMatrix();
     if (ProblemType == HPP)
         Dimension--;
+    if (!ReadMappedWeights())
+        ScanWeights();
+    if (WeightFormat == FULL_MATRIX && ProblemType == ATSP)
+        FixATSPPairs();
+    if (ProblemType == HPP)
+        Dimension++;
+}
+
+/*
+ * The ScanWeights function reads the weights of EDGE_WEIGHT_SECTION from
+ * ProblemFile by means of fscanint. It is used when the section cannot be
+ * read from a memory mapping (see ReadMappedWeights).
+ */
+
+static void ScanWeights()
+{
+    Node *Ni, *Nj;
+    int i, j, n, W;
+
     switch (WeightFormat) {
     case FULL_MATRIX:
         if (ProblemType == ATSP) {
@@ -748,18 +951,7 @@ static void Read_EDGE_WEIGHT_SECTION()
                     if (i != j && W > M)
                         M = W;
                 }
-                Nj = &NodeSet[i + n];
-                if (!Ni->FixedTo1)
-                    Ni->FixedTo1 = Nj;
-                else if (!Ni->FixedTo2)
-                    Ni->FixedTo2 = Nj;
-                if (!Nj->FixedTo1)
-                    Nj->FixedTo1 = Ni;
-                else if (!Nj->FixedTo2)
-                    Nj->FixedTo2 = Ni;
             }
-            Distance = Distance_ATSP;
-            WeightType = -1;
         } else
             for (i = 1, Ni = FirstNode; i <= Dimension; i++, Ni = Ni->Suc) {
                 for (j = 1; j <= Dimension; j++) {
@@ -865,8 +1057,179 @@ static void Read_EDGE_WEIGHT_SECTION()
         }
         break;
     }
-    if (ProblemType == HPP)
-        Dimension++;
+}
+
+/*
+ * The LinkCostMatrix function lets the C field of each node point to its
+ * row of CostMatrix (minus 1, so that the row is indexed by node Id).
+ *
+ * For a symmetric problem, CostMatrix holds the lower triangle of the
+ * weight matrix without the diagonal, row by row. Node i has row i, which
+ * contains its weights to the nodes 1, 2, ..., i - 1.
+ *
+ * For an asymmetric problem of n cities, CostMatrix holds the full n x n
+ * weight matrix, row by row.
+ */
+
+static void LinkCostMatrix()
+{
+    Node *Ni;
+    int n;
+
+    if (ProblemType != ATSP) {
+        Ni = FirstNode->Suc;
+        do {
+            Ni->C =
+                &CostMatrix[(size_t) (Ni->Id - 1) * (Ni->Id - 2) / 2] - 1;
+        }
+        while ((Ni = Ni->Suc) != FirstNode);
+    } else {
+        n = Dimension / 2;
+        for (Ni = FirstNode; Ni->Id <= n; Ni = Ni->Suc)
+            Ni->C = &CostMatrix[(size_t) (Ni->Id - 1) * n] - 1;
+    }
+}
+
+/*
+ * The FixATSPPairs function transforms an asymmetric problem of n cities
+ * into a symmetric problem of 2n nodes: for each city i, the edge between
+ * node i and node i + n is fixed, and Distance is set to Distance_ATSP.
+ */
+
+static void FixATSPPairs()
+{
+    Node *Ni, *Nj;
+    int i, n = Dimension / 2;
+
+    for (i = 1; i <= n; i++) {
+        Ni = &NodeSet[i];
+        Nj = &NodeSet[i + n];
+        if (!Ni->FixedTo1)
+            Ni->FixedTo1 = Nj;
+        else if (!Ni->FixedTo2)
+            Ni->FixedTo2 = Nj;
+        if (!Nj->FixedTo1)
+            Nj->FixedTo1 = Ni;
+        else if (!Nj->FixedTo2)
+            Nj->FixedTo2 = Ni;
+    }
+    Distance = Distance_ATSP;
+    WeightType = -1;
+}
+
+/*
+ * The ReadMappedWeights function reads the weights of EDGE_WEIGHT_SECTION
+ * by means of ReadMappedSection. It returns 1 if the weights were read;
+ * otherwise 0 (and the weights are to be read by Read_EDGE_WEIGHT_SECTION).
+ */
+
+static int ReadMappedWeights()
+{
+    WeightLayout L;
+    long long n, Tokens;
+    int w, Read;
+
+    L.NodeSet = NodeSet;
+    L.Asymmetric = ProblemType == ATSP;
+    L.n = L.Asymmetric ? Dimension / 2 : Dimension;
+    L.Bound = INT_MAX / 2 / Precision;
+    L.Clamp = WeightFormat != LOWER_COL;
+    switch (WeightFormat) {
+    case FULL_MATRIX:
+        L.Columns = ALL_COLUMNS;
+        break;
+    case UPPER_ROW:
+    case LOWER_COL:
+        L.Columns = AFTER_ROW;
+        break;
+    case LOWER_ROW:
+    case UPPER_COL:
+        L.Columns = BEFORE_ROW;
+        break;
+    case UPPER_DIAG_ROW:
+    case LOWER_DIAG_COL:
+        L.Columns = FROM_ROW;
+        break;
+    case LOWER_DIAG_ROW:
+    case UPPER_DIAG_COL:
+        L.Columns = TO_ROW;
+        break;
+    default:
+        return 0;
+    }
+    if (L.Asymmetric && L.Columns != ALL_COLUMNS)
+        return 0;
+    n = L.n;
+    Tokens = L.Columns == ALL_COLUMNS ? n * n :
+        L.Columns == AFTER_ROW || L.Columns == BEFORE_ROW ?
+        n * (n - 1) / 2 : n * (n + 1) / 2;
+    assert(L.Max = (int *) malloc(Threads * sizeof(int)));
+    for (w = 0; w < Threads; w++)
+        L.Max[w] = INT_MIN;
+    if ((Read = ReadMappedSection(ProblemFile, Tokens, ParseWeights, &L)))
+        for (w = 0; w < Threads; w++)
+            if (L.Max[w] > M)
+                M = L.Max[w];
+    free(L.Max);
+    return Read;
+}
+
+/*
+ * The ParseWeights function is the SectionParser of ReadMappedWeights.
+ *
+ * Row a of the section (a = 1, 2, ...) contains the weights of the edges
+ * (a,b), where b runs through the columns given by the layout. The first
+ * row is 2 for BEFORE_ROW (row 1 is empty), and the last row is n - 1 for
+ * AFTER_ROW. For a symmetric problem the weight is stored in the lower
+ * triangle, at row max(a,b) and column min(a,b), in the same way as the
+ * loops of Read_EDGE_WEIGHT_SECTION do. For FULL_MATRIX only the weights
+ * with b < a are stored.
+ */
+
+static const char *ParseWeights(const char *p, const char *End,
+                                long long First, long long Tokens,
+                                void *Arg, int Worker)
+{
+    WeightLayout *L = (WeightLayout *) Arg;
+    Node *NodeSet = L->NodeSet;
+    int n = L->n, Max = INT_MIN, a, b, High, W;
+
+#define FirstColumn(a)\
+    (L->Columns == AFTER_ROW ? (a) + 1 : L->Columns == FROM_ROW ? (a) : 1)
+#define LastColumn(a)\
+    (L->Columns == BEFORE_ROW ? (a) - 1 : L->Columns == TO_ROW ? (a) : n)
+
+    /* Find the row and column of the first weight */
+    a = L->Columns == BEFORE_ROW ? 2 : 1;
+    while (First >= LastColumn(a) - FirstColumn(a) + 1) {
+        First -= LastColumn(a) - FirstColumn(a) + 1;
+        a++;
+    }
+    b = FirstColumn(a) + (int) First;
+    High = LastColumn(a);
+    for (; Tokens > 0; Tokens--) {
+        if (!(p = ScanInt(p, End, &W)))
+            return 0;
+        if (L->Clamp && W > L->Bound)
+            W = L->Bound;
+        if (L->Asymmetric) {
+            NodeSet[a].C[b] = W;
+            if (a != b && W > Max)
+                Max = W;
+        } else if (b < a)
+            NodeSet[a].C[b] = W;
+        else if (b > a && L->Columns != ALL_COLUMNS)
+            NodeSet[b].C[a] = W;
+        if (++b > High) {
+            a++;
+            b = FirstColumn(a);
+            High = LastColumn(a);
+        }
+    }
+    L->Max[Worker] = Max;
+    return p;
+#undef FirstColumn
+#undef LastColumn
 }
 
 static void Read_EDGE_WEIGHT_TYPE()
@@ -958,8 +1321,7 @@ static void Read_EDGE_WEIGHT_TYPE()
 
 static void Read_FIXED_EDGES_SECTION()
 {
-    Node *Ni, *Nj, *N, *NPrev = 0, *NNext;
-    int i, j, Count = 0;
+    int i, j;
 
     CheckSpecificationPart();
     if (!FirstNode)
@@ -969,52 +1331,63 @@ static void Read_FIXED_EDGES_SECTION()
     if (!fscanint(ProblemFile, &i))
         i = -1;
     while (i != -1) {
-        if (i <= 0
-            || i > (ProblemType != ATSP ? Dimension : Dimension / 2))
-            eprintf("(FIXED_EDGES_SECTION) Node number out of range: %d",
-                    i);
         fscanint(ProblemFile, &j);
-        if (j <= 0
-            || j > (ProblemType != ATSP ? Dimension : Dimension / 2))
-            eprintf("(FIXED_EDGES_SECTION) Node number out of range: %d",
-                    j);
-        if (i == j)
-            eprintf("(FIXED_EDGES_SECTION) Illegal edge: %d to %d", i, j);
-        Ni = &NodeSet[i];
-        Nj = &NodeSet[ProblemType == ATSP ? j + Dimension / 2 : j];
-        if (!Ni->FixedTo1 || Ni->FixedTo1 == Nj)
-            Ni->FixedTo1 = Nj;
-        else if (!Ni->FixedTo2 || Ni->FixedTo2 == Nj)
-            Ni->FixedTo2 = Nj;
-        else
-            eprintf("(FIXED_EDGES_SECTION) Illegal fix: %d to %d", i, j);
-        if (!Nj->FixedTo1 || Nj->FixedTo1 == Ni)
-            Nj->FixedTo1 = Ni;
-        else if (!Nj->FixedTo2 || Nj->FixedTo2 == Ni)
-            Nj->FixedTo2 = Ni;
-        else
-            eprintf("(FIXED_EDGES_SECTION) Illegal fix: %d to %d", i, j);
-        /* Cycle check */
-        N = Ni;
-        Count = 0;
-        do {
-            NNext = N->FixedTo1 != NPrev ? N->FixedTo1 : N->FixedTo2;
-            NPrev = N;
-            Count++;
-        } while ((N = NNext) && N != Ni);
-        if (N == Ni && Count != Dimension)
-            eprintf("(FIXED_EDGES_SECTION) Illegal fix: %d to %d", i, j);
+        FixEdge(i, j);
         if (!fscanint(ProblemFile, &i))
             i = -1;
     }
     if (ProblemType == HPP)
         Dimension++;
+    NodeNumbersRead = 1;
+}
+
+/*
+ * The FixEdge function fixes the edge from node number i to node number j
+ * of FIXED_EDGES_SECTION.
+ */
+
+static void FixEdge(int i, int j)
+{
+    Node *Ni, *Nj, *N, *NPrev = 0, *NNext;
+    int Count;
+
+    if (i <= 0 || i > (ProblemType != ATSP ? Dimension : Dimension / 2))
+        eprintf("(FIXED_EDGES_SECTION) Node number out of range: %d", i);
+    if (j <= 0 || j > (ProblemType != ATSP ? Dimension : Dimension / 2))
+        eprintf("(FIXED_EDGES_SECTION) Node number out of range: %d", j);
+    if (i == j)
+        eprintf("(FIXED_EDGES_SECTION) Illegal edge: %d to %d", i, j);
+    Ni = &NodeSet[InternalId(i)];
+    Nj = &NodeSet[ProblemType == ATSP ? j + Dimension / 2 : InternalId(j)];
+    if (!Ni->FixedTo1 || Ni->FixedTo1 == Nj)
+        Ni->FixedTo1 = Nj;
+    else if (!Ni->FixedTo2 || Ni->FixedTo2 == Nj)
+        Ni->FixedTo2 = Nj;
+    else
+        eprintf("(FIXED_EDGES_SECTION) Illegal fix: %d to %d", i, j);
+    if (!Nj->FixedTo1 || Nj->FixedTo1 == Ni)
+        Nj->FixedTo1 = Ni;
+    else if (!Nj->FixedTo2 || Nj->FixedTo2 == Ni)
+        Nj->FixedTo2 = Ni;
+    else
+        eprintf("(FIXED_EDGES_SECTION) Illegal fix: %d to %d", i, j);
+    /* Cycle check */
+    N = Ni;
+    Count = 0;
+    do {
+        NNext = N->FixedTo1 != NPrev ? N->FixedTo1 : N->FixedTo2;
+        NPrev = N;
+        Count++;
+    } while ((N = NNext) && N != Ni);
+    if (N == Ni && Count != Dimension)
+        eprintf("(FIXED_EDGES_SECTION) Illegal fix: %d to %d", i, j);
 }
 
 static void Read_NODE_COORD_SECTION()
 {
     Node *N;
-    int Id, i;
+    int Id, i, Mapped;
+    CoordinateRecords R;
 
     CheckSpecificationPart();
     if (CoordType != TWOD_COORDS && CoordType != THREED_COORDS)
@@ -1028,8 +1401,20 @@ static void Read_NODE_COORD_SECTION()
     while ((N = N->Suc) != FirstNode);
     if (ProblemType == HPP)
         Dimension--;
+    /* Parse the section from a memory mapping of the file, if possible */
+    R.Fields = CoordType == THREED_COORDS ? 4 : 3;
+    assert(R.Id = (int *) malloc(Dimension * sizeof(int)));
+    assert(R.X = (double *) malloc(Dimension * sizeof(double)));
+    assert(R.Y = (double *) malloc(Dimension * sizeof(double)));
+    R.Z = 0;
+    if (CoordType == THREED_COORDS)
+        assert(R.Z = (double *) malloc(Dimension * sizeof(double)));
+    Mapped = ReadMappedSection(ProblemFile, (long long) R.Fields * Dimension,
+                               ParseCoordinates, &R);
     for (i = 1; i <= Dimension; i++) {
-        if (!fscanint(ProblemFile, &Id))
+        if (Mapped)
+            Id = R.Id[i - 1];
+        else if (!fscanint(ProblemFile, &Id))
             eprintf("Missing nodes in NODE_COORD_SECTION");
         if (Id <= 0 || Id > Dimension)
             eprintf("(NODE_COORD_SECTION) Node number out of range: %d",
@@ -1039,17 +1424,25 @@ static void Read_NODE_COORD_SECTION()
             eprintf("(NODE_COORD_SECTION) Node number occurs twice: %d",
                     N->Id);
         N->V = 1;
-        if (!fscanf(ProblemFile, "%lf", &N->X))
-            eprintf("Missing X-coordinate in NODE_COORD_SECTION");
-        if (!fscanf(ProblemFile, "%lf", &N->Y))
-            eprintf("Missing Y-coordinate in NODE_COORD_SECTION");
-        if (CoordType == THREED_COORDS
-            && !fscanf(ProblemFile, "%lf", &N->Z))
-            eprintf("Missing Z-coordinate in NODE_COORD_SECTION");
+        if (Mapped) {
+            N->X = R.X[i - 1];
+            N->Y = R.Y[i - 1];
+            if (CoordType == THREED_COORDS)
+                N->Z = R.Z[i - 1];
+        } else {
+            if (!fscanf(ProblemFile, "%lf", &N->X))
+                eprintf("Missing X-coordinate in NODE_COORD_SECTION");
+            if (!fscanf(ProblemFile, "%lf", &N->Y))
+                eprintf("Missing Y-coordinate in NODE_COORD_SECTION");
+            if (CoordType == THREED_COORDS
+                && !fscanf(ProblemFile, "%lf", &N->Z))
+                eprintf("Missing Z-coordinate in NODE_COORD_SECTION");
+        }
         if (Name && !strcmp(Name, "d657")) {
             N->X = (float) N->X;
             N->Y = (float) N->Y;
         }
+        StoreCoordinates(N);
     }
     N = FirstNode;
     do // 检查是否有所有的Node在Id合法的情况下，V值为0（即没该id的Node的坐标再ProblemFile中没有给出）
@@ -1061,6 +1454,40 @@ static void Read_NODE_COORD_SECTION()
                 N->Id);
     if (ProblemType == HPP)
         Dimension++;
+    free(R.Id);
+    free(R.X);
+    free(R.Y);
+    free(R.Z);
+    if (NodeRenumbering && ProblemType == TSP &&
+        CoordType == TWOD_COORDS && !NodeNumbersRead && !RenumberedId)
+        RenumberNodes();
+}
+
+/*
+ * The ParseCoordinates function is the SectionParser of
+ * Read_NODE_COORD_SECTION. Each record of the section consists of a node
+ * number followed by two or three coordinates.
+ */
+
+static const char *ParseCoordinates(const char *p, const char *End,
+                                    long long First, long long Tokens,
+                                    void *Arg, int Worker)
+{
+    CoordinateRecords *R = (CoordinateRecords *) Arg;
+    long long i = First / R->Fields;
+    int f = (int) (First % R->Fields);
+
+    for (; Tokens > 0; Tokens--) {
+        if (!(p = f == 0 ? ScanInt(p, End, &R->Id[i]) :
+              ScanDouble(p, End, f == 1 ? &R->X[i] :
+                         f == 2 ? &R->Y[i] : &R->Z[i])))
+            return 0;
+        if (++f == R->Fields) {
+            f = 0;
+            i++;
+        }
+    }
+    return p;
 }
 
 static void Read_NODE_COORD_TYPE()
@@ -1116,9 +1543,9 @@ static void Read_TOUR_SECTION(FILE ** File)
     for (k = 0; k <= Dimension && i != -1; k++) {
         if (i <= 0 || i > Dimension)
             eprintf("(TOUR_SECTION) Node number out of range: %d", i);
-        N = &NodeSet[i];
+        N = &NodeSet[InternalId(i)];
         if (N->V == 1 && k != Dimension)
-            eprintf("(TOUR_SECTION) Node number occurs twice: %d", N->Id);
+            eprintf("(TOUR_SECTION) Node number occurs twice: %d", i);
         N->V = 1;
         if (k == 0)
             First = Last = N;
@@ -1130,33 +1557,36 @@ static void Read_TOUR_SECTION(FILE ** File)
                 Na = 0;
             if (File == &InitialTourFile) {
                 if (!Na)
-                    Last->InitialSuc = N;
+                    Cold(Last)->InitialSuc = N;
                 else {
-                    Last->InitialSuc = Na;
-                    Na->InitialSuc = N;
+                    Cold(Last)->InitialSuc = Na;
+                    Cold(Na)->InitialSuc = N;
                 }
             } else if (File == &InputTourFile) {
                 if (!Na)
-                    Last->InputSuc = N;
+                    Cold(Last)->InputSuc = N;
                 else {
-                    Last->InputSuc = Na;
-                    Na->InputSuc = N;
+                    Cold(Last)->InputSuc = Na;
+                    Cold(Na)->InputSuc = N;
                 }
             } else if (File == &SubproblemTourFile) {
-                if (!Na)
-                    (Last->SubproblemSuc = N)->SubproblemPred = Last;
-                else {
-                    (Last->SubproblemSuc = Na)->SubproblemPred = Last;
-                    (Na->SubproblemSuc = N)->SubproblemPred = Na;
+                if (!Na) {
+                    Cold(Last)->SubproblemSuc = N;
+                    Cold(N)->SubproblemPred = Last;
+                } else {
+                    Cold(Last)->SubproblemSuc = Na;
+                    Cold(Na)->SubproblemPred = Last;
+                    Cold(Na)->SubproblemSuc = N;
+                    Cold(N)->SubproblemPred = Na;
                 }
             } else {
                 for (i = 0; i < MergeTourFiles; i++) {
                     if (File == &MergeTourFile[i]) {
                         if (!Na)
-                            Last->MergeSuc[i] = N;
+                            Cold(Last)->MergeSuc[i] = N;
                         else {
-                            Last->MergeSuc[i] = Na;
-                            Na->MergeSuc[i] = N;
+                            Cold(Last)->MergeSuc[i] = Na;
+                            Cold(Na)->MergeSuc[i] = N;
                         }
                     }
                 }
@@ -1166,32 +1596,35 @@ static void Read_TOUR_SECTION(FILE ** File)
         if (k < Dimension)
             fscanint(*File, &i);
         if (k == Dimension - 1)
-            i = First->Id;
+            i = ExternalId(First->Id);
     }
     N = FirstNode;
     do
         if (!N->V)
-            eprintf("(TOUR_SECTION) Node is missing: %d", N->Id);
+            eprintf("(TOUR_SECTION) Node is missing: %d",
+                    ExternalId(N->Id));
     while ((N = N->Suc) != FirstNode);
     if (File == &SubproblemTourFile) {
         do {
             if (N->FixedTo1 &&
-                N->SubproblemPred != N->FixedTo1
-                && N->SubproblemSuc != N->FixedTo1)
+                Cold(N)->SubproblemPred != N->FixedTo1
+                && Cold(N)->SubproblemSuc != N->FixedTo1)
                 eprintf("Fixed edge (%d, %d) "
-                        "does not belong to subproblem tour", N->Id,
-                        N->FixedTo1->Id);
-            if (N->FixedTo2 && N->SubproblemPred != N->FixedTo2
-                && N->SubproblemSuc != N->FixedTo2)
+                        "does not belong to subproblem tour",
+                        ExternalId(N->Id), ExternalId(N->FixedTo1->Id));
+            if (N->FixedTo2 && Cold(N)->SubproblemPred != N->FixedTo2
+                && Cold(N)->SubproblemSuc != N->FixedTo2)
                 eprintf("Fixed edge (%d, %d) "
-                        "does not belong to subproblem tour", N->Id,
-                        N->FixedTo2->Id);
+                        "does not belong to subproblem tour",
+                        ExternalId(N->Id), ExternalId(N->FixedTo2->Id));
         } while ((N = N->Suc) != FirstNode);
     }
     if (ProblemType == HPP)
         Dimension++;
     if (ProblemType == ATSP)
         Dimension *= 2;
+    if (File == &ProblemFile)
+        NodeNumbersRead = 1;
     if (TraceLevel >= 1)
         printff("done\n");
 }
@@ -1253,7 +1686,7 @@ void ReadTour(char *FileName, FILE ** File)
     unsigned int i;
     int Done = 0;
 
-    if (!(*File = fopen(FileName, "r")))
+    if (!(*File = OpenFile(FileName, "r")))
         eprintf("Cannot open tour file: \"%s\"", FileName);
     while ((Line = ReadLine(*File))) {
         if (!(Keyword = strtok(Line, Delimiters)))
@@ -1298,5 +1731,5 @@ void ReadTour(char *FileName, FILE ** File)
     }
     if (!Done)
         eprintf("Missing TOUR_SECTION in tour file: \"%s\"", FileName);
-    fclose(*File);
+    CloseFile(*File);
 }
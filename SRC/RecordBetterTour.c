@@ -42,8 +42,8 @@ void RecordBetterTour()
     BetterTour[0] = BetterTour[DimensionSaved];
     N = FirstNode;
     do {
-        N->NextBestSuc = N->BestSuc;
-        N->BestSuc = N->Suc;
+        Cold(N)->NextBestSuc = Cold(N)->BestSuc;
+        Cold(N)->BestSuc = N->Suc;
     }
     while ((N = N->Suc) != FirstNode);
 }
@@ -0,0 +1,87 @@
+#include "LKH.h"
+
+/*
+ * The RenumberNodes function renumbers the nodes of a two-dimensional
+ * problem in the order in which they are visited by a Moore curve (see
+ * SFCTour). Nodes that are close to each other in the plane thereby get
+ * Ids that are close to each other, and since NodeSet and the coordinate
+ * arrays are indexed by Id, nodes that are processed together during the
+ * search (neighbors, candidates, tour segments) will mostly be close to
+ * each other in memory.
+ *
+ * The nodes themselves are not moved: the node with Id i gets the
+ * coordinates of the node visited as number i by the curve. The original
+ * numbering is recorded in the tables OriginalId and RenumberedId. Node
+ * numbers read from files are translated by the macro InternalId, and
+ * node numbers written to files are translated back by the macro
+ * ExternalId, so the renumbering is invisible to the user.
+ *
+ * The function is called from ReadProblem right after the coordinates
+ * have been read (if NODE_RENUMBERING is specified), that is, before
+ * any other section of the problem file refers to the nodes by number.
+ */
+
+static int compare(const void *Na, const void *Nb);
+
+void RenumberNodes()
+{
+    double XMin, XMax, YMin, YMax, *X, *Y, *Z;
+    Node *N, **Perm;
+    int i;
+
+    XMin = XMax = XCoord[1];
+    YMin = YMax = YCoord[1];
+    for (i = 2; i <= Dimension; i++) {
+        if (XCoord[i] < XMin)
+            XMin = XCoord[i];
+        else if (XCoord[i] > XMax)
+            XMax = XCoord[i];
+        if (YCoord[i] < YMin)
+            YMin = YCoord[i];
+        else if (YCoord[i] > YMax)
+            YMax = YCoord[i];
+    }
+    if (XMax == XMin)
+        XMax = XMin + 1;
+    if (YMax == YMin)
+        YMax = YMin + 1;
+    assert(Perm = (Node **) malloc(Dimension * sizeof(Node *)));
+    for (i = 1; i <= Dimension; i++)
+        (Perm[i - 1] = &NodeSet[i])->V =
+            MooreIndex((XCoord[i] - XMin) / (XMax - XMin),
+                       (YCoord[i] - YMin) / (YMax - YMin));
+    qsort(Perm, Dimension, sizeof(Node *), compare);
+    assert(OriginalId = (int *) malloc((Dimension + 1) * sizeof(int)));
+    assert(RenumberedId = (int *) malloc((Dimension + 1) * sizeof(int)));
+    OriginalId[0] = RenumberedId[0] = 0;
+    for (i = 1; i <= Dimension; i++) {
+        OriginalId[i] = Perm[i - 1]->Id;
+        RenumberedId[Perm[i - 1]->Id] = i;
+    }
+    free(Perm);
+
+    /* Give each node the coordinates of the node it replaces */
+    X = XCoord;
+    Y = YCoord;
+    Z = ZCoord;
+    assert(XCoord = (double *) malloc((Dimension + 1) * sizeof(double)));
+    assert(YCoord = (double *) malloc((Dimension + 1) * sizeof(double)));
+    assert(ZCoord = (double *) malloc((Dimension + 1) * sizeof(double)));
+    XCoord[0] = YCoord[0] = ZCoord[0] = 0;
+    for (i = 1; i <= Dimension; i++) {
+        N = &NodeSet[i];
+        N->X = X[OriginalId[i]];
+        N->Y = Y[OriginalId[i]];
+        N->Z = Z[OriginalId[i]];
+        StoreCoordinates(N);
+    }
+    free(X);
+    free(Y);
+    free(Z);
+}
+
+static int compare(const void *Na, const void *Nb)
+{
+    const Node *a = *(Node **) Na, *b = *(Node **) Nb;
+    return a->V < b->V ? -1 : a->V > b->V ? 1 : a->Id - b->Id;
+}
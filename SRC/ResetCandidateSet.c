@@ -19,6 +19,7 @@ void ResetCandidateSet()
     do {
         if (!From->CandidateSet)
             continue;
+        UnindexCandidates(From);
         /* Reorder the candidate array of From */
         for (NFrom = From->CandidateSet; NFrom->To; NFrom++) {
             Temp = *NFrom;
@@ -37,12 +38,13 @@ void ResetCandidateSet()
         NFrom->To = 0;
         /* Remove impossible candidates */
         for (NFrom = From->CandidateSet; NFrom->To; NFrom++) {
-            if (!IsPossibleCandidate(From, NFrom->To)) {
+            if (!IsPossibleCandidate(From, CandidateNode(NFrom))) {
                 for (NN = NFrom; NN->To; NN++)
                     *NN = *(NN + 1);
                 NFrom--;
             }
         }
+        IndexCandidates(From);
     }
     while ((From = From->Suc) != FirstNode);
 }
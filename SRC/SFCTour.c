@@ -19,14 +19,13 @@
  */
 
 static int SierpinskiIndex(double x, double y);
-static int MooreIndex(double x, double y);
 static int compare(const void *Na, const void *Nb);
 
 typedef int (*IndexFunction) (double x, double y);
 
 GainType SFCTour(int CurveType)
 {
-    double XMin, XMax, YMin, YMax;
+    double XMin, XMax, YMin, YMax, X, Y;
     Node *N, **Perm;
     int i;
     IndexFunction Index;
@@ -43,18 +42,18 @@ GainType SFCTour(int CurveType)
         Index = MooreIndex;
     }
     N = FirstNode;
-    XMin = XMax = N->X;
-    YMin = YMax = N->Y;
+    XMin = XMax = XCoord[N->Id];
+    YMin = YMax = YCoord[N->Id];
     N->V = 0;
     while ((N = N->Suc) != FirstNode) {
-        if (N->X < XMin)
-            XMin = N->X;
-        else if (N->X > XMax)
-            XMax = N->X;
-        if (N->Y < YMin)
-            YMin = N->Y;
-        else if (N->Y > YMax)
-            YMax = N->Y;
+        if ((X = XCoord[N->Id]) < XMin)
+            XMin = X;
+        else if (X > XMax)
+            XMax = X;
+        if ((Y = YCoord[N->Id]) < YMin)
+            YMin = Y;
+        else if (Y > YMax)
+            YMax = Y;
     }
     if (XMax == XMin)
         XMax = XMin + 1;
@@ -64,8 +63,8 @@ GainType SFCTour(int CurveType)
     assert(Perm = (Node **) malloc(Dimension * sizeof(Node *)));
     for (i = 0, N = FirstNode; i < Dimension; i++, N = N->Suc)
         (Perm[i] = N)->V =
-            Index((N->X - XMin) / (XMax - XMin),
-                  (N->Y - YMin) / (YMax - YMin));
+            Index((XCoord[N->Id] - XMin) / (XMax - XMin),
+                  (YCoord[N->Id] - YMin) / (YMax - YMin));
     qsort(Perm, Dimension, sizeof(Node *), compare);
     for (i = 1; i < Dimension; i++)
         Follow(Perm[i], Perm[i - 1]);
@@ -77,9 +76,10 @@ GainType SFCTour(int CurveType)
         N->LastV = 1;
         if (!FixedOrCommon(N, N->Suc) && N->CandidateSet) {
             Candidate *NN;
-            for (NN = N->CandidateSet; NN->To; NN++) {
-                if (!NN->To->LastV && FixedOrCommon(N, NN->To)) {
-                    Follow(NN->To, N);
+            Node *To;
+            for (NN = N->CandidateSet; (To = CandidateNode(NN)); NN++) {
+                if (!To->LastV && FixedOrCommon(N, To)) {
+                    Follow(To, N);
                     break;
                 }
             }
@@ -135,7 +135,12 @@ static int SierpinskiIndex(double x, double y)
     return idx;
 }
 
-static int MooreIndex(double x, double y)
+/*
+ * The MooreIndex function returns the position of the point (x,y) in the
+ * unit square on a Moore curve. It is also used by RenumberNodes.
+ */
+
+int MooreIndex(double x, double y)
 {
     static const int Rank[5][4] =
         { {1, 0, 2, 3}, {2, 3, 1, 0}, {2, 1, 3, 0}, {0, 3, 1, 2},
@@ -31,11 +31,11 @@ void SolveDelaunaySubproblems()
     GlobalBestCost = 0;
     N = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (TraceLevel >= 1) {
         if (TraceLevel >= 2)
             printff("\n");
@@ -43,14 +43,20 @@ void SolveDelaunaySubproblems()
                 GlobalBestCost);
     }
     Subproblems = DelaunayClustering(SubproblemSize);
-    for (CurrentSubproblem = 1;
-         CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
-        OldGlobalBestCost = GlobalBestCost;
-        SolveSubproblem(CurrentSubproblem, Subproblems, &GlobalBestCost);
-        if (SubproblemsCompressed && GlobalBestCost == OldGlobalBestCost)
-            SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
-                                      &GlobalBestCost);
-    }
+    if (SubproblemsInParallel())
+        SolveSubproblemsInParallel(1, Subproblems, Subproblems,
+                                   &GlobalBestCost);
+    else
+        for (CurrentSubproblem = 1;
+             CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
+            OldGlobalBestCost = GlobalBestCost;
+            SolveSubproblem(CurrentSubproblem, Subproblems,
+                            &GlobalBestCost);
+            if (SubproblemsCompressed
+                && GlobalBestCost == OldGlobalBestCost)
+                SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
+                                          &GlobalBestCost);
+        }
     printff("\nCost = " GainFormat, GlobalBestCost);
     if (Optimum != MINUS_INFINITY && Optimum != 0)
         printff(", Gap = %0.4f%%",
@@ -127,12 +133,12 @@ static int DelaunayClustering(int MaxClusterSize)
         if (N != FirstNode) {
             N = FirstNode;
             do
-                N->Zc = N->Y;
+                Cold(N)->Zc = N->Y;
             while ((N = N->Suc) != FirstNode);
             /* Transform longitude (180 and -180 map to 0) */
             From = FirstNode;
             do {
-                From->Zc = From->Y;
+                Cold(From)->Zc = From->Y;
                 if (WeightType == GEO || WeightType == GEO_MEEUS)
                     From->Y =
                         (int) From->Y + 5.0 * (From->Y -
@@ -142,11 +148,13 @@ static int DelaunayClustering(int MaxClusterSize)
                     From->Y =
                         (int) From->Y + 3.0 * (From->Y -
                                                (int) From->Y) / 5.0;
+                StoreCoordinates(From);
             } while ((From = From->Suc) != FirstNode);
             delaunay(Dimension);
-            do
-                From->Y = From->Zc;
-            while ((From = From->Suc) != FirstNode);
+            do {
+                From->Y = Cold(From)->Zc;
+                StoreCoordinates(From);
+            } while ((From = From->Suc) != FirstNode);
 
             qsort(EdgeSet, Count, sizeof(Edge), compareFromTo);
             for (i = 0; i < Dimension; i++) {
@@ -30,11 +30,11 @@ void SolveKCenterSubproblems()
     GlobalBestCost = 0;
     N = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (TraceLevel >= 1) {
         if (TraceLevel >= 2)
             printff("\n");
@@ -44,14 +44,20 @@ void SolveKCenterSubproblems()
 
     Subproblems = (int) ceil((double) Dimension / SubproblemSize);
     KCenterClustering(Subproblems);
-    for (CurrentSubproblem = 1;
-         CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
-        OldGlobalBestCost = GlobalBestCost;
-        SolveSubproblem(CurrentSubproblem, Subproblems, &GlobalBestCost);
-        if (SubproblemsCompressed && GlobalBestCost == OldGlobalBestCost)
-            SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
-                                      &GlobalBestCost);
-    }
+    if (SubproblemsInParallel())
+        SolveSubproblemsInParallel(1, Subproblems, Subproblems,
+                                   &GlobalBestCost);
+    else
+        for (CurrentSubproblem = 1;
+             CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
+            OldGlobalBestCost = GlobalBestCost;
+            SolveSubproblem(CurrentSubproblem, Subproblems,
+                            &GlobalBestCost);
+            if (SubproblemsCompressed
+                && GlobalBestCost == OldGlobalBestCost)
+                SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
+                                          &GlobalBestCost);
+        }
     printff("\nCost = " GainFormat, GlobalBestCost);
     if (Optimum != MINUS_INFINITY && Optimum != 0)
         printff(", Gap = %0.4f%%",
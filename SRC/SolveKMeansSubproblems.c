@@ -31,11 +31,11 @@ void SolveKMeansSubproblems()
     GlobalBestCost = 0;
     N = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (TraceLevel >= 1) {
         if (TraceLevel >= 2)
             printff("\n");
@@ -45,14 +45,20 @@ void SolveKMeansSubproblems()
 
     Subproblems = (int) ceil((double) Dimension / SubproblemSize);
     KMeansClustering(Subproblems);
-    for (CurrentSubproblem = 1;
-         CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
-        OldGlobalBestCost = GlobalBestCost;
-        SolveSubproblem(CurrentSubproblem, Subproblems, &GlobalBestCost);
-        if (SubproblemsCompressed && GlobalBestCost == OldGlobalBestCost)
-            SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
-                                      &GlobalBestCost);
-    }
+    if (SubproblemsInParallel())
+        SolveSubproblemsInParallel(1, Subproblems, Subproblems,
+                                   &GlobalBestCost);
+    else
+        for (CurrentSubproblem = 1;
+             CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
+            OldGlobalBestCost = GlobalBestCost;
+            SolveSubproblem(CurrentSubproblem, Subproblems,
+                            &GlobalBestCost);
+            if (SubproblemsCompressed
+                && GlobalBestCost == OldGlobalBestCost)
+                SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
+                                          &GlobalBestCost);
+        }
     printff("\nCost = " GainFormat, GlobalBestCost);
     if (Optimum != MINUS_INFINITY && Optimum != 0)
         printff(", Gap = %0.4f%%",
@@ -86,7 +92,7 @@ static void KMeansClustering(int K)
     int *Movement, *MMax, Max;
     int Moving = 0;
 
-    assert(Center = (Node *) calloc((K + 1), sizeof(Node)));
+    Center = AllocateNodes(K + 1);
     assert(SumXc = (double *) calloc(K + 1, sizeof(double)));
     assert(SumYc = (double *) calloc(K + 1, sizeof(double)));
     assert(SumZc = (double *) calloc(K + 1, sizeof(double)));
@@ -116,25 +122,25 @@ static void KMeansClustering(int K)
         N->BestPi = N->Pi;
         N->Pi = 0;
         if (WeightType == GEO || WeightType == GEO_MEEUS)
-            GEO2XYZ(N->X, N->Y, &N->Xc, &N->Yc, &N->Zc);
+            GEO2XYZ(N->X, N->Y, &Cold(N)->Xc, &Cold(N)->Yc, &Cold(N)->Zc);
         else if (WeightType == GEOM || WeightType == GEOM_MEEUS)
-            GEOM2XYZ(N->X, N->Y, &N->Xc, &N->Yc, &N->Zc);
+            GEOM2XYZ(N->X, N->Y, &Cold(N)->Xc, &Cold(N)->Yc, &Cold(N)->Zc);
         else {
-            N->Xc = N->X;
-            N->Yc = N->Y;
-            N->Zc = N->Z;
+            Cold(N)->Xc = N->X;
+            Cold(N)->Yc = N->Y;
+            Cold(N)->Zc = N->Z;
         }
         N->Cost = INT_MAX / 2;
         N->M = INT_MIN;
         N->Subproblem = N->LastV = 0;
-        SumXc[0] += N->Xc;
-        SumYc[0] += N->Yc;
-        SumZc[0] += N->Zc;
+        SumXc[0] += Cold(N)->Xc;
+        SumYc[0] += Cold(N)->Yc;
+        SumZc[0] += Cold(N)->Zc;
         Count[0]++;
     } while ((N = N->Suc) != FirstNode);
-    Xc = Center[0].Xc = SumXc[0] / Count[0];
-    Yc = Center[0].Yc = SumYc[0] / Count[0];
-    Zc = Center[0].Zc = SumZc[0] / Count[0];
+    Xc = SumXc[0] / Count[0];
+    Yc = SumYc[0] / Count[0];
+    Zc = SumZc[0] / Count[0];
     if (WeightType == GEO || WeightType == GEO_MEEUS)
         XYZ2GEO(Xc, Yc, Zc, &Center[0].X, &Center[0].Y);
     if (WeightType == GEOM || WeightType == GEOM_MEEUS)
@@ -194,13 +200,13 @@ static void KMeansClustering(int K)
                 N->M = N->NextCost - N->Cost;
                 if (N->Subproblem != OldSubproblem) {
                     Moving++;
-                    SumXc[OldSubproblem] -= N->Xc;
-                    SumYc[OldSubproblem] -= N->Yc;
-                    SumZc[OldSubproblem] -= N->Zc;
+                    SumXc[OldSubproblem] -= Cold(N)->Xc;
+                    SumYc[OldSubproblem] -= Cold(N)->Yc;
+                    SumZc[OldSubproblem] -= Cold(N)->Zc;
                     Count[OldSubproblem]--;
-                    SumXc[N->Subproblem] += N->Xc;
-                    SumYc[N->Subproblem] += N->Yc;
-                    SumZc[N->Subproblem] += N->Zc;
+                    SumXc[N->Subproblem] += Cold(N)->Xc;
+                    SumYc[N->Subproblem] += Cold(N)->Yc;
+                    SumZc[N->Subproblem] += Cold(N)->Zc;
                     Count[N->Subproblem]++;
                 }
             }
@@ -217,9 +223,9 @@ static void KMeansClustering(int K)
                 Old.X = Center[i].X;
                 Old.Y = Center[i].Y;
                 Old.Z = Center[i].Z;
-                Xc = Center[i].Xc = SumXc[i] / Count[i];
-                Yc = Center[i].Yc = SumYc[i] / Count[i];
-                Zc = Center[i].Zc = SumZc[i] / Count[i];
+                Xc = SumXc[i] / Count[i];
+                Yc = SumYc[i] / Count[i];
+                Zc = SumZc[i] / Count[i];
                 if (WeightType == GEO || WeightType == GEO_MEEUS)
                     XYZ2GEO(Xc, Yc, Zc, &Center[i].X, &Center[i].Y);
                 else if (WeightType == GEOM || WeightType == GEOM_MEEUS)
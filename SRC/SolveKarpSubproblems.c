@@ -18,9 +18,9 @@
 static void KarpPartition(int start, int end);
 static void CalculateSubproblems(int start, int end);
 
-static Node **KDTree;
-static GainType GlobalBestCost, OldGlobalBestCost;
-static int CurrentSubproblem, Subproblems;
+static THREAD_LOCAL Node **KDTree;
+static THREAD_LOCAL GainType GlobalBestCost, OldGlobalBestCost;
+static THREAD_LOCAL int CurrentSubproblem, Subproblems;
 
 void SolveKarpSubproblems()
 {
@@ -34,11 +34,11 @@ void SolveKarpSubproblems()
     GlobalBestCost = 0;
     N = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (TraceLevel >= 1) {
         if (TraceLevel >= 2)
             printff("\n");
@@ -49,14 +49,15 @@ void SolveKarpSubproblems()
         WeightType == GEO_MEEUS || WeightType == GEOM_MEEUS) {
         N = FirstNode;
         do {
-            N->Xc = N->X;
-            N->Yc = N->Y;
-            N->Zc = N->Z;
+            Cold(N)->Xc = N->X;
+            Cold(N)->Yc = N->Y;
+            Cold(N)->Zc = N->Z;
             if (WeightType == GEO || WeightType == GEO_MEEUS)
-                GEO2XYZ(N->Xc, N->Yc, &N->X, &N->Y, &N->Z);
+                GEO2XYZ(Cold(N)->Xc, Cold(N)->Yc, &N->X, &N->Y, &N->Z);
             else
-                GEOM2XYZ(N->Xc, N->Yc, &N->X, &N->Y, &N->Z);
-        } while ((N = N->SubproblemSuc) != FirstNode);
+                GEOM2XYZ(Cold(N)->Xc, Cold(N)->Yc, &N->X, &N->Y, &N->Z);
+            StoreCoordinates(N);
+        } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         CoordType = THREED_COORDS;
     }
     KDTree = BuildKDTree(SubproblemSize);
@@ -64,10 +65,11 @@ void SolveKarpSubproblems()
         WeightType == GEO_MEEUS || WeightType == GEOM_MEEUS) {
         N = FirstNode;
         do {
-            N->X = N->Xc;
-            N->Y = N->Yc;
-            N->Z = N->Zc;
-        } while ((N = N->SubproblemSuc) != FirstNode);
+            N->X = Cold(N)->Xc;
+            N->Y = Cold(N)->Yc;
+            N->Z = Cold(N)->Zc;
+            StoreCoordinates(N);
+        } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         CoordType = TWOD_COORDS;
     }
 
@@ -75,6 +77,9 @@ void SolveKarpSubproblems()
     CalculateSubproblems(0, Dimension - 1);
     CurrentSubproblem = 0;
     KarpPartition(0, Dimension - 1);
+    if (SubproblemsInParallel())
+        SolveSubproblemsInParallel(1, Subproblems, Subproblems,
+                                   &GlobalBestCost);
     free(KDTree);
     printff("\nCost = " GainFormat, GlobalBestCost);
     if (Optimum != MINUS_INFINITY && Optimum != 0)
@@ -99,6 +104,8 @@ static void KarpPartition(int start, int end)
         CurrentSubproblem++;
         for (i = start; i <= end; i++)
             KDTree[i]->Subproblem = CurrentSubproblem;
+        if (SubproblemsInParallel())
+            return;
         OldGlobalBestCost = GlobalBestCost;
         SolveSubproblem(CurrentSubproblem, Subproblems, &GlobalBestCost);
         if (SubproblemsCompressed && GlobalBestCost == OldGlobalBestCost)
@@ -24,8 +24,8 @@ static void WindowSize(double XMin, double XMax, double YMin, double YMax,
 static void MakeSubproblem(double XMin, double XMax, double YMin,
                            double YMax, double ZMin, double ZMax,
                            int Subproblem, int start, int end);
-static int Size;
-static Node **KDTree;
+static THREAD_LOCAL int Size;
+static THREAD_LOCAL Node **KDTree;
 
 void SolveRoheSubproblems()
 {
@@ -44,11 +44,11 @@ void SolveRoheSubproblems()
     GlobalBestCost = 0;
     N = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (TraceLevel >= 1) {
         if (TraceLevel >= 2)
             printff("\n");
@@ -59,21 +59,22 @@ void SolveRoheSubproblems()
         WeightType == GEO_MEEUS || WeightType == GEOM_MEEUS) {
         N = FirstNode;
         do {
-            N->Xc = N->X;
-            N->Yc = N->Y;
-            N->Zc = N->Z;
+            Cold(N)->Xc = N->X;
+            Cold(N)->Yc = N->Y;
+            Cold(N)->Zc = N->Z;
             if (WeightType == GEO || WeightType == GEO_MEEUS)
-                GEO2XYZ(N->Xc, N->Yc, &N->X, &N->Y, &N->Z);
+                GEO2XYZ(Cold(N)->Xc, Cold(N)->Yc, &N->X, &N->Y, &N->Z);
             else
-                GEOM2XYZ(N->Xc, N->Yc, &N->X, &N->Y, &N->Z);
-        } while ((N = N->SubproblemSuc) != FirstNode);
+                GEOM2XYZ(Cold(N)->Xc, Cold(N)->Yc, &N->X, &N->Y, &N->Z);
+            StoreCoordinates(N);
+        } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         CoordType = THREED_COORDS;
     }
     N = FirstNode;
     XMin = XMax = N->X;
     YMin = YMax = N->Y;
     ZMin = ZMax = N->Z;
-    while ((N = N->SubproblemSuc) != FirstNode) {
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode) {
         if (N->X < XMin)
             XMin = N->X;
         else if (N->X > XMax)
@@ -132,21 +133,28 @@ void SolveRoheSubproblems()
         || WeightType == GEOM_MEEUS) {
         N = FirstNode;
         do {
-            N->X = N->Xc;
-            N->Y = N->Yc;
-            N->Z = N->Zc;
-        } while ((N = N->SubproblemSuc) != FirstNode);
+            N->X = Cold(N)->Xc;
+            N->Y = Cold(N)->Yc;
+            N->Z = Cold(N)->Zc;
+            StoreCoordinates(N);
+        } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         CoordType = TWOD_COORDS;
     }
     free(KDTree);
-    for (CurrentSubproblem = 1;
-         CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
-        OldGlobalBestCost = GlobalBestCost;
-        SolveSubproblem(CurrentSubproblem, Subproblems, &GlobalBestCost);
-        if (SubproblemsCompressed && GlobalBestCost == OldGlobalBestCost)
-            SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
-                                      &GlobalBestCost);
-    }
+    if (SubproblemsInParallel())
+        SolveSubproblemsInParallel(1, Subproblems, Subproblems,
+                                   &GlobalBestCost);
+    else
+        for (CurrentSubproblem = 1;
+             CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
+            OldGlobalBestCost = GlobalBestCost;
+            SolveSubproblem(CurrentSubproblem, Subproblems,
+                            &GlobalBestCost);
+            if (SubproblemsCompressed
+                && GlobalBestCost == OldGlobalBestCost)
+                SolveCompressedSubproblem(CurrentSubproblem, Subproblems,
+                                          &GlobalBestCost);
+        }
     printff("\nCost = " GainFormat, GlobalBestCost);
     if (Optimum != MINUS_INFINITY && Optimum != 0)
         printff(", Gap = %0.4f%%",
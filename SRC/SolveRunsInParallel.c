@@ -0,0 +1,161 @@
+#include "LKH.h"
+#include "Genetic.h"
+#include <pthread.h>
+
+/*
+ * The SolveRunsInParallel function executes the runs on a number of
+ * worker threads (THREADS). It is called by main instead of the
+ * sequential loop over the runs.
+ *
+ * Each worker loads the context of the main thread and makes private
+ * copies of the nodes, candidate sets and tour structures (see
+ * CopyStructures). Runs are handed out to the workers one at a time.
+ * Run number r uses the random seed Seed + r - 1.
+ *
+ * When a worker has completed a run, its tour is merged with the shared
+ * best tour by means of MergeWithTour, and the shared best tour is replaced
+ * if the result is shorter. The shared best tour is kept in the BestTour
+ * array of the main thread and is protected by a mutex.
+ *
+ * The statistics are updated by the main thread, in order of run number,
+ * after all workers have finished. The distance cache statistics of each
+ * run are then added to those of the main thread.
+ */
+
+typedef struct RunResult {
+    GainType Cost;      /* Cost of the tour found in the run */
+    double Time;        /* Time used by the run */
+    int Trials;         /* Number of trials used by the run */
+    CacheCounts Counts; /* Distance cache statistics of the run */
+} RunResult;
+
+/* The state shared by the workers of one call of SolveRunsInParallel */
+typedef struct RunPool {
+    LKHContext *MainContext;    /* Context of the main thread */
+    int *SharedBestTour;        /* Shared best tour */
+    GainType SharedBestCost;    /* Cost of the shared best tour */
+    GainType SharedOptimum;     /* Best known optimum */
+    int NextRun;        /* Number of the next run to be handed out */
+    int LastRun;        /* Number of the last run to be handed out */
+    RunResult *Result;  /* Result of each run */
+    pthread_mutex_t Lock;
+} RunPool;
+
+static void *Worker(void *Arg);
+
+void SolveRunsInParallel()
+{
+    pthread_t *Thread;
+    RunPool P;
+    int i, Workers = Threads < Runs ? Threads : Runs;
+
+    if (Runs <= 0)
+        return;
+    if (TraceLevel >= 1)
+        printff("Executing %d runs on %d threads\n\n", Runs, Workers);
+    P.SharedBestTour = BestTour;
+    P.SharedBestCost = BestCost;
+    P.SharedOptimum = Optimum;
+    P.NextRun = 1;
+    P.LastRun = Runs;
+    assert(P.Result = (RunResult *) calloc(Runs + 1, sizeof(RunResult)));
+    assert(Thread = (pthread_t *) malloc(Workers * sizeof(pthread_t)));
+    pthread_mutex_init(&P.Lock, 0);
+    P.MainContext = SaveContext();
+    for (i = 0; i < Workers; i++)
+        if (pthread_create(&Thread[i], 0, Worker, &P))
+            eprintf("Cannot create thread %d", i + 1);
+    for (i = 0; i < Workers; i++)
+        pthread_join(Thread[i], 0);
+    FreeContext(P.MainContext);
+    pthread_mutex_destroy(&P.Lock);
+    free(Thread);
+    BestCost = P.SharedBestCost;
+    Optimum = P.SharedOptimum;
+    for (Run = 1; Run <= Runs; Run++)
+        AddCacheCounts(&P.Result[Run].Counts);
+    Runs = P.LastRun;
+    for (Run = 1; Run <= Runs; Run++) {
+        Trial = P.Result[Run].Trials;
+        UpdateStatistics(P.Result[Run].Cost, P.Result[Run].Time);
+    }
+    free(P.Result);
+}
+
+static void *Worker(void *Arg)
+{
+    GainType Cost, OldOptimum;
+    double LastTime, Time;
+    char *OutputTourFileNameSaved;
+    int TraceLevelSaved, Stop;
+    RunPool *P = (RunPool *) Arg;
+
+    LoadContext(P->MainContext);
+    CopyStructures();
+    /* Tours are written by the worker only after a completed run
+       has improved the shared best tour */
+    OutputTourFileNameSaved = OutputTourFileName;
+    OutputTourFileName = 0;
+    TraceLevelSaved = TraceLevel;
+    for (;;) {
+        pthread_mutex_lock(&P->Lock);
+        Run = P->NextRun++;
+        BestCost = P->SharedBestCost;
+        Optimum = P->SharedOptimum;
+        Stop = Run > P->LastRun;
+        pthread_mutex_unlock(&P->Lock);
+        if (Stop)
+            break;
+        SRandom(Seed + Run - 1);
+        LastTime = GetTime();
+        TraceLevel = 0;
+        Cost = FindTour();      /* using the Lin-Kernighan heuristic */
+        TraceLevel = TraceLevelSaved;
+        pthread_mutex_lock(&P->Lock);
+        if (P->SharedBestCost != PLUS_INFINITY) {
+            memcpy(BestTour, P->SharedBestTour,
+                   (DimensionSaved + 1) * sizeof(int));
+            Cost = MergeTourWithBestTour();
+        }
+        if (Cost < P->SharedBestCost) {
+            P->SharedBestCost = BestCost = Cost;
+            RecordBetterTour();
+            RecordBestTour();
+            memcpy(P->SharedBestTour, BestTour,
+                   (DimensionSaved + 1) * sizeof(int));
+            OutputTourFileName = OutputTourFileNameSaved;
+            WriteTour(OutputTourFileName, BestTour, BestCost);
+            WriteTour(TourFileName, BestTour, BestCost);
+            OutputTourFileName = 0;
+        }
+        OldOptimum = P->SharedOptimum;
+        if (Cost < P->SharedOptimum) {
+            if (Cold(FirstNode)->InputSuc) {
+                Node *N = FirstNode;
+                while ((N = Cold(N)->InputSuc = N->Suc) != FirstNode);
+            }
+            Optimum = P->SharedOptimum = Cost;
+            printff("*** New optimum = " GainFormat " ***\n\n", Optimum);
+        }
+        Time = fabs(GetTime() - LastTime);
+        P->Result[Run].Cost = Cost;
+        P->Result[Run].Time = Time;
+        P->Result[Run].Trials = Trial;
+        TakeCacheCounts(&P->Result[Run].Counts);
+        if (TraceLevel >= 1 && Cost != PLUS_INFINITY) {
+            printff("Run %d: Cost = " GainFormat, Run, Cost);
+            if (Optimum != MINUS_INFINITY && Optimum != 0)
+                printff(", Gap = %0.4f%%",
+                        100.0 * (Cost - Optimum) / Optimum);
+            printff(", Time = %0.2f sec. %s\n\n", Time,
+                    Cost < Optimum ? "<" : Cost == Optimum ? "=" : "");
+        }
+        if (StopAtOptimum && Cost == OldOptimum && MaxPopulationSize >= 1 &&
+            Run < P->LastRun)
+            P->LastRun = Run;
+        pthread_mutex_unlock(&P->Lock);
+    }
+    OutputTourFileName = OutputTourFileNameSaved;
+    FreeCopiedStructures();
+    return Arg;
+}
@@ -20,7 +20,8 @@
 void SolveSFCSubproblems()
 {
     Node *FirstNodeSaved, *N;
-    int CurrentSubproblem, Subproblems, Round, i;
+    int CurrentSubproblem, Subproblems, Round, i,
+        InParallel = SubproblemsInParallel();
     GainType GlobalBestCost, OldGlobalBestCost;
     Node **Suc;
     double EntryTime = GetTime();
@@ -40,11 +41,11 @@ void SolveSFCSubproblems()
     GlobalBestCost = 0;
     N = FirstNodeSaved = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     for (Round = 1; Round <= 2; Round++) {
         if (Round == 2 && Subproblems == 1)
             break;
@@ -67,19 +68,27 @@ void SolveSFCSubproblems()
                  i++, N = Suc[N->Id]) {
                 N->Subproblem =
                     (Round - 1) * Subproblems + CurrentSubproblem;
-                N->FixedTo1Saved = N->FixedTo2Saved = 0;
-                N->SubBestPred = N->SubBestSuc = 0;
+                Cold(N)->FixedTo1Saved = Cold(N)->FixedTo2Saved = 0;
+                Cold(N)->SubBestPred = Cold(N)->SubBestSuc = 0;
+            }
+            if (!InParallel) {
+                OldGlobalBestCost = GlobalBestCost;
+                SolveSubproblem((Round - 1) * Subproblems +
+                                CurrentSubproblem, Subproblems,
+                                &GlobalBestCost);
+                if (SubproblemsCompressed
+                    && GlobalBestCost == OldGlobalBestCost)
+                    SolveCompressedSubproblem((Round - 1) * Subproblems +
+                                              CurrentSubproblem,
+                                              Subproblems,
+                                              &GlobalBestCost);
             }
-            OldGlobalBestCost = GlobalBestCost;
-            SolveSubproblem((Round - 1) * Subproblems + CurrentSubproblem,
-                            Subproblems, &GlobalBestCost);
-            if (SubproblemsCompressed
-                && GlobalBestCost == OldGlobalBestCost)
-                SolveCompressedSubproblem((Round - 1) * Subproblems +
-                                          CurrentSubproblem, Subproblems,
-                                          &GlobalBestCost);
             FirstNode = N;
         }
+        if (InParallel)
+            SolveSubproblemsInParallel((Round - 1) * Subproblems + 1,
+                                       Round * Subproblems, Subproblems,
+                                       &GlobalBestCost);
     }
     free(Suc);
     printff("\nCost = " GainFormat, GlobalBestCost);
@@ -31,26 +31,26 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
     do {
         if (N->Subproblem == CurrentSubproblem) {
             if (SubproblemsCompressed &&
-                (((N->SubproblemPred == N->SubBestPred ||
-                   FixedOrCommon(N, N->SubproblemPred) ||
-                   (N->SubBestPred &&
-                    (N->FixedTo1Saved == N->SubBestPred ||
-                     N->FixedTo2Saved == N->SubBestPred))) &&
-                  (N->SubproblemSuc == N->SubBestSuc ||
-                   FixedOrCommon(N, N->SubproblemSuc) ||
-                   (N->SubBestSuc &&
-                    (N->FixedTo1Saved == N->SubBestSuc ||
-                     N->FixedTo2Saved == N->SubBestSuc)))) ||
-                 ((N->SubproblemPred == N->SubBestSuc ||
-                   FixedOrCommon(N, N->SubproblemPred) ||
-                   (N->SubBestSuc &&
-                    (N->FixedTo1Saved == N->SubBestSuc ||
-                     N->FixedTo2Saved == N->SubBestSuc))) &&
-                  (N->SubproblemSuc == N->SubBestPred ||
-                   FixedOrCommon(N, N->SubproblemSuc) ||
-                   (N->SubBestPred &&
-                    (N->FixedTo1Saved == N->SubBestPred ||
-                     N->FixedTo2Saved == N->SubBestPred))))))
+                (((Cold(N)->SubproblemPred == Cold(N)->SubBestPred ||
+                   FixedOrCommon(N, Cold(N)->SubproblemPred) ||
+                   (Cold(N)->SubBestPred &&
+                    (Cold(N)->FixedTo1Saved == Cold(N)->SubBestPred ||
+                     Cold(N)->FixedTo2Saved == Cold(N)->SubBestPred))) &&
+                  (Cold(N)->SubproblemSuc == Cold(N)->SubBestSuc ||
+                   FixedOrCommon(N, Cold(N)->SubproblemSuc) ||
+                   (Cold(N)->SubBestSuc &&
+                    (Cold(N)->FixedTo1Saved == Cold(N)->SubBestSuc ||
+                     Cold(N)->FixedTo2Saved == Cold(N)->SubBestSuc)))) ||
+                 ((Cold(N)->SubproblemPred == Cold(N)->SubBestSuc ||
+                   FixedOrCommon(N, Cold(N)->SubproblemPred) ||
+                   (Cold(N)->SubBestSuc &&
+                    (Cold(N)->FixedTo1Saved == Cold(N)->SubBestSuc ||
+                     Cold(N)->FixedTo2Saved == Cold(N)->SubBestSuc))) &&
+                  (Cold(N)->SubproblemSuc == Cold(N)->SubBestPred ||
+                   FixedOrCommon(N, Cold(N)->SubproblemSuc) ||
+                   (Cold(N)->SubBestPred &&
+                    (Cold(N)->FixedTo1Saved == Cold(N)->SubBestPred ||
+                     Cold(N)->FixedTo2Saved == Cold(N)->SubBestPred))))))
                 N->Subproblem = -CurrentSubproblem;
             else {
                 if (!FirstNode)
@@ -58,13 +58,13 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
                 NewDimension++;
             }
             N->Head = N->Tail = 0;
-            if (N->SubBestSuc)
+            if (Cold(N)->SubBestSuc)
                 OldDimension++;
         }
-        N->SubBestPred = N->SubBestSuc = 0;
-        N->FixedTo1Saved = N->FixedTo1;
-        N->FixedTo2Saved = N->FixedTo2;
-    } while ((N = N->SubproblemSuc) != FirstNodeSaved);
+        Cold(N)->SubBestPred = Cold(N)->SubBestSuc = 0;
+        Cold(N)->FixedTo1Saved = N->FixedTo1;
+        Cold(N)->FixedTo2Saved = N->FixedTo2;
+    } while ((N = Cold(N)->SubproblemSuc) != FirstNodeSaved);
     if ((Number = CurrentSubproblem % Subproblems) == 0)
         Number = Subproblems;
     if (NewDimension <= 3 || NewDimension == OldDimension) {
@@ -92,7 +92,7 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
         MaxTrials = NewDimension;
     N = FirstNode;
     do {
-        Next = N->SubproblemSuc;
+        Next = Cold(N)->SubproblemSuc;
         if (N->Subproblem == CurrentSubproblem) {
             N->Pred = N->Suc = N;
             if (N != FirstNode)
@@ -126,23 +126,24 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
     Dimension = NewDimension;
     AllocateSegments();
     InitializeStatistics();
-    if (CacheSig)
-        for (i = 0; i <= CacheMask; i++)
-            CacheSig[i] = 0;
+    if (Cache)
+        memset(Cache, 0, (CacheMask + 1) * CacheWays * sizeof(CacheEntry));
     OptimumSaved = Optimum;
     Optimum = 0;
     N = FirstNode;
     do {
-        if (N->SubproblemSuc == N->InitialSuc ||
-            N->SubproblemPred == N->InitialSuc)
+        if (Cold(N)->SubproblemSuc == Cold(N)->InitialSuc ||
+            Cold(N)->SubproblemPred == Cold(N)->InitialSuc)
             InitialTourEdges++;
         if (!Fixed(N, N->Suc))
             Optimum += Distance(N, N->Suc);
         if (N->FixedTo1 && N->Subproblem != N->FixedTo1->Subproblem)
-            eprintf("Illegal fixed edge (%d,%d)", N->Id, N->FixedTo1->Id);
+            eprintf("Illegal fixed edge (%d,%d)", ExternalId(N->Id),
+                    ExternalId(N->FixedTo1->Id));
         if (N->FixedTo2 && N->Subproblem != N->FixedTo2->Subproblem)
-            eprintf("Illegal fixed edge (%d,%d)", N->Id, N->FixedTo2->Id);
-        N->BestSuc = N->Suc;
+            eprintf("Illegal fixed edge (%d,%d)", ExternalId(N->Id),
+                    ExternalId(N->FixedTo2->Id));
+        Cold(N)->BestSuc = N->Suc;
     }
     while ((N = N->Suc) != FirstNode);
     if (TraceLevel >= 1)
@@ -165,7 +166,7 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
                 Last = N;
             }
         }
-        while ((N = N->SubproblemSuc) != FirstNode);
+        while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         Last->Next = FirstNode;
         Cost = MergeWithTour();
         if (MaxPopulationSize > 1) {
@@ -187,8 +188,8 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
         if (Cost < BestCost) {
             N = FirstNode;
             do {
-                N->SubBestPred = N->Pred;
-                N->SubBestSuc = N->Suc;
+                Cold(N)->SubBestPred = N->Pred;
+                Cold(N)->SubBestSuc = N->Suc;
             } while ((N = N->Suc) != FirstNode);
             BestCost = Cost;
         }
@@ -199,71 +200,8 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
                 Optimum = Cost;
             } else
                 GlobalCost = *GlobalBestCost - Improvement;
-            N = FirstNode;
-            do
-                N->Mark = 0;
-            while ((N = N->SubproblemSuc) != FirstNode);
-            do {
-                N->Mark = N;
-                if (!N->SubproblemSuc->Mark &&
-                    (N->Subproblem != CurrentSubproblem ||
-                     N->SubproblemSuc->Subproblem != CurrentSubproblem))
-                    N->BestSuc = N->SubproblemSuc;
-                else if (!N->SubproblemPred->Mark &&
-                         (N->Subproblem != CurrentSubproblem ||
-                          N->SubproblemPred->Subproblem !=
-                          CurrentSubproblem))
-                    N->BestSuc = N->SubproblemPred;
-                else if (!N->Suc->Mark)
-                    N->BestSuc = N->Suc;
-                else if (!N->Pred->Mark)
-                    N->BestSuc = N->Pred;
-                else
-                    N->BestSuc = FirstNode;
-            }
-            while ((N = N->BestSuc) != FirstNode);
-            Dimension = ProblemType != ATSP ? DimensionSaved : 
-                2 * DimensionSaved;
-            i = 0;
-            do {
-                if (ProblemType != ATSP)
-                    BetterTour[++i] = N->Id;
-                else if (N->Id <= Dimension / 2) {
-                    i++;
-                    if (N->BestSuc->Id != N->Id + Dimension / 2)
-                        BetterTour[i] = N->Id;
-                    else
-                        BetterTour[Dimension / 2 - i + 1] = N->Id;
-                }
-            }
-            while ((N = N->BestSuc) != FirstNode);
-            BetterTour[0] =
-                BetterTour[ProblemType !=
-                           ATSP ? Dimension : Dimension / 2];
-            WriteTour(OutputTourFileName, BetterTour, GlobalCost);
-            if (Improvement > 0) {
-                do
-                    if (N->Subproblem != CurrentSubproblem)
-                        break;
-                while ((N = N->SubproblemPred) != FirstNode);
-                if (N->SubproblemSuc == N->BestSuc) {
-                    N = FirstNode;
-                    do {
-                        N->BestSuc->SubproblemPred = N;
-                        N = N->SubproblemSuc = N->BestSuc;
-                    }
-                    while (N != FirstNode);
-                } else {
-                    N = FirstNode;
-                    do
-                        (N->SubproblemPred = N->BestSuc)->SubproblemSuc =
-                            N;
-                    while ((N = N->BestSuc) != FirstNode);
-                }
-                RecordBestTour();
-                WriteTour(TourFileName, BestTour, GlobalCost);
-            }
-            Dimension = NewDimension;
+            InsertSubproblemTour(CurrentSubproblem, GlobalCost,
+                                 Improvement > 0);
             if (TraceLevel >= 1) {
                 printff("*** %d: Cost = " GainFormat, Number, GlobalCost);
                 if (OptimumSaved != MINUS_INFINITY && OptimumSaved != 0)
@@ -297,7 +235,7 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
                 int d = C(N, N->Suc);
                 AddCandidate(N, N->Suc, d, INT_MAX);
                 AddCandidate(N->Suc, N, d, INT_MAX);
-                N = N->InitialSuc = N->Suc;
+                N = Cold(N)->InitialSuc = N->Suc;
             }
             while (N != FirstNode);
         }
@@ -310,19 +248,21 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
         PrintStatistics();
 
     if (C == C_EXPLICIT) {
+        int *Id, Ids;
+        Id = SortedNodeIds(&Ids);
         N = FirstNode;
         do {
-            for (i = 1; i < N->Id; i++) {
-                N->C[i] -= N->Pi + NodeSet[i].Pi;
-                N->C[i] /= Precision;
+            for (i = 0; i < Ids && Id[i] < N->Id; i++) {
+                N->C[Id[i]] -= N->Pi + NodeSet[Id[i]].Pi;
+                N->C[Id[i]] /= Precision;
             }
-            if (N->FixedTo1 && N->FixedTo1 != N->FixedTo1Saved) {
+            if (N->FixedTo1 && N->FixedTo1 != Cold(N)->FixedTo1Saved) {
                 if (N->Id > N->FixedTo1->Id)
                     N->C[N->FixedTo1->Id] = N->SavedCost;
                 else
                     N->FixedTo1->C[N->Id] = N->FixedTo1->SavedCost;
             }
-            if (N->FixedTo2 && N->FixedTo2 != N->FixedTo2Saved) {
+            if (N->FixedTo2 && N->FixedTo2 != Cold(N)->FixedTo2Saved) {
                 if (N->Id > N->FixedTo2->Id)
                     N->C[N->FixedTo2->Id] = N->SavedCost;
                 else
@@ -330,6 +270,7 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
             }
         }
         while ((N = N->Suc) != FirstNode);
+        free(Id);
     }
 
     FreeSegments();
@@ -337,24 +278,24 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
     FreePopulation();
     if (InitialTourEdges == Dimension) {
         do
-            N->InitialSuc = N->SubproblemSuc;
-        while ((N = N->SubproblemSuc) != FirstNode);
+            Cold(N)->InitialSuc = Cold(N)->SubproblemSuc;
+        while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     } else {
         do
-            N->InitialSuc = 0;
-        while ((N = N->SubproblemSuc) != FirstNode);
+            Cold(N)->InitialSuc = 0;
+        while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     }
     Dimension = ProblemType != ATSP ? DimensionSaved : 2 * DimensionSaved;
     N = FirstNode = FirstNodeSaved;
     do {
-        N->Suc = N->BestSuc = N->SubproblemSuc;
+        N->Suc = Cold(N)->BestSuc = Cold(N)->SubproblemSuc;
         N->Suc->Pred = N;
         Next = N->FixedTo1;
-        N->FixedTo1 = N->FixedTo1Saved;
-        N->FixedTo1Saved = Next;
+        N->FixedTo1 = Cold(N)->FixedTo1Saved;
+        Cold(N)->FixedTo1Saved = Next;
         Next = N->FixedTo2;
-        N->FixedTo2 = N->FixedTo2Saved;
-        N->FixedTo2Saved = Next;
+        N->FixedTo2 = Cold(N)->FixedTo2Saved;
+        Cold(N)->FixedTo2Saved = Next;
     }
     while ((N = N->Suc) != FirstNode);
     Optimum = OptimumSaved;
@@ -364,3 +305,89 @@ SolveSubproblem(int CurrentSubproblem, int Subproblems,
     MaxTrials = MaxTrialsSaved;
     return 1;
 }
+
+/*
+ * The InsertSubproblemTour function inserts the tour of a subproblem into
+ * the tour of the overall problem. The subproblem is identified by the 
+ * parameter CurrentSubproblem, and its tour is given by the Suc and Pred
+ * references of its nodes. The tour of the overall problem is given by 
+ * the SubproblemSuc and SubproblemPred references of the nodes. 
+ *
+ * The resulting tour is written to OutputTourFile. The parameter GlobalCost
+ * is the cost of this tour. If the parameter Improved is nonzero, the 
+ * resulting tour becomes the new tour of the overall problem and is 
+ * written to TourFile. 
+ *
+ * At entry, FirstNode must be a node of the subproblem.
+ */
+
+void InsertSubproblemTour(int CurrentSubproblem, GainType GlobalCost,
+                          int Improved)
+{
+    Node *N;
+    int DimensionSubproblem = Dimension, i;
+
+    N = FirstNode;
+    do
+        N->Mark = 0;
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
+    do {
+        N->Mark = N;
+        if (!Cold(N)->SubproblemSuc->Mark &&
+            (N->Subproblem != CurrentSubproblem ||
+             Cold(N)->SubproblemSuc->Subproblem != CurrentSubproblem))
+            Cold(N)->BestSuc = Cold(N)->SubproblemSuc;
+        else if (!Cold(N)->SubproblemPred->Mark &&
+                 (N->Subproblem != CurrentSubproblem ||
+                  Cold(N)->SubproblemPred->Subproblem != CurrentSubproblem))
+            Cold(N)->BestSuc = Cold(N)->SubproblemPred;
+        else if (!N->Suc->Mark)
+            Cold(N)->BestSuc = N->Suc;
+        else if (!N->Pred->Mark)
+            Cold(N)->BestSuc = N->Pred;
+        else
+            Cold(N)->BestSuc = FirstNode;
+    }
+    while ((N = Cold(N)->BestSuc) != FirstNode);
+    Dimension = ProblemType != ATSP ? DimensionSaved : 2 * DimensionSaved;
+    i = 0;
+    do {
+        if (ProblemType != ATSP)
+            BetterTour[++i] = N->Id;
+        else if (N->Id <= Dimension / 2) {
+            i++;
+            if (Cold(N)->BestSuc->Id != N->Id + Dimension / 2)
+                BetterTour[i] = N->Id;
+            else
+                BetterTour[Dimension / 2 - i + 1] = N->Id;
+        }
+    }
+    while ((N = Cold(N)->BestSuc) != FirstNode);
+    BetterTour[0] =
+        BetterTour[ProblemType != ATSP ? Dimension : Dimension / 2];
+    WriteTour(OutputTourFileName, BetterTour, GlobalCost);
+    if (Improved) {
+        do
+            if (N->Subproblem != CurrentSubproblem)
+                break;
+        while ((N = Cold(N)->SubproblemPred) != FirstNode);
+        if (Cold(N)->SubproblemSuc == Cold(N)->BestSuc) {
+            N = FirstNode;
+            do {
+                Cold(Cold(N)->BestSuc)->SubproblemPred = N;
+                N = Cold(N)->SubproblemSuc = Cold(N)->BestSuc;
+            }
+            while (N != FirstNode);
+        } else {
+            N = FirstNode;
+            do {
+                Cold(N)->SubproblemPred = Cold(N)->BestSuc;
+                Cold(Cold(N)->BestSuc)->SubproblemSuc = N;
+            }
+            while ((N = Cold(N)->BestSuc) != FirstNode);
+        }
+        RecordBestTour();
+        WriteTour(TourFileName, BestTour, GlobalCost);
+    }
+    Dimension = DimensionSubproblem;
+}
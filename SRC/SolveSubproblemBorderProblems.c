@@ -39,15 +39,15 @@ void SolveSubproblemBorderProblems(int Subproblems,
     /* Compute upper bound for the original problem */
     N = FirstNode;
     do {
-        N->Suc = N->SubproblemSuc;
+        N->Suc = Cold(N)->SubproblemSuc;
         N->Suc->Pred = N;
         if (N->Subproblem > Subproblems)
             N->Subproblem -= Subproblems;
         SubproblemSaved[N->Id] = N->Subproblem;
-        N->FixedTo1Saved = N->FixedTo2Saved = 0;
-        N->SubBestPred = N->SubBestSuc = 0;
+        Cold(N)->FixedTo1Saved = Cold(N)->FixedTo2Saved = 0;
+        Cold(N)->SubBestPred = Cold(N)->SubBestSuc = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (TraceLevel >= 1)
         printff("\n*** Solve subproblem border problems *** [" GainFormat
                 "]\n", *GlobalBestCost);
@@ -62,7 +62,7 @@ void SolveSubproblemBorderProblems(int Subproblems,
         N = FirstNode;
         do
             N->Subproblem = SubproblemSaved[N->Id];
-        while ((N = N->SubproblemSuc) != FirstNode);
+        while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     }
     free(SubproblemSaved);
     printff("\nCost = " GainFormat, *GlobalBestCost);
@@ -95,14 +95,15 @@ static void MarkBorderPoints(int CurrentSubproblem)
         WeightType == GEO_MEEUS || WeightType == GEOM_MEEUS) {
         N = FirstNode;
         do {
-            N->Xc = N->X;
-            N->Yc = N->Y;
-            N->Zc = N->Z;
+            Cold(N)->Xc = N->X;
+            Cold(N)->Yc = N->Y;
+            Cold(N)->Zc = N->Z;
             if (WeightType == GEO || WeightType == GEO_MEEUS)
-                GEO2XYZ(N->Xc, N->Yc, &N->X, &N->Y, &N->Z);
+                GEO2XYZ(Cold(N)->Xc, Cold(N)->Yc, &N->X, &N->Y, &N->Z);
             else
-                GEOM2XYZ(N->Xc, N->Yc, &N->X, &N->Y, &N->Z);
-        } while ((N = N->SubproblemSuc) != FirstNode);
+                GEOM2XYZ(Cold(N)->Xc, Cold(N)->Yc, &N->X, &N->Y, &N->Z);
+            StoreCoordinates(N);
+        } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         CoordType = THREED_COORDS;
     }
     N = FirstNode;
@@ -116,7 +117,7 @@ static void MarkBorderPoints(int CurrentSubproblem)
             }
             ActualSubproblemSize++;
         }
-    } while ((N = N->SubproblemSuc) != FirstNode);
+    } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     do {
         if (N->Subproblem == CurrentSubproblem ||
             (N->X >= Min[0] && N->X <= Max[0] &&
@@ -163,12 +164,12 @@ static void MarkBorderPoints(int CurrentSubproblem)
         }
         N->Subproblem = 0;
         if (!SubproblemsCompressed ||
-            ((N->SubproblemPred != N->SubBestPred ||
-              N->SubproblemSuc != N->SubBestSuc) &&
-             (N->SubproblemPred != N->SubBestSuc ||
-              N->SubproblemSuc != N->SubBestPred)))
+            ((Cold(N)->SubproblemPred != Cold(N)->SubBestPred ||
+              Cold(N)->SubproblemSuc != Cold(N)->SubBestSuc) &&
+             (Cold(N)->SubproblemPred != Cold(N)->SubBestSuc ||
+              Cold(N)->SubproblemSuc != Cold(N)->SubBestPred)))
             A[Size++] = N;
-    } while ((N = N->SubproblemSuc) != FirstNode);
+    } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     if (ActualSubproblemSize > Size)
         ActualSubproblemSize = Size;
     else
@@ -180,10 +181,11 @@ static void MarkBorderPoints(int CurrentSubproblem)
         WeightType == GEO_MEEUS || WeightType == GEOM_MEEUS) {
         N = FirstNode;
         do {
-            N->X = N->Xc;
-            N->Y = N->Yc;
-            N->Z = N->Zc;
-        } while ((N = N->SubproblemSuc) != FirstNode);
+            N->X = Cold(N)->Xc;
+            N->Y = Cold(N)->Yc;
+            N->Z = Cold(N)->Zc;
+            StoreCoordinates(N);
+        } while ((N = Cold(N)->SubproblemSuc) != FirstNode);
         CoordType = TWOD_COORDS;
     }
 }
@@ -0,0 +1,494 @@
+#include "LKH.h"
+#include "Genetic.h"
+#include <pthread.h>
+
+/*
+ * The SolveSubproblemsInParallel function solves the subproblems with
+ * numbers FirstSubproblem, ..., LastSubproblem concurrently. It is called
+ * by the partitioning functions (SolveKarpSubproblems, etc.) instead of
+ * calling SolveSubproblem for one subproblem after another, if
+ * SubproblemsInParallel returns 1.
+ *
+ * At entry, the Subproblem field of each node must contain the number of
+ * the subproblem to which the node belongs. The tour of the overall problem
+ * is given by the SubproblemSuc references of the nodes.
+ *
+ * The function works in three steps:
+ *
+ * (1) Each subproblem is extracted from the current tour as in
+ *     SolveSubproblem: its nodes are linked in tour order, and edges are
+ *     fixed between nodes that are connected by tour segments whose
+ *     interior nodes do not belong to the subproblem.
+ *
+ * (2) The subproblems are handed out to a number of worker threads
+ *     (THREADS). A worker owns the nodes of the subproblem it is solving
+ *     and uses private versions of all other structures (segments, hash
+ *     table, distance cache, etc.). If the problem has a cost matrix, the
+ *     nodes are given private rows of it (see PrivateCostMatrix).
+ *     Subproblem number j uses its own random seed,
+ *     Seed + (j - FirstSubproblem) * Runs + 1, from which all its random
+ *     values are derived (including the hash values, Rand, of its nodes).
+ *     Since Gain23 is also made to start afresh, the tour found for a
+ *     subproblem does not depend on the worker that solves it, nor on the
+ *     number of workers.
+ *
+ * (3) The improvements are committed to the tour in order of subproblem
+ *     number. The improvement of a subproblem is committed only if its
+ *     fixed edges have not been changed by the improvements committed
+ *     before it. Otherwise, the subproblem is solved once more by
+ *     SolveSubproblem.
+ */
+
+typedef struct SubproblemData {
+    Node **Tour;        /* The nodes of the subproblem in tour order */
+    Node **BestTour;    /* The best tour found for the subproblem */
+    int Dimension;      /* Number of nodes in the subproblem */
+    int FixedEdges;     /* Number of edges fixed by the extraction */
+    int FirstPosition, LastPosition;    /* Positions in the overall tour
+                                           of the first and last node */
+    GainType UpperBound;        /* Cost of the subproblem's part of the
+                                   tour */
+    GainType Cost;      /* Cost of the best tour found */
+    double Time;        /* Time used for solving the subproblem */
+    unsigned Seed;      /* Seed for random number generation */
+    CacheCounts Counts; /* Distance cache statistics of the solution */
+} SubproblemData;
+
+/* The state shared by the workers of one call of
+   SolveSubproblemsInParallel */
+typedef struct SubproblemPool {
+    LKHContext *MainContext;    /* Context of the main thread */
+    SubproblemData *Data;       /* Data of each subproblem */
+    Node **Partner;     /* Partner[2 * Id] and Partner[2 * Id + 1] are the
+                           nodes connected to node Id by fixed edges of
+                           its subproblem */
+    int First;          /* Number of the first subproblem */
+    int Count;          /* Number of subproblems */
+    int NextSubproblem; /* Index of the next subproblem to be handed out */
+    pthread_mutex_t Lock;
+} SubproblemPool;
+
+static void ExtractSubproblems(SubproblemPool * P);
+static void AddPartners(SubproblemPool * P, Node * a, Node * b);
+static void *Worker(void *Arg);
+static void Solve(SubproblemPool * P, SubproblemData * S);
+static int *PrivateCostMatrix(SubproblemPool * P, SubproblemData * S,
+                              int **SharedRow);
+static int FixedEdgesUnchanged(SubproblemPool * P, SubproblemData * S,
+                               int CurrentSubproblem);
+
+#define IsPartner(P, a, b)\
+    ((P)->Partner[2 * (a)->Id] == (b) ||\
+     (P)->Partner[2 * (a)->Id + 1] == (b))
+
+int SubproblemsInParallel()
+{
+    return Threads > 1 && !SubproblemsCompressed &&
+        MaxPopulationSize <= 1 && CandidateFiles == 0;
+}
+
+void SolveSubproblemsInParallel(int FirstSubproblem, int LastSubproblem,
+                                int Subproblems, GainType * GlobalBestCost)
+{
+    Node *FirstNodeSaved = FirstNode, *N, **Tour, **BestTour;
+    SubproblemData *S;
+    SubproblemPool P;
+    pthread_t *Thread;
+    int CurrentSubproblem, Number, InitialTourEdges, Changed = 0,
+        Workers, i, j;
+
+    P.First = FirstSubproblem;
+    P.Count = LastSubproblem - FirstSubproblem + 1;
+    if (P.Count <= 0)
+        return;
+    assert(P.Data =
+           (SubproblemData *) calloc(P.Count, sizeof(SubproblemData)));
+    assert(Tour = (Node **) malloc(Dimension * sizeof(Node *)));
+    assert(BestTour = (Node **) malloc(Dimension * sizeof(Node *)));
+    assert(P.Partner =
+           (Node **) malloc(2 * (Dimension + 1) * sizeof(Node *)));
+    for (i = 1; i <= Dimension; i++)
+        if ((j = NodeSet[i].Subproblem - P.First) >= 0 && j < P.Count)
+            P.Data[j].Dimension++;
+    for (j = i = 0; j < P.Count; i += P.Data[j++].Dimension) {
+        P.Data[j].Tour = Tour + i;
+        P.Data[j].BestTour = BestTour + i;
+        P.Data[j].Seed = Seed + j * Runs + 1;
+    }
+    ExtractSubproblems(&P);
+
+    /* Solve the subproblems */
+    Workers = Threads < P.Count ? Threads : P.Count;
+    assert(Thread = (pthread_t *) malloc(Workers * sizeof(pthread_t)));
+    P.NextSubproblem = 0;
+    pthread_mutex_init(&P.Lock, 0);
+    P.MainContext = SaveContext();
+    for (i = 0; i < Workers; i++)
+        if (pthread_create(&Thread[i], 0, Worker, &P))
+            eprintf("Cannot create thread %d", i + 1);
+    for (i = 0; i < Workers; i++)
+        pthread_join(Thread[i], 0);
+    FreeContext(P.MainContext);
+    pthread_mutex_destroy(&P.Lock);
+    free(Thread);
+    for (j = 0; j < P.Count; j++)
+        AddCacheCounts(&P.Data[j].Counts);
+    N = FirstNode;
+    do {
+        N->FixedTo1 = Cold(N)->FixedTo1Saved;
+        N->FixedTo2 = Cold(N)->FixedTo2Saved;
+    }
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
+
+    /* Commit the improvements in order of subproblem number */
+    for (j = 0; j < P.Count; j++) {
+        S = &P.Data[j];
+        CurrentSubproblem = P.First + j;
+        if ((Number = CurrentSubproblem % Subproblems) == 0)
+            Number = Subproblems;
+        if (S->Dimension <= 3) {
+            if (TraceLevel >= 1)
+                printff("\nSubproblem %d of %d: Dimension = %d "
+                        "(too small)\n", Number, Subproblems, S->Dimension);
+            continue;
+        }
+        if (S->Cost < S->UpperBound && Changed &&
+            !FixedEdgesUnchanged(&P, S, CurrentSubproblem)) {
+            SolveSubproblem(CurrentSubproblem, Subproblems, GlobalBestCost);
+            Changed = 1;
+            continue;
+        }
+        if (TraceLevel >= 1)
+            printff("\nSubproblem %d of %d: Dimension = %d, Upper bound = "
+                    GainFormat "\n", Number, Subproblems, S->Dimension,
+                    S->UpperBound);
+        InitialTourEdges = 0;
+        for (i = 0; i < S->Dimension; i++) {
+            N = S->Tour[i];
+            if (Cold(N)->SubproblemSuc == Cold(N)->InitialSuc ||
+                Cold(N)->SubproblemPred == Cold(N)->InitialSuc)
+                InitialTourEdges++;
+        }
+        if (S->Cost < S->UpperBound) {
+            for (i = 0; i < S->Dimension; i++)
+                Link(S->BestTour[i], S->BestTour[(i + 1) % S->Dimension]);
+            FirstNode = S->Tour[0];
+            *GlobalBestCost -= S->UpperBound - S->Cost;
+            InsertSubproblemTour(CurrentSubproblem, *GlobalBestCost, 1);
+            Changed = 1;
+            if (TraceLevel >= 1) {
+                printff("*** %d: Cost = " GainFormat, Number,
+                        *GlobalBestCost);
+                if (Optimum != MINUS_INFINITY && Optimum != 0)
+                    printff(", Gap = %0.4f%%",
+                            100.0 * (*GlobalBestCost - Optimum) / Optimum);
+                printff(", Time = %0.2f sec. %s\n", S->Time,
+                        *GlobalBestCost < Optimum ? "<" :
+                        *GlobalBestCost == Optimum ? "=" : "");
+            }
+        }
+        N = FirstNode;
+        if (InitialTourEdges == S->Dimension) {
+            do
+                Cold(N)->InitialSuc = Cold(N)->SubproblemSuc;
+            while ((N = Cold(N)->SubproblemSuc) != FirstNode);
+        } else {
+            do
+                Cold(N)->InitialSuc = 0;
+            while ((N = Cold(N)->SubproblemSuc) != FirstNode);
+        }
+    }
+    Seed += P.Count * Runs;
+    N = FirstNode = FirstNodeSaved;
+    do
+        (N->Suc = Cold(N)->BestSuc = Cold(N)->SubproblemSuc)->Pred = N;
+    while ((N = N->Suc) != FirstNode);
+    free(P.Data);
+    free(Tour);
+    free(BestTour);
+    free(P.Partner);
+}
+
+/*
+ * The ExtractSubproblems function links the nodes of each subproblem in
+ * the order given by the tour of the overall problem, and fixes the edges
+ * between nodes that are connected by tour segments outside the subproblem.
+ * The original fixed edges of the nodes are saved in their FixedTo1Saved
+ * and FixedTo2Saved fields.
+ */
+
+static void ExtractSubproblems(SubproblemPool * P)
+{
+    Node *N, *Last, *Next;
+    SubproblemData *S;
+    int CurrentSubproblem, Position = 0, i, j;
+
+    for (j = 0; j < P->Count; j++)
+        P->Data[j].Dimension = 0;
+    N = FirstNode;
+    do {
+        Cold(N)->FixedTo1Saved = N->FixedTo1;
+        Cold(N)->FixedTo2Saved = N->FixedTo2;
+        Cold(N)->SubBestPred = Cold(N)->SubBestSuc = 0;
+        P->Partner[2 * N->Id] = P->Partner[2 * N->Id + 1] = 0;
+        if ((j = N->Subproblem - P->First) >= 0 && j < P->Count) {
+            S = &P->Data[j];
+            N->Head = N->Tail = 0;
+            if (S->Dimension == 0)
+                S->FirstPosition = Position;
+            else if (Position - S->LastPosition > 1) {
+                AddPartners(P, S->Tour[S->Dimension - 1], N);
+                S->FixedEdges++;
+            }
+            S->Tour[S->Dimension++] = N;
+            S->LastPosition = Position;
+        }
+        Position++;
+    }
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
+    for (j = 0; j < P->Count; j++) {
+        S = &P->Data[j];
+        if (S->Dimension <= 3)
+            continue;
+        if (S->LastPosition - S->FirstPosition < Position - 1) {
+            AddPartners(P, S->Tour[S->Dimension - 1], S->Tour[0]);
+            S->FixedEdges++;
+        }
+        CurrentSubproblem = P->First + j;
+        for (i = 0; i < S->Dimension; i++) {
+            Last = S->Tour[i];
+            Next = S->Tour[(i + 1) % S->Dimension];
+            Link(Last, Next);
+            if (!IsPartner(P, Last, Next) || Fixed(Last, Next))
+                continue;
+            if (!Last->FixedTo1
+                || Last->FixedTo1->Subproblem != CurrentSubproblem)
+                Last->FixedTo1 = Next;
+            else
+                Last->FixedTo2 = Next;
+            if (!Next->FixedTo1
+                || Next->FixedTo1->Subproblem != CurrentSubproblem)
+                Next->FixedTo1 = Last;
+            else
+                Next->FixedTo2 = Last;
+        }
+    }
+}
+
+static void AddPartners(SubproblemPool * P, Node * a, Node * b)
+{
+    P->Partner[2 * a->Id + (P->Partner[2 * a->Id] != 0)] = b;
+    P->Partner[2 * b->Id + (P->Partner[2 * b->Id] != 0)] = a;
+}
+
+static void *Worker(void *Arg)
+{
+    SubproblemData *S;
+    double LastTime;
+    int j;
+    SubproblemPool *P = (SubproblemPool *) Arg;
+
+    LoadContext(P->MainContext);
+    DetachStructures();
+    TraceLevel = 0;
+    /* The candidate sets of a subproblem are generated by the worker alone */
+    Threads = 1;
+    for (;;) {
+        pthread_mutex_lock(&P->Lock);
+        j = P->NextSubproblem++;
+        pthread_mutex_unlock(&P->Lock);
+        if (j >= P->Count)
+            break;
+        S = &P->Data[j];
+        if (S->Dimension <= 3)
+            continue;
+        LastTime = GetTime();
+        Solve(P, S);
+        S->Time = fabs(GetTime() - LastTime);
+        TakeCacheCounts(&S->Counts);
+    }
+    /* The nodes are owned by the main thread */
+    NodeSet = FirstNode = 0;
+    ColdNodeSet = 0;
+    FreeCopiedStructures();
+    return Arg;
+}
+
+/*
+ * The Solve function solves an extracted subproblem. The best tour found
+ * and its cost are stored in S->BestTour and S->Cost. The tour of the
+ * subproblem before the call is used as the upper bound, S->UpperBound.
+ */
+
+static void Solve(SubproblemPool * P, SubproblemData * S)
+{
+    Node *N;
+    GainType Cost;
+    double ExcessSaved = Excess;
+    int AscentCandidatesSaved = AscentCandidates,
+        InitialPeriodSaved = InitialPeriod, MaxTrialsSaved = MaxTrials,
+        **SharedRow = 0, *Entries = 0, i;
+
+    Dimension = S->Dimension;
+    FirstNode = S->Tour[0];
+    if (AscentCandidates > Dimension - 1)
+        AscentCandidates = Dimension - 1;
+    if (InitialPeriod < 0) {
+        InitialPeriod = Dimension / 2;
+        if (InitialPeriod < 100)
+            InitialPeriod = 100;
+    }
+    if (Excess < 0)
+        Excess = 1.0 / Dimension;
+    if (MaxTrials == -1)
+        MaxTrials = Dimension;
+    AllocateSegments();
+    InitializeStatistics();
+    if (Cache)
+        memset(Cache, 0, (CacheMask + 1) * CacheWays * sizeof(CacheEntry));
+    if (C == C_EXPLICIT) {
+        assert(SharedRow = (int **) malloc(S->Dimension * sizeof(int *)));
+        Entries = PrivateCostMatrix(P, S, SharedRow);
+    }
+    Optimum = 0;
+    N = FirstNode;
+    do {
+        if (!Fixed(N, N->Suc))
+            Optimum += Distance(N, N->Suc);
+        if (N->FixedTo1 && N->Subproblem != N->FixedTo1->Subproblem)
+            eprintf("Illegal fixed edge (%d,%d)", ExternalId(N->Id),
+                    ExternalId(N->FixedTo1->Id));
+        if (N->FixedTo2 && N->Subproblem != N->FixedTo2->Subproblem)
+            eprintf("Illegal fixed edge (%d,%d)", ExternalId(N->Id),
+                    ExternalId(N->FixedTo2->Id));
+        Cold(N)->BestSuc = N->Suc;
+    }
+    while ((N = N->Suc) != FirstNode);
+    S->UpperBound = Optimum;
+    SRandom(Seed = S->Seed);
+    N = FirstNode;
+    do
+        Rand[N->Id] = Random();
+    while ((N = N->Suc) != FirstNode);
+    SRandom(Seed);
+    Gain23Resets++;
+    FreeCandidateSets();
+    CreateCandidateSet();
+
+    BestCost = PLUS_INFINITY;
+    for (Run = 1; Run <= Runs; Run++) {
+        Cost = Norm != 0 ? FindTour() : Optimum;
+        /* Merge with subproblem tour */
+        for (i = 0; i < Dimension; i++)
+            S->Tour[i]->Next = S->Tour[(i + 1) % Dimension];
+        Cost = MergeWithTour();
+        if (Cost < BestCost) {
+            i = 0;
+            N = FirstNode;
+            do
+                S->BestTour[i++] = N;
+            while ((N = N->Suc) != FirstNode);
+            BestCost = Cost;
+        }
+        if (Cost < Optimum)
+            Optimum = Cost;
+        SRandom(++Seed);
+        if (Norm == 0)
+            break;
+    }
+    S->Cost = BestCost;
+    FreeSegments();
+    FreeCandidateSets();
+    if (Entries) {
+        for (i = 0; i < S->Dimension; i++)
+            S->Tour[i]->C = SharedRow[i];
+        free(Entries);
+        free(SharedRow);
+    }
+    Excess = ExcessSaved;
+    AscentCandidates = AscentCandidatesSaved;
+    InitialPeriod = InitialPeriodSaved;
+    MaxTrials = MaxTrialsSaved;
+}
+
+/*
+ * The PrivateCostMatrix function gives the nodes of a subproblem private
+ * rows of the cost matrix, so that the worker may transform the costs of
+ * the subproblem (see CreateCandidateSet) without touching the shared
+ * matrix. The row of a node N holds its entries for the Ids
+ * MinId, ..., N->Id - 1, where MinId is the smallest Id in the subproblem.
+ * Only the entries between nodes of the subproblem are copied. As in
+ * SolveSubproblem, the edges fixed by the extraction get cost 0.
+ *
+ * The shared rows of the nodes are stored in SharedRow, in tour order.
+ * The function returns the block of memory holding the private rows.
+ */
+
+static int *PrivateCostMatrix(SubproblemPool * P, SubproblemData * S,
+                              int **SharedRow)
+{
+    Node *Na, *Nb;
+    int *Entries, *Row, MinId = INT_MAX, i, k;
+    size_t Size = 1;
+
+    for (i = 0; i < S->Dimension; i++)
+        if (S->Tour[i]->Id < MinId)
+            MinId = S->Tour[i]->Id;
+    for (i = 0; i < S->Dimension; i++)
+        Size += S->Tour[i]->Id - MinId;
+    assert(Entries = (int *) malloc(Size * sizeof(int)));
+    for (i = 0, Row = Entries; i < S->Dimension; i++) {
+        Na = S->Tour[i];
+        SharedRow[i] = Na->C;
+        Na->C = Row - MinId;
+        Row += Na->Id - MinId;
+    }
+    for (i = 0; i < S->Dimension; i++) {
+        Na = S->Tour[i];
+        for (k = 0; k < S->Dimension; k++)
+            if ((Nb = S->Tour[k])->Id < Na->Id)
+                Na->C[Nb->Id] = SharedRow[i][Nb->Id];
+    }
+    for (i = 0; i < S->Dimension; i++) {
+        Na = S->Tour[i];
+        Nb = S->Tour[(i + 1) % S->Dimension];
+        if (IsPartner(P, Na, Nb) &&
+            Cold(Na)->FixedTo1Saved != Nb && Cold(Na)->FixedTo2Saved != Nb) {
+            if (Na->Id > Nb->Id)
+                Na->C[Nb->Id] = 0;
+            else
+                Nb->C[Na->Id] = 0;
+        }
+    }
+    return Entries;
+}
+
+/*
+ * The FixedEdgesUnchanged function returns 1 if the tour segments outside
+ * a subproblem connect the same pairs of its nodes as when the subproblem
+ * was extracted; otherwise 0.
+ */
+
+static int FixedEdgesUnchanged(SubproblemPool * P, SubproblemData * S,
+                               int CurrentSubproblem)
+{
+    Node *N = S->Tour[0], *Last = N;
+    int Gap = 0, FixedEdges = 0;
+
+    do {
+        N = Cold(N)->SubproblemSuc;
+        if (N->Subproblem != CurrentSubproblem)
+            Gap = 1;
+        else {
+            if (Gap) {
+                if (!IsPartner(P, Last, N))
+                    return 0;
+                FixedEdges++;
+            }
+            Last = N;
+            Gap = 0;
+        }
+    }
+    while (N != S->Tour[0]);
+    return FixedEdges == S->FixedEdges;
+}
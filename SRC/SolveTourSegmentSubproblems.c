@@ -19,7 +19,8 @@
 void SolveTourSegmentSubproblems()
 {
     Node *FirstNodeSaved, *N;
-    int CurrentSubproblem, Subproblems, Round, i;
+    int CurrentSubproblem, Subproblems, Round, i,
+        InParallel = SubproblemsInParallel();
     GainType GlobalBestCost, OldGlobalBestCost;
     double EntryTime = GetTime();
 
@@ -32,11 +33,11 @@ void SolveTourSegmentSubproblems()
     GlobalBestCost = 0;
     N = FirstNodeSaved = FirstNode;
     do {
-        if (!Fixed(N, N->SubproblemSuc))
-            GlobalBestCost += Distance(N, N->SubproblemSuc);
+        if (!Fixed(N, Cold(N)->SubproblemSuc))
+            GlobalBestCost += Distance(N, Cold(N)->SubproblemSuc);
         N->Subproblem = 0;
     }
-    while ((N = N->SubproblemSuc) != FirstNode);
+    while ((N = Cold(N)->SubproblemSuc) != FirstNode);
     for (Round = 1; Round <= 2; Round++) {
         if (Round == 2 && Subproblems == 1)
             break;
@@ -51,28 +52,36 @@ void SolveTourSegmentSubproblems()
         FirstNode = FirstNodeSaved;
         if (Round == 2)
             for (i = SubproblemSize / 2; i > 0; i--)
-                FirstNode = FirstNode->SubproblemSuc;
+                FirstNode = Cold(FirstNode)->SubproblemSuc;
         for (CurrentSubproblem = 1;
              CurrentSubproblem <= Subproblems; CurrentSubproblem++) {
             for (i = 0, N = FirstNode;
                  i < SubproblemSize ||
                  (FirstNode->Id <= DimensionSaved) != (N->Id <= DimensionSaved);
-                 i++, N = N->SubproblemSuc) {
+                 i++, N = Cold(N)->SubproblemSuc) {
                 N->Subproblem =
                     (Round - 1) * Subproblems + CurrentSubproblem;
-                N->FixedTo1Saved = N->FixedTo2Saved = 0;
-                N->SubBestPred = N->SubBestSuc = 0;
+                Cold(N)->FixedTo1Saved = Cold(N)->FixedTo2Saved = 0;
+                Cold(N)->SubBestPred = Cold(N)->SubBestSuc = 0;
+            }
+            if (!InParallel) {
+                OldGlobalBestCost = GlobalBestCost;
+                SolveSubproblem((Round - 1) * Subproblems +
+                                CurrentSubproblem, Subproblems,
+                                &GlobalBestCost);
+                if (SubproblemsCompressed
+                    && GlobalBestCost == OldGlobalBestCost)
+                    SolveCompressedSubproblem((Round - 1) * Subproblems +
+                                              CurrentSubproblem,
+                                              Subproblems,
+                                              &GlobalBestCost);
             }
-            OldGlobalBestCost = GlobalBestCost;
-            SolveSubproblem((Round - 1) * Subproblems + CurrentSubproblem,
-                            Subproblems, &GlobalBestCost);
-            if (SubproblemsCompressed
-                && GlobalBestCost == OldGlobalBestCost)
-                SolveCompressedSubproblem((Round - 1) * Subproblems +
-                                          CurrentSubproblem, Subproblems,
-                                          &GlobalBestCost);
             FirstNode = N;
         }
+        if (InParallel)
+            SolveSubproblemsInParallel((Round - 1) * Subproblems + 1,
+                                       Round * Subproblems, Subproblems,
+                                       &GlobalBestCost);
     }
     printff("\nCost = " GainFormat, GlobalBestCost);
     if (Optimum != MINUS_INFINITY && Optimum != 0)
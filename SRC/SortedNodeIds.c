@@ -0,0 +1,41 @@
+#include "LKH.h"
+
+/*
+ * The SortedNodeIds function returns the Ids of the nodes in the list
+ * starting at FirstNode, in increasing order. The number of Ids is
+ * stored in *Count.
+ *
+ * The function is used for visiting the entries of the cost matrix
+ * between the nodes of the current problem or subproblem: for a node Na,
+ * these are the entries Na->C[Id] where Id is one of the returned Ids
+ * less than Na->Id. Entries between a node of a subproblem and a node
+ * outside it are left alone, so that the subproblems of a round may be
+ * solved concurrently (see SolveSubproblemsInParallel).
+ *
+ * The returned array must be freed by the caller.
+ */
+
+static int compare(const void *Id1, const void *Id2);
+
+int *SortedNodeIds(int *Count)
+{
+    Node *N = FirstNode;
+    int *Id, n = 0;
+
+    do
+        n++;
+    while ((N = N->Suc) != FirstNode);
+    assert(Id = (int *) malloc(n * sizeof(int)));
+    n = 0;
+    do
+        Id[n++] = N->Id;
+    while ((N = N->Suc) != FirstNode);
+    qsort(Id, n, sizeof(int), compare);
+    *Count = n;
+    return Id;
+}
+
+static int compare(const void *Id1, const void *Id2)
+{
+    return *(const int *) Id1 - *(const int *) Id2;
+}
@@ -0,0 +1,170 @@
+#include "LKH.h"
+
+/*
+ * The SpecializeFunctions function is called by AllocateSegments when the
+ * tour representation, CurrentTreeType, has been chosen for the current
+ * problem or subproblem. The function pointers C, D, c, Distance, BestMove
+ * and BestSubsequentMove must have been given their values (by
+ * ReadProblem).
+ *
+ * If the linked list or the three-level tree representation is used, the
+ * functions referenced by BestMove, BestSubsequentMove, Gain23Function and
+ * LinKernighanFunction are the variants for that representation (see
+ * TreeVariant.h).
+ *
+ * If the costs are computed by the cost matrix, or by one of the distance
+ * functions of the types EUC_2D, CEIL_2D, ATT or GEO, the move functions
+ * referenced by BestMove and BestSubsequentMove for the two-level tree or
+ * the linked list are replaced by variants in which the cost functions
+ * are called statically (and inlined, except for GEO), see Specialize.h.
+ * The same holds for the functions referenced by Gain23Function and, for
+ * the linked list, LinKernighanFunction. Otherwise, the general functions
+ * are used.
+ *
+ * The function referenced by MinimumSpanningTreeFunction does not depend
+ * on the tour representation. It is the variant for the edge weight type,
+ * if there is one.
+ */
+
+#define DeclareVariants(T)\
+    Node *Best2OptMove_##T(Node * t1, Node * t2, GainType * G0,\
+                           GainType * Gain);\
+    Node *Best3OptMove_##T(Node * t1, Node * t2, GainType * G0,\
+                           GainType * Gain);\
+    Node *Best4OptMove_##T(Node * t1, Node * t2, GainType * G0,\
+                           GainType * Gain);\
+    Node *Best5OptMove_##T(Node * t1, Node * t2, GainType * G0,\
+                           GainType * Gain);\
+    Node *BestKOptMove_##T(Node * t1, Node * t2, GainType * G0,\
+                           GainType * Gain);\
+    GainType Gain23_##T(void)
+
+DeclareVariants(EXPLICIT);
+DeclareVariants(EUC_2D);
+DeclareVariants(CEIL_2D);
+DeclareVariants(ATT);
+DeclareVariants(GEO);
+DeclareVariants(ONE_LEVEL);
+DeclareVariants(THREE_LEVEL);
+DeclareVariants(ONE_LEVEL_EXPLICIT);
+DeclareVariants(ONE_LEVEL_EUC_2D);
+DeclareVariants(ONE_LEVEL_CEIL_2D);
+DeclareVariants(ONE_LEVEL_ATT);
+DeclareVariants(ONE_LEVEL_GEO);
+
+void MinimumSpanningTree_EXPLICIT(int Sparse);
+void MinimumSpanningTree_EUC_2D(int Sparse);
+void MinimumSpanningTree_CEIL_2D(int Sparse);
+void MinimumSpanningTree_ATT(int Sparse);
+void MinimumSpanningTree_GEO(int Sparse);
+GainType LinKernighan_ONE_LEVEL(void);
+GainType LinKernighan_THREE_LEVEL(void);
+GainType LinKernighan_ONE_LEVEL_EXPLICIT(void);
+GainType LinKernighan_ONE_LEVEL_EUC_2D(void);
+GainType LinKernighan_ONE_LEVEL_CEIL_2D(void);
+GainType LinKernighan_ONE_LEVEL_ATT(void);
+GainType LinKernighan_ONE_LEVEL_GEO(void);
+
+typedef struct Variants {
+    MoveFunction Move[6];       /* Best2OptMove, ..., Best5OptMove, indexed
+                                   by the move type */
+    MoveFunction BestKOptMove;
+    GainFunction Gain23;
+    TreeFunction MinimumSpanningTree;
+    GainFunction LinKernighan;
+} Variants;
+
+/* Variants for an edge weight type (two-level tree) */
+#define VariantsOf(T)\
+    { { 0, 0, Best2OptMove_##T, Best3OptMove_##T, Best4OptMove_##T,\
+        Best5OptMove_##T }, BestKOptMove_##T, Gain23_##T,\
+      MinimumSpanningTree_##T, LinKernighan }
+
+/* Variants for a tour representation (general cost functions) */
+#define TreeVariantsOf(T)\
+    { { 0, 0, Best2OptMove_##T, Best3OptMove_##T, Best4OptMove_##T,\
+        Best5OptMove_##T }, BestKOptMove_##T, Gain23_##T,\
+      MinimumSpanningTree, LinKernighan_##T }
+
+/* Variants for an edge weight type (linked list) */
+#define OneLevelVariantsOf(T)\
+    { { 0, 0, Best2OptMove_ONE_LEVEL_##T, Best3OptMove_ONE_LEVEL_##T,\
+        Best4OptMove_ONE_LEVEL_##T, Best5OptMove_ONE_LEVEL_##T },\
+      BestKOptMove_ONE_LEVEL_##T, Gain23_ONE_LEVEL_##T,\
+      MinimumSpanningTree_##T, LinKernighan_ONE_LEVEL_##T }
+
+static Variants
+    GeneralVariants = { { 0, 0, Best2OptMove, Best3OptMove, Best4OptMove,
+                          Best5OptMove }, BestKOptMove, Gain23,
+                        MinimumSpanningTree, LinKernighan },
+    EXPLICITVariants = VariantsOf(EXPLICIT),
+    EUC_2DVariants = VariantsOf(EUC_2D),
+    CEIL_2DVariants = VariantsOf(CEIL_2D),
+    ATTVariants = VariantsOf(ATT), GEOVariants = VariantsOf(GEO),
+    ONE_LEVELVariants = TreeVariantsOf(ONE_LEVEL),
+    THREE_LEVELVariants = TreeVariantsOf(THREE_LEVEL),
+    ONE_LEVEL_EXPLICITVariants = OneLevelVariantsOf(EXPLICIT),
+    ONE_LEVEL_EUC_2DVariants = OneLevelVariantsOf(EUC_2D),
+    ONE_LEVEL_CEIL_2DVariants = OneLevelVariantsOf(CEIL_2D),
+    ONE_LEVEL_ATTVariants = OneLevelVariantsOf(ATT),
+    ONE_LEVEL_GEOVariants = OneLevelVariantsOf(GEO);
+
+static MoveFunction Specialize(MoveFunction Move, Variants * V);
+
+void SpecializeFunctions()
+{
+    Variants *V, *W = &GeneralVariants, *O = &ONE_LEVELVariants;
+
+    if (C == C_EXPLICIT && D == D_EXPLICIT && c == 0) {
+        W = &EXPLICITVariants;
+        O = &ONE_LEVEL_EXPLICITVariants;
+    } else if (C == C_FUNCTION && D == D_FUNCTION) {
+        if (Distance == Distance_EUC_2D && c == c_EUC_2D) {
+            W = &EUC_2DVariants;
+            O = &ONE_LEVEL_EUC_2DVariants;
+        } else if (Distance == Distance_CEIL_2D && c == c_CEIL_2D) {
+            W = &CEIL_2DVariants;
+            O = &ONE_LEVEL_CEIL_2DVariants;
+        } else if (Distance == Distance_ATT && c == c_ATT) {
+            W = &ATTVariants;
+            O = &ONE_LEVEL_ATTVariants;
+        } else if (Distance == Distance_GEO && c == c_GEO) {
+            W = &GEOVariants;
+            O = &ONE_LEVEL_GEOVariants;
+        }
+    }
+    V = CurrentTreeType == ONE_LEVEL ? O :
+        CurrentTreeType == THREE_LEVEL ? &THREE_LEVELVariants : W;
+    BestMove = Specialize(BestMove, V);
+    BestSubsequentMove = Specialize(BestSubsequentMove, V);
+    Gain23Function = V->Gain23;
+    LinKernighanFunction = V->LinKernighan;
+    MinimumSpanningTreeFunction = W->MinimumSpanningTree;
+}
+
+/*
+ * The Specialize function returns the function of V that corresponds to
+ * Move. Move may be a general move function or any of its variants (the
+ * function may be called more than once, e.g., for each subproblem).
+ */
+
+static MoveFunction Specialize(MoveFunction Move, Variants * V)
+{
+    Variants *All[] = { &GeneralVariants, &EXPLICITVariants,
+        &EUC_2DVariants, &CEIL_2DVariants, &ATTVariants, &GEOVariants,
+        &ONE_LEVELVariants, &THREE_LEVELVariants,
+        &ONE_LEVEL_EXPLICITVariants, &ONE_LEVEL_EUC_2DVariants,
+        &ONE_LEVEL_CEIL_2DVariants, &ONE_LEVEL_ATTVariants,
+        &ONE_LEVEL_GEOVariants
+    };
+    int i, j;
+
+    for (j = 0; j < sizeof(All) / sizeof(All[0]); j++) {
+        for (i = 2; i <= 5; i++)
+            if (Move == All[j]->Move[i])
+                return V->Move[i];
+        if (Move == All[j]->BestKOptMove)
+            return V->BestKOptMove;
+    }
+    return Move;
+}
@@ -0,0 +1,8 @@
+/*
+ * Statically dispatched variants of the move functions, Gain23, BridgeGain
+ * and MinimumSpanningTree for the edge weight type ATT
+ * (see Specialize.h).
+ */
+
+#define SPECIALIZE_ATT
+#include "Specialize.h"
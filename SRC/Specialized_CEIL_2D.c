@@ -0,0 +1,8 @@
+/*
+ * Statically dispatched variants of the move functions, Gain23, BridgeGain
+ * and MinimumSpanningTree for the edge weight type CEIL_2D
+ * (see Specialize.h).
+ */
+
+#define SPECIALIZE_CEIL_2D
+#include "Specialize.h"
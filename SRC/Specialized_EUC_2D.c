@@ -0,0 +1,8 @@
+/*
+ * Statically dispatched variants of the move functions, Gain23, BridgeGain
+ * and MinimumSpanningTree for the edge weight type EUC_2D
+ * (see Specialize.h).
+ */
+
+#define SPECIALIZE_EUC_2D
+#include "Specialize.h"
@@ -0,0 +1,8 @@
+/*
+ * Statically dispatched variants of the move functions, Gain23, BridgeGain
+ * and MinimumSpanningTree for the edge weight type EXPLICIT
+ * (see Specialize.h).
+ */
+
+#define SPECIALIZE_EXPLICIT
+#include "Specialize.h"
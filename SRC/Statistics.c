@@ -1,8 +1,8 @@
 #include "LKH.h"
 
-static int TrialsMin, TrialsMax, TrialSum, Successes;
-static GainType CostMin, CostMax, CostSum;
-static double TimeMin, TimeMax, TimeSum;
+static THREAD_LOCAL int TrialsMin, TrialsMax, TrialSum, Successes;
+static THREAD_LOCAL GainType CostMin, CostMax, CostSum;
+static THREAD_LOCAL double TimeMin, TimeMax, TimeSum;
 
 void InitializeStatistics()
 {
@@ -70,4 +70,40 @@ void PrintStatistics()
     printff
         ("Time.min = %0.2f sec., Time.avg = %0.2f sec., Time.max = %0.2f sec.\n",
          fabs(_TimeMin), fabs(TimeSum) / _Runs, fabs(TimeMax));
+    if (TraceLevel >= 1 && Cache) {
+        printff("Cache: Size = %d, Sets = %d, Ways = %d",
+                (CacheMask + 1) * CacheWays, CacheMask + 1, CacheWays);
+        if (DistanceCacheSize > 0)
+            printff(", DISTANCE_CACHE_SIZE = %d", DistanceCacheSize);
+        printff("\n");
+        printff("Cache: Hits = " GainFormat ", Misses = " GainFormat
+                ", Evictions = " GainFormat ", Hit rate = %0.2f%%\n",
+                CacheHits, CacheMisses, CacheEvictions,
+                CacheHits + CacheMisses > 0 ?
+                100.0 * CacheHits / (CacheHits + CacheMisses) : 0.0);
+    }
+}
+
+/*
+ * The TakeCacheCounts function moves the distance cache statistics of the
+ * calling thread (CacheHits, CacheMisses and CacheEvictions) into Counts.
+ * It is called by a worker thread before it terminates. The thread that
+ * joins the worker adds the counts to its own statistics by calling
+ * AddCacheCounts, so that the statistics reported by PrintStatistics
+ * include those of all threads.
+ */
+
+void TakeCacheCounts(CacheCounts * Counts)
+{
+    Counts->Hits = CacheHits;
+    Counts->Misses = CacheMisses;
+    Counts->Evictions = CacheEvictions;
+    CacheHits = CacheMisses = CacheEvictions = 0;
+}
+
+void AddCacheCounts(CacheCounts * Counts)
+{
+    CacheHits += Counts->Hits;
+    CacheMisses += Counts->Misses;
+    CacheEvictions += Counts->Evictions;
 }
@@ -35,7 +35,7 @@ void StoreTour()
             t->OldSuc = t->Suc;
             t->OldPredExcluded = t->OldSucExcluded = 0;
             t->Cost = INT_MAX;
-            for (Nt = t->CandidateSet; (u = Nt->To); Nt++)
+            for (Nt = t->CandidateSet; (u = CandidateNode(Nt)); Nt++)
                 if (u != t->Pred && u != t->Suc && Nt->Cost < t->Cost)
                     t->Cost = Nt->Cost;
         }
@@ -0,0 +1,30 @@
+#include "LKH.h"
+#include <unistd.h>
+
+/*
+ * The TemporaryFileName function returns the name of a file to which the
+ * contents of the file FileName may be written before the file is given
+ * its final name by rename. The name is unique to the calling process, so
+ * that a reader of FileName never sees a partially written file, even if
+ * several processes write the file at the same time.
+ *
+ * A suffix that makes OpenFile compress the file (".gz" or ".zst") is kept
+ * at the end of the name, so that the file is written in the same format.
+ *
+ * The returned string must be freed by the caller.
+ */
+
+char *TemporaryFileName(const char *FileName)
+{
+    char *Name;
+    const char *Suffix = strrchr(FileName, '.');
+    int Length;
+
+    if (!Suffix || (strcmp(Suffix, ".gz") && strcmp(Suffix, ".zst")))
+        Suffix = FileName + strlen(FileName);
+    Length = (int) (Suffix - FileName);
+    assert(Name = (char *) malloc(strlen(FileName) + 32));
+    sprintf(Name, "%.*s.%ld.tmp%s", Length, FileName, (long) getpid(),
+            Suffix);
+    return Name;
+}
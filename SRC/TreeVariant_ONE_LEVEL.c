@@ -0,0 +1,8 @@
+/*
+ * Variants of LinKernighan, the move functions and the functions they
+ * call for the linked list representation of the tour
+ * (see TreeVariant.h).
+ */
+
+#define ONE_LEVEL_TREE
+#include "TreeVariant.h"
@@ -0,0 +1,9 @@
+/*
+ * Variants of LinKernighan, the move functions and the functions they
+ * call for the linked list representation of the tour and the edge
+ * weight type ATT (see Specialize.h and TreeVariant.h).
+ */
+
+#define SPECIALIZE_ATT
+#define ONE_LEVEL_TREE
+#include "Specialize.h"
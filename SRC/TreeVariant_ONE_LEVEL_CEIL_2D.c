@@ -0,0 +1,9 @@
+/*
+ * Variants of LinKernighan, the move functions and the functions they
+ * call for the linked list representation of the tour and the edge
+ * weight type CEIL_2D (see Specialize.h and TreeVariant.h).
+ */
+
+#define SPECIALIZE_CEIL_2D
+#define ONE_LEVEL_TREE
+#include "Specialize.h"
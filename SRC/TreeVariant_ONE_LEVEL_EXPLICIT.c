@@ -0,0 +1,9 @@
+/*
+ * Variants of LinKernighan, the move functions and the functions they
+ * call for the linked list representation of the tour and the edge
+ * weight type EXPLICIT (see Specialize.h and TreeVariant.h).
+ */
+
+#define SPECIALIZE_EXPLICIT
+#define ONE_LEVEL_TREE
+#include "Specialize.h"
@@ -0,0 +1,8 @@
+/*
+ * Variants of LinKernighan, the move functions and the functions they
+ * call for the three-level tree representation of the tour
+ * (see TreeVariant.h).
+ */
+
+#define THREE_LEVEL_TREE
+#include "TreeVariant.h"
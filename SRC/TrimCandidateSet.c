@@ -17,11 +17,12 @@ void TrimCandidateSet(int MaxCandidates)
         for (NFrom = From->CandidateSet; NFrom && NFrom->To; NFrom++)
             Count++;
         if (Count > MaxCandidates) {
-            assert(From->CandidateSet =
-                   (Candidate *) realloc(From->CandidateSet,
-                                         (MaxCandidates +
-                                          1) * sizeof(Candidate)));
+            UnindexCandidates(From);
+            From->CandidateSet =
+                ResizeCandidateSet(From->CandidateSet, MaxCandidates,
+                                   MaxCandidates + 1);
             From->CandidateSet[MaxCandidates].To = 0;
+            IndexCandidates(From);
         }
     } while ((From = From->Suc) != FirstNode);
 }
@@ -0,0 +1,191 @@
+#include "LKH.h"
+
+/*
+ * The WriteBinaryProblem function writes the problem that has just been
+ * read by ReadProblem to file BinaryProblemFileName, in a binary form
+ * that ReadProblem can load without parsing.
+ *
+ * The file starts with the specification part of the problem (NAME,
+ * TYPE, DIMENSION, EDGE_WEIGHT_TYPE, EDGE_WEIGHT_FORMAT and
+ * NODE_COORD_TYPE) in TSPLIB format, followed by a line containing the
+ * keyword BINARY_SECTION. The rest of the line is a header of
+ * BINARY_HEADER_FIELDS little-endian 64-bit integers (see the enumeration
+ * BinaryHeaderFields in LKH.h):
+ *
+ *   BINARY_MAGIC                    the 8 characters of BinaryMagic
+ *   BINARY_DIMENSION                the value of DIMENSION
+ *   BINARY_COORDINATES              the number of coordinates of each
+ *                                   node (0, 2 or 3)
+ *   BINARY_COORDINATE_OFFSET        the file offset of the coordinates
+ *   BINARY_WEIGHTS                  the number of explicit weights (or 0)
+ *   BINARY_WEIGHT_OFFSET            the file offset of the weights
+ *   BINARY_MAX_WEIGHT               the largest weight
+ *   BINARY_MAX_OFF_DIAGONAL_WEIGHT  the largest weight not on the diagonal
+ *   BINARY_FIXED_EDGES              the number of fixed edges
+ *   BINARY_FIXED_EDGE_OFFSET        the file offset of the fixed edges
+ *   BINARY_END                      the file offset of the line following
+ *                                   the binary data (EOF)
+ *
+ * The coordinates are doubles, given node by node in the order of the
+ * node numbers. The weights are ints, laid out exactly as in CostMatrix
+ * (see Read_EDGE_WEIGHT_SECTION): the lower triangle without the diagonal,
+ * row by row, for a symmetric problem, and the full matrix, row by row,
+ * for an asymmetric problem. The fixed edges are pairs of ints (node
+ * numbers as in FIXED_EDGES_SECTION). All offsets are multiples of 8, so
+ * that the data may be used directly from a memory mapping of the file.
+ *
+ * Problems given by an EDGE_DATA_SECTION cannot be written. A TOUR_SECTION
+ * of the problem file is not written.
+ *
+ * The function is called from ReadProblem, right after the sections of
+ * the problem file have been read.
+ */
+
+static void Align(FILE * File, long long *Offset);
+static int FixedEdge(Node * Na, Node * Nb, int n);
+static int LittleEndian(void);
+
+void WriteBinaryProblem()
+{
+    FILE *File;
+    char *TempName;
+    long long Header[BINARY_HEADER_FIELDS], Weights = 0, w, Offset;
+    int n, i, Coordinates, Edge[2];
+    double X[3];
+    Node *N, *Nj;
+
+    if (BinaryProblemFileName == 0)
+        return;
+    if (!LittleEndian())
+        eprintf("BINARY_PROBLEM_FILE: only supported on little-endian "
+                "machines");
+    if (Distance == Distance_1)
+        eprintf("BINARY_PROBLEM_FILE: EDGE_DATA_SECTION is not supported");
+    if (!FirstNode)
+        eprintf("BINARY_PROBLEM_FILE: no data sections in PROBLEM_FILE");
+    n = ProblemType == ATSP ? Dimension / 2 :
+        ProblemType == HPP ? Dimension - 1 : Dimension;
+    Coordinates = CoordType == TWOD_COORDS ? 2 :
+        CoordType == THREED_COORDS ? 3 : 0;
+    if (CostMatrix)
+        Weights = ProblemType == ATSP ? (long long) n * n :
+            (long long) Dimension * (Dimension - 1) / 2;
+    TempName = TemporaryFileName(BinaryProblemFileName);
+    if (!(File = fopen(TempName, "wb")))
+        eprintf("Cannot open BINARY_PROBLEM_FILE: \"%s\"", TempName);
+    if (TraceLevel >= 1)
+        printff("Writing BINARY_PROBLEM_FILE: \"%s\" ... ",
+                BinaryProblemFileName);
+    fprintf(File, "NAME : %s\n", Name);
+    fprintf(File, "TYPE : %s\n", Type);
+    fprintf(File, "DIMENSION : %d\n", n);
+    if (EdgeWeightType)
+        fprintf(File, "EDGE_WEIGHT_TYPE : %s\n", EdgeWeightType);
+    if (EdgeWeightFormat)
+        fprintf(File, "EDGE_WEIGHT_FORMAT : %s\n", EdgeWeightFormat);
+    if (NodeCoordType)
+        fprintf(File, "NODE_COORD_TYPE : %s\n", NodeCoordType);
+    fprintf(File, "BINARY_SECTION\n");
+
+    /* Lay out the sections */
+    memset(Header, 0, sizeof(Header));
+    memcpy(&Header[BINARY_MAGIC], BinaryMagic, sizeof(long long));
+    Header[BINARY_DIMENSION] = n;
+    Header[BINARY_COORDINATES] = Coordinates;
+    Header[BINARY_WEIGHTS] = Weights;
+    Header[BINARY_MAX_WEIGHT] = Header[BINARY_MAX_OFF_DIAGONAL_WEIGHT] =
+        INT_MIN;
+    for (w = 0; w < Weights; w++) {
+        if (CostMatrix[w] > Header[BINARY_MAX_WEIGHT])
+            Header[BINARY_MAX_WEIGHT] = CostMatrix[w];
+        if ((ProblemType != ATSP || w / n != w % n) &&
+            CostMatrix[w] > Header[BINARY_MAX_OFF_DIAGONAL_WEIGHT])
+            Header[BINARY_MAX_OFF_DIAGONAL_WEIGHT] = CostMatrix[w];
+    }
+    N = FirstNode;
+    do {
+        for (i = 1; i <= 2; i++) {
+            Nj = i == 1 ? N->FixedTo1 : N->FixedTo2;
+            if (FixedEdge(N, Nj, n))
+                Header[BINARY_FIXED_EDGES]++;
+        }
+    } while ((N = N->Suc) != FirstNode);
+    Offset = ftell(File) + sizeof(Header);
+    Offset = (Offset + 7) & ~7LL;
+    Header[BINARY_COORDINATE_OFFSET] = Offset;
+    Offset += (long long) Coordinates * n * sizeof(double);
+    Header[BINARY_WEIGHT_OFFSET] = Offset = (Offset + 7) & ~7LL;
+    Offset += Weights * sizeof(int);
+    Header[BINARY_FIXED_EDGE_OFFSET] = Offset = (Offset + 7) & ~7LL;
+    Offset += Header[BINARY_FIXED_EDGES] * sizeof(Edge);
+    Header[BINARY_END] = Offset;
+    Offset = ftell(File);
+    fwrite(Header, sizeof(Header), 1, File);
+    Offset += sizeof(Header);
+
+    /* Write the sections */
+    Align(File, &Offset);
+    for (i = 1; i <= n && Coordinates > 0; i++) {
+        N = &NodeSet[InternalId(i)];
+        X[0] = N->X;
+        X[1] = N->Y;
+        X[2] = N->Z;
+        fwrite(X, sizeof(double), Coordinates, File);
+        Offset += Coordinates * sizeof(double);
+    }
+    Align(File, &Offset);
+    fwrite(CostMatrix, sizeof(int), Weights, File);
+    Offset += Weights * sizeof(int);
+    Align(File, &Offset);
+    N = FirstNode;
+    do {
+        for (i = 1; i <= 2; i++) {
+            Nj = i == 1 ? N->FixedTo1 : N->FixedTo2;
+            if (FixedEdge(N, Nj, n)) {
+                Edge[0] = ExternalId(N->Id);
+                Edge[1] = ProblemType == ATSP ? Nj->Id - n :
+                    ExternalId(Nj->Id);
+                fwrite(Edge, sizeof(Edge), 1, File);
+            }
+        }
+    } while ((N = N->Suc) != FirstNode);
+    fprintf(File, "\nEOF\n");
+    if (ferror(File) | fclose(File))
+        eprintf("Cannot write BINARY_PROBLEM_FILE: \"%s\"", TempName);
+    if (rename(TempName, BinaryProblemFileName))
+        eprintf("Cannot rename \"%s\" to \"%s\"", TempName,
+                BinaryProblemFileName);
+    free(TempName);
+    if (TraceLevel >= 1)
+        printff("done\n");
+}
+
+/* The Align function pads the file with zero bytes to the next multiple
+   of 8 */
+
+static void Align(FILE * File, long long *Offset)
+{
+    for (; *Offset % 8 != 0; (*Offset)++)
+        fputc(0, File);
+}
+
+/* The FixedEdge function returns 1 if the fixing of node Na to node Nb
+   represents a fixed edge to be written from the side of Na; otherwise 0.
+   A symmetric fixed edge is written once. The edges that tie the two
+   nodes of each city of an asymmetric problem together (see
+   Read_EDGE_WEIGHT_SECTION) are not written */
+
+static int FixedEdge(Node * Na, Node * Nb, int n)
+{
+    if (!Nb)
+        return 0;
+    return ProblemType == ATSP ? Na->Id <= n && Nb->Id != Na->Id + n :
+        Na->Id < Nb->Id;
+}
+
+static int LittleEndian()
+{
+    int One = 1;
+
+    return *(char *) &One == 1;
+}
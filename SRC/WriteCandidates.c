@@ -12,36 +12,143 @@
  * candidate edges. For each candidate edge its end node number and 
  * alpha-value are given.
  *
+ * If the file name ends in ".bin", the file is written in binary form
+ * instead (see BinaryFileName). The file then consists of a header of
+ * CANDIDATE_HEADER_FIELDS little-endian 64-bit integers (see the
+ * enumeration CandidateHeaderFields in LKH.h):
+ *
+ *   CANDIDATE_MAGIC      the 8 characters of CandidateMagic
+ *   CANDIDATE_DIMENSION  the number of nodes
+ *   CANDIDATE_EDGES      the total number of candidate edges
+ *
+ * followed by three arrays of ints: the dads of the nodes (0, if the node
+ * has no dad), the numbers of candidate edges of the nodes, both in the
+ * order of the node numbers, and, node by node, the candidate edges as
+ * pairs of end node number and alpha-value. The node numbers are as in
+ * the text form. ReadCandidates recognizes the binary form by its header
+ * and reads it from a memory mapping of the file.
+ *
+ * The file is written under a temporary name and then renamed, so that
+ * a partially written file is never read (see TemporaryFileName).
+ *
  * The function is called from the CreateCandidateSet function. 
  */
 
+static int CandidateCount(Node * N);
+static void WriteText(FILE * CandidateFile);
+static void WriteBinary(FILE * CandidateFile);
+
 void WriteCandidates()
 {
     FILE *CandidateFile;
-    int i, Count;
-    Candidate *NN;
-    Node *N;
+    char *TempName;
 
-    if (CandidateFiles == 0 ||
-        !(CandidateFile = fopen(CandidateFileName[0], "w")))
+    if (CandidateFiles == 0)
+        return;
+    TempName = TemporaryFileName(CandidateFileName[0]);
+    if (!(CandidateFile = OpenFile(TempName, "w"))) {
+        free(TempName);
         return;
+    }
     if (TraceLevel >= 1)
         printff("Writing CANDIDATE_FILE: \"%s\" ... ",
                 CandidateFileName[0]);
+    if (BinaryFileName(CandidateFileName[0]))
+        WriteBinary(CandidateFile);
+    else
+        WriteText(CandidateFile);
+    if (CloseFile(CandidateFile)) {
+        remove(TempName);
+        eprintf("Cannot write candidate file: \"%s\"", TempName);
+    }
+    if (rename(TempName, CandidateFileName[0]))
+        remove(TempName);
+    free(TempName);
+    if (TraceLevel >= 1)
+        printff("done\n");
+}
+
+/* The WriteText function writes the file in text form. Each line is
+   formatted in a buffer by FormatInt */
+
+static void WriteText(FILE * CandidateFile)
+{
+    int i, Count, MaxCount = 0;
+    char *Line, *p;
+    Candidate *NN;
+    Node *N;
+
+    for (i = 1; i <= Dimension; i++)
+        if ((Count = CandidateCount(&NodeSet[i])) > MaxCount)
+            MaxCount = Count;
+    assert(Line = (char *) malloc(12 * (3 + 2 * (size_t) MaxCount) + 1));
     fprintf(CandidateFile, "%d\n", Dimension);
     for (i = 1; i <= Dimension; i++) {
-        N = &NodeSet[i];
-        fprintf(CandidateFile, "%d %d", N->Id, N->Dad ? N->Dad->Id : 0);
-        Count = 0;
-        for (NN = N->CandidateSet; NN && NN->To; NN++)
-            Count++;
-        fprintf(CandidateFile, " %d ", Count);
-        for (NN = N->CandidateSet; NN && NN->To; NN++)
-            fprintf(CandidateFile, "%d %d ", NN->To->Id, NN->Alpha);
-        fprintf(CandidateFile, "\n");
+        N = &NodeSet[InternalId(i)];
+        p = FormatInt(Line, ExternalId(N->Id));
+        *p++ = ' ';
+        p = FormatInt(p, N->Dad ? ExternalId(N->Dad->Id) : 0);
+        *p++ = ' ';
+        p = FormatInt(p, CandidateCount(N));
+        *p++ = ' ';
+        for (NN = N->CandidateSet; NN && NN->To; NN++) {
+            p = FormatInt(p, ExternalId(NN->To));
+            *p++ = ' ';
+            p = FormatInt(p, NN->Alpha);
+            *p++ = ' ';
+        }
+        *p++ = '\n';
+        fwrite(Line, 1, p - Line, CandidateFile);
     }
+    free(Line);
     fprintf(CandidateFile, "-1\nEOF\n");
-    fclose(CandidateFile);
-    if (TraceLevel >= 1)
-        printff("done\n");
+}
+
+static void WriteBinary(FILE * CandidateFile)
+{
+    long long Header[CANDIDATE_HEADER_FIELDS];
+    int i, j, Count, MaxCount = 0, *Value, *Edge;
+    Candidate *NN;
+    Node *N;
+
+    memset(Header, 0, sizeof(Header));
+    memcpy(&Header[CANDIDATE_MAGIC], CandidateMagic, sizeof(long long));
+    Header[CANDIDATE_DIMENSION] = Dimension;
+    for (i = 1; i <= Dimension; i++) {
+        Header[CANDIDATE_EDGES] += Count = CandidateCount(&NodeSet[i]);
+        if (Count > MaxCount)
+            MaxCount = Count;
+    }
+    fwrite(Header, sizeof(Header), 1, CandidateFile);
+    assert(Value = (int *) malloc(Dimension * sizeof(int)));
+    for (i = 1; i <= Dimension; i++) {
+        N = &NodeSet[InternalId(i)];
+        Value[i - 1] = N->Dad ? ExternalId(N->Dad->Id) : 0;
+    }
+    fwrite(Value, sizeof(int), Dimension, CandidateFile);
+    for (i = 1; i <= Dimension; i++)
+        Value[i - 1] = CandidateCount(&NodeSet[InternalId(i)]);
+    fwrite(Value, sizeof(int), Dimension, CandidateFile);
+    free(Value);
+    assert(Edge =
+           (int *) malloc((2 * (size_t) MaxCount + 1) * sizeof(int)));
+    for (i = 1; i <= Dimension; i++) {
+        N = &NodeSet[InternalId(i)];
+        for (NN = N->CandidateSet, j = 0; NN && NN->To; NN++) {
+            Edge[j++] = ExternalId(NN->To);
+            Edge[j++] = NN->Alpha;
+        }
+        fwrite(Edge, sizeof(int), j, CandidateFile);
+    }
+    free(Edge);
+}
+
+static int CandidateCount(Node * N)
+{
+    Candidate *NN;
+    int Count = 0;
+
+    for (NN = N->CandidateSet; NN && NN->To; NN++)
+        Count++;
+    return Count;
 }
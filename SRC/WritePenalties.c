@@ -11,24 +11,73 @@
  * where the first integer is a node number, and the second integer 
  * is the Pi-value associated with the node.
  *
+ * If the file name ends in ".bin", the file is written in binary form
+ * instead (see BinaryFileName): a header of PENALTY_HEADER_FIELDS
+ * little-endian 64-bit integers (PENALTY_MAGIC, the 8 characters of
+ * PenaltyMagic, and PENALTY_DIMENSION, the number of nodes), followed by
+ * the pairs of node number and Pi-value as ints, in the same order as in
+ * the text form. ReadPenalties recognizes the binary form by its header.
+ *
+ * The file is written under a temporary name and then renamed, so that
+ * a partially written file is never read (see TemporaryFileName).
+ *
  * The function is called from the CreateCandidateSet function. 
  */
 
 void WritePenalties()
 {
     Node *N;
+    char *TempName, *Buffer, *p;
+    long long Header[PENALTY_HEADER_FIELDS];
+    int *Pair, i, Binary;
 
-    if (PiFileName == 0 || !(PiFile = fopen(PiFileName, "w")))
+    if (PiFileName == 0)
+        return;
+    TempName = TemporaryFileName(PiFileName);
+    if (!(PiFile = OpenFile(TempName, "w"))) {
+        free(TempName);
         return;
+    }
     if (TraceLevel >= 1)
         printff("Writing PI_FILE: \"%s\" ... ", PiFileName);
-    fprintf(PiFile, "%d\n", Dimension);
+    if ((Binary = BinaryFileName(PiFileName))) {
+        memcpy(&Header[PENALTY_MAGIC], PenaltyMagic, sizeof(long long));
+        Header[PENALTY_DIMENSION] = Dimension;
+        fwrite(Header, sizeof(Header), 1, PiFile);
+    } else
+        fprintf(PiFile, "%d\n", Dimension);
+    /* At most 2 * 12 characters or 2 ints for each node */
+    assert(Buffer = (char *) malloc(24 * (size_t) Dimension));
+    Pair = (int *) Buffer;
+    p = Buffer;
+    i = 0;
     N = FirstNode;
-    do
-        fprintf(PiFile, "%d %d\n", N->Id, N->Pi);
+    do {
+        if (Binary) {
+            Pair[i++] = ExternalId(N->Id);
+            Pair[i++] = N->Pi;
+        } else {
+            p = FormatInt(p, ExternalId(N->Id));
+            *p++ = ' ';
+            p = FormatInt(p, N->Pi);
+            *p++ = '\n';
+        }
+    }
     while ((N = N->Suc) != FirstNode);
-    fprintf(PiFile, "-1\nEOF\n");
-    fclose(PiFile);
+    if (Binary)
+        fwrite(Pair, sizeof(int), i, PiFile);
+    else {
+        fwrite(Buffer, 1, p - Buffer, PiFile);
+        fprintf(PiFile, "-1\nEOF\n");
+    }
+    free(Buffer);
+    if (CloseFile(PiFile)) {
+        remove(TempName);
+        eprintf("Cannot write pi file: \"%s\"", TempName);
+    }
+    if (rename(TempName, PiFileName))
+        remove(TempName);
+    free(TempName);
     if (TraceLevel >= 1)
         printff("done\n", PiFileName);
 }
@@ -1,4 +1,7 @@
 #include "LKH.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <unistd.h>
 
 /*
  * The WriteTour function writes a tour to file. The tour 
@@ -6,54 +9,273 @@
  * 
  * The tour is written in "normal form": starting at node 1,
  * and continuing in direction of its lowest numbered
- * neighbor.
+ * neighbor. The nodes are numbered as in the problem file (see
+ * RenumberNodes).
  * 
  * Nothing happens if FileName is 0. 
+ * 
+ * The calling thread only takes a snapshot of the tour (its node numbers
+ * in normal form). The file is written by a background thread, so that
+ * the search is not held up by the output. If a tour for the same file is
+ * still waiting to be written, it is replaced by the new one; rapid
+ * successive improvements therefore cost at most one write. The tour is
+ * written to a temporary file, which is then renamed to the full file
+ * name, so a reader of the file never sees a partially written tour.
+ * Tours that are still waiting when the program exits are written before
+ * the exit (see FlushTours).
+ *
+ * Since the file is written later, the trace output says that the tour
+ * has been queued. An error of the writer thread (e.g., a full disk) does
+ * not stop the thread; the error is recorded and reported (and the
+ * program is terminated) by the next call of WriteTour, or at the exit
+ * by FlushTours.
  */
 
+typedef struct TourJob {
+    char *FileName;             /* The full name of the file */
+    char *Name;                 /* The name of the problem */
+    int *Id;                    /* The node numbers of the tour, in order */
+    int n;                      /* The number of nodes */
+    GainType Cost;
+    time_t Time;
+    struct TourJob *Next;
+} TourJob;
+
+static TourJob *FirstJob, *LastJob;
+static int Writing;             /* Specifies whether a job is being written */
+static int WriterStarted;
+static pthread_t Writer;
+static pthread_mutex_t JobLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t JobReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t JobsDone = PTHREAD_COND_INITIALIZER;
+static char *WriteError;        /* The first error of the writer thread */
+
 static char *FullName(char *Name, GainType Cost);
+static void SubmitJob(TourJob * Job);
+static void *WriteJobs(void *Arg);
+static void WriteJob(TourJob * Job);
+static void RecordError(const char *Format, ...);
+static char *TakeError(void);
+static void FreeJob(TourJob * Job);
+static void FlushTours(void);
 
 void WriteTour(char *FileName, int *Tour, GainType Cost)
 {
-    FILE *TourFile;
     int i, j, n, Forwards;
-    char *FullFileName;
-    time_t Now;
+    TourJob *Job;
+    char *Error;
 
     if (FileName == 0)
         return;
-    FullFileName = FullName(FileName, Cost);
-    Now = time(&Now);
+    if ((Error = TakeError()))
+        eprintf("%s", Error);
+    assert(Job = (TourJob *) malloc(sizeof(TourJob)));
+    Job->FileName = FullName(FileName, Cost);
+    Job->Time = time(&Job->Time);
     if (TraceLevel >= 1)
         printff("Writing%s: \"%s\" ... ",
                 FileName == TourFileName ? " TOUR_FILE" :
                 FileName == OutputTourFileName ? " OUTPUT_TOUR_FILE" : "",
-                FullFileName);
-    assert(TourFile = fopen(FullFileName, "w"));
-    fprintf(TourFile, "NAME : %s." GainFormat ".tour\n", Name, Cost);
-    fprintf(TourFile, "COMMENT : Length = " GainFormat "\n", Cost);
-    fprintf(TourFile, "COMMENT : Found by LKH [Keld Helsgaun] %s", ctime(&Now));
-    fprintf(TourFile, "TYPE : TOUR\n");
-    n = ProblemType != ATSP ? Dimension : Dimension / 2;
-    fprintf(TourFile, "DIMENSION : %d\n", n);
-    fprintf(TourFile, "TOUR_SECTION\n");
+                Job->FileName);
+    assert(Job->Name = (char *) malloc(strlen(Name) + 1));
+    strcpy(Job->Name, Name);
+    Job->Cost = Cost;
+    Job->n = n = ProblemType != ATSP ? Dimension : Dimension / 2;
+    assert(Job->Id = (int *) malloc(n * sizeof(int)));
 
-    for (i = 1; i < n && Tour[i] != 1; i++);
+    for (i = 1; i < n && ExternalId(Tour[i]) != 1; i++);
     Forwards = ProblemType == ATSP ||
-        Tour[i < n ? i + 1 : 1] < Tour[i > 1 ? i - 1 : Dimension];
-    for (j = 1; j <= n; j++) {
-        fprintf(TourFile, "%d\n", Tour[i]);
+        ExternalId(Tour[i < n ? i + 1 : 1]) <
+        ExternalId(Tour[i > 1 ? i - 1 : Dimension]);
+    for (j = 0; j < n; j++) {
+        Job->Id[j] = ExternalId(Tour[i]);
         if (Forwards) {
             if (++i > n)
                 i = 1;
         } else if (--i < 1)
             i = n;
     }
-    fprintf(TourFile, "-1\nEOF\n");
-    fclose(TourFile);
+    SubmitJob(Job);
     if (TraceLevel >= 1)
-        printff("done\n");
-    free(FullFileName);
+        printff("queued\n");
+}
+
+/*
+ * The SubmitJob function hands a job over to the writer thread, which is
+ * started on the first call. A job that waits for the same file is
+ * replaced by the new job.
+ */
+
+static void SubmitJob(TourJob * Job)
+{
+    TourJob *J;
+
+    Job->Next = 0;
+    pthread_mutex_lock(&JobLock);
+    if (!WriterStarted) {
+        if (pthread_create(&Writer, 0, WriteJobs, 0))
+            eprintf("Cannot create tour writer thread");
+        WriterStarted = 1;
+        atexit(FlushTours);
+    }
+    for (J = FirstJob; J && strcmp(J->FileName, Job->FileName);
+         J = J->Next);
+    if (J) {
+        Job->Next = J->Next;
+        free(J->FileName);
+        free(J->Name);
+        free(J->Id);
+        *J = *Job;
+        free(Job);
+        if (!J->Next)
+            LastJob = J;
+    } else {
+        if (LastJob)
+            LastJob->Next = Job;
+        else
+            FirstJob = Job;
+        LastJob = Job;
+        pthread_cond_signal(&JobReady);
+    }
+    pthread_mutex_unlock(&JobLock);
+}
+
+/* The WriteJobs function is the body of the writer thread */
+
+static void *WriteJobs(void *Arg)
+{
+    TourJob *Job;
+
+    pthread_mutex_lock(&JobLock);
+    for (;;) {
+        while (!FirstJob)
+            pthread_cond_wait(&JobReady, &JobLock);
+        Job = FirstJob;
+        if (!(FirstJob = Job->Next))
+            LastJob = 0;
+        Writing = 1;
+        pthread_mutex_unlock(&JobLock);
+        WriteJob(Job);
+        FreeJob(Job);
+        pthread_mutex_lock(&JobLock);
+        Writing = 0;
+        if (!FirstJob)
+            pthread_cond_broadcast(&JobsDone);
+    }
+    return Arg;
+}
+
+/* The WriteJob function writes the tour of a job to its temporary file and
+   renames the file to its full name. An error is recorded by RecordError,
+   and the temporary file is then removed */
+
+static void WriteJob(TourJob * Job)
+{
+    FILE *TourFile;
+    char *TempName, *Buffer, *p, Time[32];
+    int j;
+
+    TempName = TemporaryFileName(Job->FileName);
+    if (!(TourFile = OpenFile(TempName, "w"))) {
+        RecordError("Cannot open tour file: \"%s\"", TempName);
+        free(TempName);
+        return;
+    }
+    fprintf(TourFile, "NAME : %s." GainFormat ".tour\n", Job->Name,
+            Job->Cost);
+    fprintf(TourFile, "COMMENT : Length = " GainFormat "\n", Job->Cost);
+    fprintf(TourFile, "COMMENT : Found by LKH [Keld Helsgaun] %s",
+            ctime_r(&Job->Time, Time));
+    fprintf(TourFile, "TYPE : TOUR\n");
+    fprintf(TourFile, "DIMENSION : %d\n", Job->n);
+    fprintf(TourFile, "TOUR_SECTION\n");
+    /* At most 11 characters and a newline for each node */
+    assert(Buffer = (char *) malloc((size_t) Job->n * 12 + 1));
+    for (j = 0, p = Buffer; j < Job->n; j++) {
+        p = FormatInt(p, Job->Id[j]);
+        *p++ = '\n';
+    }
+    fwrite(Buffer, 1, p - Buffer, TourFile);
+    free(Buffer);
+    fprintf(TourFile, "-1\nEOF\n");
+    if (ferror(TourFile) | CloseFile(TourFile)) {
+        RecordError("Cannot write tour file: \"%s\"", TempName);
+        remove(TempName);
+    } else if (rename(TempName, Job->FileName)) {
+        RecordError("Cannot rename \"%s\" to \"%s\"", TempName,
+                    Job->FileName);
+        remove(TempName);
+    }
+    free(TempName);
+}
+
+/* The RecordError function records an error message of the writer thread.
+   Only the first error is kept */
+
+static void RecordError(const char *Format, ...)
+{
+    va_list Args;
+    char *Message;
+    int Length;
+
+    va_start(Args, Format);
+    Length = vsnprintf(0, 0, Format, Args);
+    va_end(Args);
+    assert(Message = (char *) malloc(Length + 1));
+    va_start(Args, Format);
+    vsnprintf(Message, Length + 1, Format, Args);
+    va_end(Args);
+    pthread_mutex_lock(&JobLock);
+    if (!WriteError) {
+        WriteError = Message;
+        Message = 0;
+    }
+    pthread_mutex_unlock(&JobLock);
+    free(Message);
+}
+
+/* The TakeError function returns the recorded error message (or 0) and
+   clears it */
+
+static char *TakeError()
+{
+    char *Error;
+
+    pthread_mutex_lock(&JobLock);
+    Error = WriteError;
+    WriteError = 0;
+    pthread_mutex_unlock(&JobLock);
+    return Error;
+}
+
+static void FreeJob(TourJob * Job)
+{
+    free(Job->FileName);
+    free(Job->Name);
+    free(Job->Id);
+    free(Job);
+}
+
+/*
+ * The FlushTours function waits until all submitted tours have been
+ * written. It is called at program exit. If a tour could not be written,
+ * the error is reported, and the program terminates with EXIT_FAILURE
+ * (by _exit, since exit may not be called during the exit).
+ */
+
+static void FlushTours()
+{
+    char *Error;
+
+    pthread_mutex_lock(&JobLock);
+    while (FirstJob || Writing)
+        pthread_cond_wait(&JobsDone, &JobLock);
+    pthread_mutex_unlock(&JobLock);
+    if ((Error = TakeError())) {
+        fflush(stdout);
+        fprintf(stderr, "\n*** Error ***\n%s\n", Error);
+        _exit(EXIT_FAILURE);
+    }
 }
 
 /*
@@ -7,7 +7,9 @@
  * a pointer. It returns 0 if end of file or an error occurs; otherwise 
  * it returns 1.
  *
- * It is faster than fscanf.
+ * It is faster than fscanf. The stream is read without locking (by
+ * getc_unlocked), so it must not be used by other threads at the same
+ * time.
  */
 
 int fscanint(FILE * f, int *v)
@@ -15,11 +17,11 @@ int fscanint(FILE * f, int *v)
     int val;
     int c, sign = 1;
 
-    while (isspace(c = getc(f)));
+    while (isspace(c = getc_unlocked(f)));
     if (c == '-' || c == '+') {
         if (c == '-')
             sign = -1;
-        if ((c = getc(f)) == EOF) {
+        if ((c = getc_unlocked(f)) == EOF) {
             ungetc(c, f);
             return 0;
         }
@@ -29,7 +31,7 @@ int fscanint(FILE * f, int *v)
         return 0;
     }
     val = c - '0';
-    while (isdigit(c = getc(f)))
+    while (isdigit(c = getc_unlocked(f)))
         val = 10 * val + (c - '0');
     *v = sign * val;
     return 1;